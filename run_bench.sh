@@ -0,0 +1,9 @@
+#!/bin/bash
+# writes one google benchmark json per //src/bench target into the given directory (default: bench_results)
+OUT=${1:-bench_results}
+mkdir -p "$OUT"
+bazel build -c opt //src/bench/... || exit 1
+for target in $(bazel query 'kind(cc_binary, //src/bench/...)'); do
+  name=${target##*:}
+  bazel-bin/src/bench/$name --benchmark_out="$OUT/$name.json" --benchmark_out_format=json || exit 1
+done
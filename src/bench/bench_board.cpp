@@ -0,0 +1,30 @@
+#include <benchmark/benchmark.h>
+
+#include "src/bench/corpus.hpp"
+#include "src/framework/move_gen.hpp"
+
+using namespace dwc;
+
+static void BM_Move(benchmark::State& state) {
+  Board b{bench::CORPUS[state.range(0)]};
+  MovesT moves;
+  for (const Move& m : iter::LegalMoves{b}) moves.push_back(m);
+  for (auto _ : state) {
+    // validated move, then back to the same position
+    for (const Move& m : moves) {
+      b.move(m);
+      b.undo_move();
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * moves.size());
+}
+BENCHMARK(BM_Move)->DenseRange(0, bench::CORPUS.size() - 1);
+
+static void BM_BoardCopy(benchmark::State& state) {
+  Board b{bench::CORPUS[state.range(0)]};
+  for (auto _ : state) {
+    Board copy = b;
+    benchmark::DoNotOptimize(copy);
+  }
+}
+BENCHMARK(BM_BoardCopy)->DenseRange(0, bench::CORPUS.size() - 1);
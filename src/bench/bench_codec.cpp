@@ -0,0 +1,134 @@
+#include <benchmark/benchmark.h>
+
+#include <filesystem>
+#include <vector>
+
+#include "src/bench/corpus.hpp"
+#include "src/codec/game.hpp"
+#include "src/codec/store.hpp"
+#include "src/engine/search.hpp"
+#include "src/engine/thread_pool.hpp"
+#include "src/framework/fen_lib.hpp"
+
+namespace {
+std::vector<dwc::State> corpus_states() {
+  std::vector<dwc::State> res;
+  for (const auto& b : bench::corpus_boards()) res.push_back(b.get_state());
+  return res;
+}
+
+// fixed game, never change it, otherwise results can't be compared between commits
+std::vector<dwc::Move> game_moves() {
+  std::vector<dwc::Move> res;
+  for (auto [fr, to] : {std::pair{"e2", "e4"}, {"e7", "e5"}, {"g1", "f3"}, {"b8", "c6"}, {"f1", "b5"}, {"a7", "a6"},
+                        {"b5", "a4"}, {"g8", "f6"}, {"e1", "g1"}, {"f8", "e7"}, {"f1", "e1"}, {"b7", "b5"},
+                        {"a4", "b3"}, {"d7", "d6"}, {"c2", "c3"}, {"e8", "g8"}, {"h2", "h3"}, {"c6", "b8"}}) {
+    res.push_back({dwc::Pos{fr}, dwc::Pos{to}});
+  }
+  return res;
+}
+}  // namespace
+
+static void BM_PackState(benchmark::State& state) {
+  auto states = corpus_states();
+  dwc::codec::PackedStateT packed;
+  for (auto _ : state) {
+    for (const auto& s : states) {
+      dwc::codec::pack(s, packed.data());
+      benchmark::DoNotOptimize(packed);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * states.size());
+  state.counters["bytes"] = dwc::codec::STATE_SIZE;
+}
+BENCHMARK(BM_PackState);
+
+static void BM_UnpackState(benchmark::State& state) {
+  std::vector<dwc::codec::PackedStateT> packed;
+  for (const auto& s : corpus_states()) packed.push_back(dwc::codec::pack(s));
+  for (auto _ : state) {
+    for (const auto& p : packed) benchmark::DoNotOptimize(dwc::codec::unpack(p.data()));
+  }
+  state.SetItemsProcessed(state.iterations() * packed.size());
+}
+BENCHMARK(BM_UnpackState);
+
+static void BM_WriteFen(benchmark::State& state) {
+  auto states = corpus_states();
+  size_t bytes = 0;
+  for (const auto& s : states) bytes += dwc::fen::to_fen(s).size();
+  for (auto _ : state) {
+    for (const auto& s : states) benchmark::DoNotOptimize(dwc::fen::to_fen(s));
+  }
+  state.SetItemsProcessed(state.iterations() * states.size());
+  state.counters["bytes"] = static_cast<double>(bytes) / states.size();
+}
+BENCHMARK(BM_WriteFen);
+
+static void BM_ParseFen(benchmark::State& state) {
+  for (auto _ : state) {
+    for (std::string_view fen : bench::CORPUS) {
+      dwc::fen::FenParser fp{fen};
+      benchmark::DoNotOptimize(fp);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * bench::CORPUS.size());
+}
+BENCHMARK(BM_ParseFen);
+
+static void BM_EncodeGame(benchmark::State& state) {
+  dwc::State start = dwc::Board{bench::CORPUS[0]}.get_state();
+  auto moves = game_moves();
+  std::vector<uint8_t> buf;
+  for (auto _ : state) {
+    buf.clear();
+    dwc::codec::encode_game(start, moves, buf);
+    benchmark::DoNotOptimize(buf.data());
+  }
+  state.SetItemsProcessed(state.iterations() * moves.size());
+  state.counters["bytes"] = buf.size();
+}
+BENCHMARK(BM_EncodeGame);
+
+static void BM_DecodeGame(benchmark::State& state) {
+  std::vector<uint8_t> buf;
+  auto moves = game_moves();
+  dwc::codec::encode_game(dwc::Board{bench::CORPUS[0]}.get_state(), moves, buf);
+  for (auto _ : state) benchmark::DoNotOptimize(dwc::codec::decode_game(buf.data(), buf.size()));
+  state.SetItemsProcessed(state.iterations() * moves.size());
+}
+BENCHMARK(BM_DecodeGame);
+
+// the training data batch job: legal moves and eval of every stored position, one shard per worker
+static void BM_StoreScan(benchmark::State& state) {
+  std::string path = (std::filesystem::temp_directory_path() / "dwc_bench_store.dwps").string();
+  std::filesystem::remove(path);
+  {
+    dwc::codec::PositionAppender app{path};
+    for (size_t i = 0; i < 1000; ++i) {
+      for (const auto& s : corpus_states()) app.append(s);
+    }
+  }
+  dwc::codec::PositionStore store{path};
+
+  struct Scratch {
+    dwc::MovesT moves;
+    int64_t sum{0};
+  };
+  dwc::engine::ThreadPool<Scratch> pool{static_cast<size_t>(state.range(0))};
+  for (auto _ : state) {
+    store.for_each(pool, [](dwc::codec::PositionView view, size_t, Scratch& s) {
+      dwc::Board board{view.state()};
+      for (dwc::Pos pos : dwc::iter::squares_of(board.get_mailbox().occupancy(*board.get_state().turn))) {
+        s.moves.clear();
+        board.get_pseudo_moves(pos, s.moves);
+        s.sum += s.moves.size();
+      }
+      s.sum += dwc::engine::evaluate(board);
+    });
+  }
+  for (size_t w = 0; w < pool.size(); ++w) benchmark::DoNotOptimize(pool.scratch(w).sum);
+  state.SetItemsProcessed(state.iterations() * store.size());
+  std::filesystem::remove(path);
+}
+BENCHMARK(BM_StoreScan)->Arg(1)->Arg(4)->UseRealTime();
@@ -0,0 +1,22 @@
+#include <benchmark/benchmark.h>
+
+#include "src/bench/corpus.hpp"
+#include "src/framework/fen_lib.hpp"
+
+static void BM_FenParser(benchmark::State& state) {
+  std::string_view fen = bench::CORPUS[state.range(0)];
+  for (auto _ : state) {
+    dwc::fen::FenParser fp{fen};
+    benchmark::DoNotOptimize(fp);
+  }
+}
+BENCHMARK(BM_FenParser)->DenseRange(0, bench::CORPUS.size() - 1);
+
+static void BM_BoardFromFen(benchmark::State& state) {
+  std::string_view fen = bench::CORPUS[state.range(0)];
+  for (auto _ : state) {
+    dwc::Board b{fen};
+    benchmark::DoNotOptimize(b);
+  }
+}
+BENCHMARK(BM_BoardFromFen)->DenseRange(0, bench::CORPUS.size() - 1);
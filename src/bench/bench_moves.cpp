@@ -0,0 +1,57 @@
+#include <benchmark/benchmark.h>
+
+#include "src/bench/corpus.hpp"
+#include "src/framework/square_iter.hpp"
+
+using namespace dwc;
+
+namespace {
+constexpr std::array<const char*, cast_t(Type::SIZE)> TYPE_NAMES{"pawn", "knight", "bishop", "rook", "queen", "king"};
+
+// every (board, square) of the corpus holding a piece of the given type
+std::vector<std::pair<size_t, Pos>> squares_with(const std::vector<Board>& boards, Type type) {
+  std::vector<std::pair<size_t, Pos>> res;
+  for (size_t i = 0; i < boards.size(); ++i) {
+    for (Pos pos : iter::ALL_SQUARES) {
+      auto piece = boards[i].get(pos);
+      if (piece.has_value() && piece->type == type) res.emplace_back(i, pos);
+    }
+  }
+  return res;
+}
+}  // namespace
+
+static void BM_GetMoves(benchmark::State& state) {
+  auto type = static_cast<Type>(state.range(0));
+  auto boards = bench::corpus_boards();
+  auto squares = squares_with(boards, type);
+  state.SetLabel(TYPE_NAMES[cast_t(type)]);
+  for (auto _ : state) {
+    for (const auto& [i, pos] : squares) benchmark::DoNotOptimize(boards[i].get_moves(pos));
+  }
+  state.SetItemsProcessed(state.iterations() * squares.size());
+}
+BENCHMARK(BM_GetMoves)->DenseRange(0, cast_t(Type::SIZE) - 1);
+
+static void BM_IsThreatened(benchmark::State& state) {
+  auto boards = bench::corpus_boards();
+  for (auto _ : state) {
+    for (const auto& b : boards) {
+      for (Pos pos : iter::ALL_SQUARES) benchmark::DoNotOptimize(b.is_threatened(pos, Side::WHITE));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * boards.size() * 64);
+}
+BENCHMARK(BM_IsThreatened);
+
+static void BM_IsKingThreatened(benchmark::State& state) {
+  auto boards = bench::corpus_boards();
+  for (auto _ : state) {
+    for (const auto& b : boards) {
+      benchmark::DoNotOptimize(b.is_king_threatened(Side::WHITE));
+      benchmark::DoNotOptimize(b.is_king_threatened(Side::BLACK));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * boards.size() * 2);
+}
+BENCHMARK(BM_IsKingThreatened);
@@ -0,0 +1,84 @@
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <string>
+
+#include "src/framework/move_gen.hpp"
+#include "src/pgn/reader.hpp"
+
+namespace {
+// fixed games, never change them, otherwise results can't be compared between commits
+constexpr std::string_view GAMES = R"([Event "Bench 1"]
+[Result "1-0"]
+
+1. e4 e5 2. Nf3 Nc6 3. Bb5 a6 4. Ba4 Nf6 5. O-O Be7 6. Re1 b5 7. Bb3 d6 8. c3 O-O 9. h3 Nb8 10. d4 Nbd7
+11. c4 c6 12. cxb5 axb5 13. Nc3 Bb7 14. Bg5 b4 15. Nb1 h6 16. Bh4 c5 17. dxe5 Nxe4 18. Bxe7 Qxe7 1-0
+
+[Event "Bench 2"]
+[Result "0-1"]
+
+1. d4 Nf6 2. c4 g6 3. Nc3 Bg7 4. e4 d6 5. Nf3 O-O 6. Be2 e5 7. O-O Nc6 8. d5 Ne7 9. Ne1 Nd7 10. Nd3 f5
+11. Bd2 Nf6 12. f3 f4 13. c5 g5 14. Rc1 Ng6 15. cxd6 cxd6 16. Nb5 Rf7 17. Qc2 Ne8 18. a4 h5 0-1
+
+)";
+
+std::string make_pgn(size_t copies) {
+  std::string res;
+  for (size_t i = 0; i < copies; ++i) res += GAMES;
+  return res;
+}
+}  // namespace
+
+static void BM_PgnScan(benchmark::State& state) {
+  std::string pgn = make_pgn(500);
+  size_t games = 0;
+  for (auto _ : state) {
+    dwc::pgn::GameReader reader{pgn};
+    while (reader.next()) ++games;
+  }
+  state.SetItemsProcessed(games);
+  state.SetBytesProcessed(state.iterations() * pgn.size());
+}
+BENCHMARK(BM_PgnScan);
+
+static void BM_PgnReplay(benchmark::State& state) {
+  std::string pgn = make_pgn(50);
+  size_t games = 0;
+  for (auto _ : state) {
+    dwc::pgn::GameReader reader{pgn};
+    for (const auto& game : reader) {
+      benchmark::DoNotOptimize(dwc::pgn::replay(game));
+      ++games;
+    }
+  }
+  state.SetItemsProcessed(games);
+}
+BENCHMARK(BM_PgnReplay);
+
+static void BM_PgnReplayParallel(benchmark::State& state) {
+  std::string pgn = make_pgn(400);
+  size_t games = 0;
+  for (auto _ : state) {
+    std::atomic<size_t> n{0};
+    dwc::pgn::for_each_game(pgn, state.range(0), [&n](const dwc::pgn::Game& game, size_t) {
+      benchmark::DoNotOptimize(dwc::pgn::replay(game));
+      ++n;
+    });
+    games += n;
+  }
+  state.SetItemsProcessed(games);
+}
+BENCHMARK(BM_PgnReplayParallel)->RangeMultiplier(2)->Range(1, 16)->UseRealTime();
+
+static void BM_WriteSan(benchmark::State& state) {
+  dwc::Board b{"r3k2r/pppq1ppp/2n2n2/3pp3/1b2P3/2NP1N2/PPP2PPP/R1BQK2R w KQkq"};
+  std::vector<dwc::Move> moves;
+  for (const auto& m : dwc::iter::LegalMoves{b}) moves.push_back(m);
+  bool with_suffix = state.range(0) != 0;
+  char buf[dwc::pgn::SAN_MAX];
+  for (auto _ : state) {
+    for (const auto& m : moves) benchmark::DoNotOptimize(dwc::pgn::write_san(b, m, buf, with_suffix));
+  }
+  state.SetItemsProcessed(state.iterations() * moves.size());
+}
+BENCHMARK(BM_WriteSan)->Arg(0)->Arg(1);
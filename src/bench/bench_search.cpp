@@ -0,0 +1,132 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+#include "src/bench/corpus.hpp"
+#include "src/engine/engine.hpp"
+
+using namespace dwc;
+
+namespace {
+// all features, each one switched off, none
+const std::array<std::pair<const char*, engine::SearchOptions>, 6> VARIANTS{{
+    {"all", {}},
+    {"no_null_move", {false, true, true, true}},
+    {"no_lmr", {true, false, true, true}},
+    {"no_futility", {true, true, false, true}},
+    {"no_check_ext", {true, true, true, false}},
+    {"none", {false, false, false, false}},
+}};
+
+struct CorpusResult {
+  uint64_t nodes{0};
+  engine::SearchStats stats;
+};
+
+// fixed depth search of every corpus position, each from a new game
+CorpusResult search_corpus(engine::Engine& e, const std::vector<Board>& boards, int depth) {
+  engine::Limits limits;
+  limits.depth = depth;
+  CorpusResult res;
+  for (const Board& b : boards) {
+    e.new_game();
+    e.set_position(b);
+    e.go(limits);
+    auto r = e.wait();
+    res.nodes += r.nodes;
+    res.stats += r.stats;
+  }
+  return res;
+}
+}  // namespace
+
+// nodes is the figure move ordering and pruning changes should bring down, ebf the effective branching factor
+// (nodes ^ (1 / depth), averaged over the corpus); the rest are the search statistics for tuning
+static void BM_SearchDepth(benchmark::State& state) {
+  int depth = static_cast<int>(state.range(0));
+  const auto& [name, options] = VARIANTS[state.range(1)];
+  auto boards = bench::corpus_boards();
+  engine::Engine e;
+  e.set_search_options(options);
+  CorpusResult res;
+  for (auto _ : state) res = search_corpus(e, boards, depth);
+
+  state.SetLabel(name);
+  state.counters["nodes"] = static_cast<double>(res.nodes);
+  state.counters["ebf"] = std::pow(static_cast<double>(res.nodes) / boards.size(), 1.0 / depth);
+  state.counters["asp_fails"] = res.stats.aspiration_fail_rate();
+  state.counters["first_cut"] = res.stats.first_move_cutoff_rate();
+  state.counters["lmr_re"] = static_cast<double>(res.stats.lmr_researches);
+  state.counters["pvs_re"] = static_cast<double>(res.stats.pvs_researches);
+}
+// the search runs on the engine's threads
+BENCHMARK(BM_SearchDepth)
+    ->ArgsProduct({{4, 5, 6}, benchmark::CreateDenseRange(0, VARIANTS.size() - 1, 1)})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+// time from the hard limit until the best move is reported, over the corpus; the iterations of a middlegame take far
+// longer than the limits here, so it is the node interval polling that stops the search
+static void BM_StopLatency(benchmark::State& state) {
+  std::chrono::milliseconds movetime{state.range(0)};
+  auto boards = bench::corpus_boards();
+  engine::Engine e;
+  engine::ClockT::time_point reported;
+  e.set_bestmove_callback([&reported](const engine::SearchResult&) { reported = engine::ClockT::now(); });
+  engine::Limits limits;
+  limits.movetime = movetime;
+
+  std::chrono::microseconds worst{0};
+  for (auto _ : state) {
+    for (const Board& b : boards) {
+      e.set_position(b);
+      auto start = engine::ClockT::now();
+      e.go(limits);
+      e.wait();
+      worst = std::max(worst, std::chrono::duration_cast<std::chrono::microseconds>(reported - start - movetime));
+    }
+  }
+  state.counters["worst_overshoot_us"] = static_cast<double>(worst.count());
+}
+BENCHMARK(BM_StopLatency)->Arg(20)->Arg(100)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// nodes of one MultiPV search with k lines against k searches of their own, each without the moves found before,
+// over the corpus
+static void BM_MultiPv(benchmark::State& state) {
+  size_t k = static_cast<size_t>(state.range(0));
+  auto boards = bench::corpus_boards();
+  engine::Engine e;
+  engine::Limits limits;
+  limits.depth = 6;
+  limits.multipv = k;
+
+  uint64_t nodes = 0;
+  for (auto _ : state) {
+    nodes = 0;
+    for (const Board& b : boards) {
+      e.new_game();
+      nodes += e.analyse(b, limits).nodes;
+    }
+  }
+
+  uint64_t separate_nodes = 0;
+  engine::Limits separate = limits;
+  separate.multipv = 1;
+  for (const Board& b : boards) {
+    MovesT moves;
+    engine::generate_moves(b, moves);
+    separate.searchmoves.assign(moves.begin(), moves.end());
+    for (size_t i = 0; i < k && !separate.searchmoves.empty(); ++i) {
+      e.new_game();
+      auto r = e.analyse(b, separate);
+      separate_nodes += r.nodes;
+      auto& search = separate.searchmoves;
+      search.erase(std::find(search.begin(), search.end(), *r.best));
+    }
+  }
+  state.counters["nodes"] = static_cast<double>(nodes);
+  state.counters["separate_nodes"] = static_cast<double>(separate_nodes);
+}
+BENCHMARK(BM_MultiPv)->Arg(1)->Arg(3)->Arg(5)->Unit(benchmark::kMillisecond)->UseRealTime();
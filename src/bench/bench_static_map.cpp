@@ -0,0 +1,44 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+
+#include "src/shared/static_map.hpp"
+
+namespace {
+// scrambled but reproducible keys, so the sorted map really has to sort
+template <size_t N>
+std::array<std::pair<uint32_t, uint32_t>, N> make_data() {
+  std::array<std::pair<uint32_t, uint32_t>, N> data{};
+  for (size_t i = 0; i < N; ++i) {
+    data[i] = {static_cast<uint32_t>((i * 2654435761u) % 1000003u), static_cast<uint32_t>(i)};
+  }
+  return data;
+}
+}  // namespace
+
+template <typename MAP, size_t N>
+static void BM_Lookup(benchmark::State& state) {
+  const auto data = make_data<N>();
+  MAP map{data};
+  size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(map[data[i].first]);
+    i = (i + 7) % N;
+  }
+}
+
+template <size_t N>
+using LinearT = dwc::utils::Map<uint32_t, uint32_t, N>;
+template <size_t N>
+using SortedT = dwc::utils::SortedMap<uint32_t, uint32_t, N>;
+
+BENCHMARK_TEMPLATE(BM_Lookup, LinearT<4>, 4);
+BENCHMARK_TEMPLATE(BM_Lookup, SortedT<4>, 4);
+BENCHMARK_TEMPLATE(BM_Lookup, LinearT<16>, 16);
+BENCHMARK_TEMPLATE(BM_Lookup, SortedT<16>, 16);
+BENCHMARK_TEMPLATE(BM_Lookup, LinearT<64>, 64);
+BENCHMARK_TEMPLATE(BM_Lookup, SortedT<64>, 64);
+BENCHMARK_TEMPLATE(BM_Lookup, LinearT<256>, 256);
+BENCHMARK_TEMPLATE(BM_Lookup, SortedT<256>, 256);
+BENCHMARK_TEMPLATE(BM_Lookup, LinearT<1024>, 1024);
+BENCHMARK_TEMPLATE(BM_Lookup, SortedT<1024>, 1024);
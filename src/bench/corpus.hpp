@@ -0,0 +1,23 @@
+#pragma once
+
+#include <array>
+#include <string_view>
+#include <vector>
+
+#include "src/framework/board.hpp"
+
+namespace bench {
+// fixed positions, never change them, otherwise results can't be compared between commits
+constexpr std::array<std::string_view, 6> CORPUS{
+    "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+    "r1bqkbnr/pppp1ppp/2n5/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R w KQkq - 2 3",
+    "r3k2r/pppq1ppp/2n2n2/3pp3/1b2P3/2NP1N2/PPP2PPP/R1BQK2R w KQkq - 4 8",
+    "2rq1rk1/pp2bppp/2n1pn2/3p4/3P4/2NBPN2/PP3PPP/R2Q1RK1 b - - 3 11",
+    "8/5pk1/6p1/3R4/5P2/6PK/r7/8 w - - 0 40",
+    "4k3/8/8/8/1b6/8/3N4/4K3 w - - 0 1",
+};
+
+inline std::vector<dwc::Board> corpus_boards() {
+  return {CORPUS.begin(), CORPUS.end()};
+}
+}  // namespace bench
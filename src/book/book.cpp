@@ -0,0 +1,85 @@
+#include "book.hpp"
+
+#include <algorithm>
+#include <numeric>
+
+namespace dwc::book {
+namespace {
+// polyglot writes castling as king takes own rook, translate to the move Board generates
+Move to_board_move(const Board& board, Move move) {
+  auto piece = board.get(move.fr);
+  auto target = board.get(move.to);
+  if (!piece.has_value() || piece->type != Type::KING || !target.has_value() || target->type != Type::ROOK ||
+      target->side != piece->side) {
+    return move;
+  }
+  const State& state = board.get_state();
+  for (Type type : {Type::KING, Type::QUEEN}) {
+    const CastleInfo& ci = state.castling_rules[{type, piece->side}];
+    if (ci.king_from == move.fr.index() && ci.rook_from == move.to.index()) {
+      return {move.fr, Pos::from_index(ci.move_to)};
+    }
+  }
+  return move;
+}
+}  // namespace
+
+Book::Book(const std::string& path, const polyglot::Random64T& random) : file_(path), random_(random) {
+  if (file_.size() % polyglot::ENTRY_SIZE != 0) throw std::runtime_error("not a polyglot book: " + path);
+  size_ = file_.size() / polyglot::ENTRY_SIZE;
+  file_.advise_random();
+}
+
+size_t Book::lower_bound(polyglot::KeyT key) const {
+  size_t lo = 0;
+  size_t hi = size_;
+  while (lo < hi) {
+    size_t mid = lo + (hi - lo) / 2;
+    if (entry(mid).key < key) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+std::vector<BookMove> Book::moves(const Board& board) const {
+  std::vector<BookMove> res;
+  polyglot::KeyT k = key(board);
+  for (size_t idx = lower_bound(k); idx < size_; ++idx) {
+    polyglot::Entry e = entry(idx);
+    if (e.key != k) break;
+    if (polyglot::is_promotion(e.move)) continue;  // no promotions on Board yet
+
+    Move move = to_board_move(board, polyglot::decode_move(e.move));
+    auto piece = board.get(move.fr);
+    if (!piece.has_value() || piece->side != board.get_state().turn.value_or(Side::WHITE)) continue;
+    if (!utils::contains(board.get_moves(move.fr), move)) continue;
+    res.push_back({move, e.weight});
+  }
+  std::stable_sort(res.begin(), res.end(), [](const BookMove& a, const BookMove& b) { return a.weight > b.weight; });
+  return res;
+}
+
+std::optional<Move> Book::pick_best(const Board& board) const {
+  std::vector<BookMove> candidates = moves(board);
+  if (candidates.empty() || candidates.front().weight == 0) return std::nullopt;
+  return candidates.front().move;
+}
+
+std::optional<Move> Book::pick_weighted(const Board& board, std::mt19937_64& rng) const {
+  std::vector<BookMove> candidates = moves(board);
+  uint64_t total = std::accumulate(candidates.begin(), candidates.end(), uint64_t{0},
+                                   [](uint64_t sum, const BookMove& m) { return sum + m.weight; });
+  if (total == 0) return std::nullopt;
+
+  uint64_t r = std::uniform_int_distribution<uint64_t>{0, total - 1}(rng);
+  for (const BookMove& m : candidates) {
+    if (r < m.weight) return m.move;
+    r -= m.weight;
+  }
+  return std::nullopt;
+}
+
+}  // namespace dwc::book
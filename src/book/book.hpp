@@ -0,0 +1,51 @@
+#pragma once
+
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "src/book/polyglot.hpp"
+#include "src/framework/board.hpp"
+#include "src/shared/mapped_file.hpp"
+
+namespace dwc::book {
+
+struct BookMove {
+  Move move;
+  uint16_t weight;
+  bool operator==(const BookMove& o) const { return move == o.move && weight == o.weight; }
+};
+
+// Polyglot book, memory mapped and binary searched in place. Nothing is read into the heap, so books of any size
+// open instantly and their pages are shared by all engine processes using the same file.
+class Book {
+  utils::MappedFile file_;
+  polyglot::Random64T random_;
+  size_t size_{0};
+
+  polyglot::Entry entry(size_t idx) const { return polyglot::decode(file_.data() + idx * polyglot::ENTRY_SIZE); }
+
+  // first entry not below key
+  size_t lower_bound(polyglot::KeyT key) const;
+
+ public:
+  // throws std::runtime_error if the file can't be mapped or isn't a whole number of entries
+  explicit Book(const std::string& path, const polyglot::Random64T& random = polyglot::DEFAULT_RANDOM64);
+
+  // number of entries
+  size_t size() const { return size_; }
+
+  polyglot::KeyT key(const Board& board) const { return polyglot::key(board.get_state(), random_); }
+
+  // book moves of the position that are legal on board, highest weight first
+  std::vector<BookMove> moves(const Board& board) const;
+
+  // highest weight, nullopt when out of book
+  std::optional<Move> pick_best(const Board& board) const;
+
+  // chosen with probability proportional to the weight, moves weighted 0 are never played
+  std::optional<Move> pick_weighted(const Board& board, std::mt19937_64& rng) const;
+};
+
+}  // namespace dwc::book
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <istream>
+#include <stdexcept>
+
+#include "src/book/polyglot_random64.hpp"
+#include "src/framework/basic_types.hpp"
+
+// Polyglot opening book format: 16 byte big endian entries (key, move, weight, learn) sorted by key.
+// The key is the xor of the Random64 values at
+//   64 * kind + 8 * rank + file  for every piece, kind being black pawn 0, white pawn 1, black knight 2, ...
+//   768 + right                  for the castling rights K Q k q
+//   772 + file                   for a capturable en passant square (never, State doesn't track it)
+//   780                          when white is to move
+// The published Random64 table is the default, so books written by other tools work as they are.
+
+namespace dwc::book::polyglot {
+
+using KeyT = uint64_t;
+
+constexpr size_t RANDOM_PIECE = 0;
+constexpr size_t RANDOM_CASTLE = 768;
+constexpr size_t RANDOM_EN_PASSANT = 772;
+constexpr size_t RANDOM_TURN = 780;
+constexpr size_t RANDOM_SIZE = 781;
+
+using Random64T = std::array<KeyT, RANDOM_SIZE>;
+
+static_assert(PUBLISHED_RANDOM64.size() == RANDOM_SIZE);
+
+// books written by any Polyglot compatible tool
+inline constexpr Random64T DEFAULT_RANDOM64 = PUBLISHED_RANDOM64;
+
+// only for books keyed by a table of their own: RANDOM_SIZE whitespace separated numbers, hex with or without 0x
+inline Random64T read_random64(std::istream& is) {
+  Random64T random{};
+  for (auto& r : random) {
+    if (!(is >> std::hex >> r)) throw std::runtime_error("polyglot random table ill formatted");
+  }
+  return random;
+}
+
+constexpr size_t piece_kind(Piece piece) {
+  return cast_t(piece.type) * 2 + (piece.side == Side::WHITE ? 1 : 0);
+}
+
+constexpr size_t piece_index(Piece piece, Pos pos) {
+  return RANDOM_PIECE + 64 * piece_kind(piece) + pos.index();
+}
+
+inline KeyT key(const State& state, const Random64T& random = DEFAULT_RANDOM64) {
+  KeyT key = 0;
+  for (size_t idx = 0; idx < 64; ++idx) {
+    Pos pos = Pos::from_index(idx);
+    auto piece = board_ut::get(pos, state.board);
+    if (piece.has_value()) key ^= random[piece_index(*piece, pos)];
+  }
+  for (const auto& right : state.castling) key ^= random[RANDOM_CASTLE + CastlingRules::index(right)];
+  if (state.turn.value_or(Side::WHITE) == Side::WHITE) key ^= random[RANDOM_TURN];
+  return key;
+}
+
+constexpr size_t ENTRY_SIZE = 16;
+
+struct Entry {
+  KeyT key;
+  uint16_t move;
+  uint16_t weight;
+  uint32_t learn;
+};
+
+namespace _inner {
+template <typename T>
+constexpr T read_be(const uint8_t* p) {
+  T v = 0;
+  for (size_t i = 0; i < sizeof(T); ++i) v = static_cast<T>((v << 8) | p[i]);
+  return v;
+}
+
+template <typename T>
+constexpr void write_be(T v, uint8_t* p) {
+  for (size_t i = sizeof(T); i > 0; --i) {
+    p[i - 1] = static_cast<uint8_t>(v & 0xff);
+    v = static_cast<T>(v >> 8);
+  }
+}
+}  // namespace _inner
+
+constexpr Entry decode(const uint8_t* p) {
+  return {_inner::read_be<KeyT>(p), _inner::read_be<uint16_t>(p + 8), _inner::read_be<uint16_t>(p + 10),
+          _inner::read_be<uint32_t>(p + 12)};
+}
+
+inline std::array<uint8_t, ENTRY_SIZE> encode(const Entry& entry) {
+  std::array<uint8_t, ENTRY_SIZE> bytes{};
+  _inner::write_be(entry.key, bytes.data());
+  _inner::write_be(entry.move, bytes.data() + 8);
+  _inner::write_be(entry.weight, bytes.data() + 10);
+  _inner::write_be(entry.learn, bytes.data() + 12);
+  return bytes;
+}
+
+// bits: to file 0-2, to rank 3-5, from file 6-8, from rank 9-11, promotion 12-14
+// castling is written as king takes own rook, whatever the variant
+constexpr uint16_t encode_move(Move move) {
+  return static_cast<uint16_t>(move.to.index() | move.fr.index() << 6);
+}
+
+constexpr Move decode_move(uint16_t move) {
+  auto pos = [](uint16_t bits) { return Pos::from_index(bits & 0x3f); };
+  return {pos(move >> 6), pos(move)};
+}
+
+constexpr bool is_promotion(uint16_t move) {
+  return (move >> 12 & 0x7) != 0;
+}
+
+}  // namespace dwc::book::polyglot
@@ -0,0 +1,169 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+#include "src/book/book.hpp"
+
+using namespace dwc;
+using namespace dwc::book;
+
+namespace {
+constexpr std::string_view START_FEN = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq";
+constexpr std::string_view CASTLE_FEN = "r3k2r/pppq1ppp/2n2n2/3pp3/1b2P3/2NP1N2/PPP2PPP/R1BQK2R w KQkq";
+
+Move mv(std::string_view fr, std::string_view to) {
+  return {Pos{fr}, Pos{to}};
+}
+
+// writes the entries sorted by key, like a real book
+std::string write_book(std::string_view name, std::vector<polyglot::Entry> entries) {
+  std::sort(entries.begin(), entries.end(), [](const auto& a, const auto& b) { return a.key < b.key; });
+  std::string path = (std::filesystem::temp_directory_path() / name).string();
+  std::ofstream ofs{path, std::ios::binary};
+  for (const auto& e : entries) {
+    auto bytes = polyglot::encode(e);
+    ofs.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+  }
+  return path;
+}
+
+polyglot::Entry entry(std::string_view fen, Move move, uint16_t weight) {
+  return {polyglot::key(Board{fen}.get_state()), polyglot::encode_move(move), weight, 0};
+}
+}  // namespace
+
+TEST(BOOK, KeyLayout) {
+  polyglot::Random64T random{};
+  Board b{"4k3/8/8/8/8/8/8/4K3 b"};
+  // white king on e1: kind 11, square 4
+  random[64 * 11 + 4] = 1;
+  random[polyglot::RANDOM_TURN] = 2;
+  random[polyglot::RANDOM_CASTLE + 1] = 4;  // white queen side
+  EXPECT_EQ(polyglot::key(b.get_state(), random), 1);
+
+  Board b2{"4k3/8/8/8/8/8/8/4K3 w"};
+  EXPECT_EQ(polyglot::key(b2.get_state(), random), 1 | 2);
+
+  Board b3{"r3k3/8/8/8/8/8/8/R3K3 w Q"};
+  EXPECT_EQ(polyglot::key(b3.get_state(), random), 1 | 2 | 4);
+
+  // same position reached by different move orders
+  Board b4{START_FEN};
+  for (Move m : {mv("g1", "f3"), mv("g8", "f6"), mv("b1", "c3")}) b4.move(m);
+  Board b5{START_FEN};
+  for (Move m : {mv("b1", "c3"), mv("g8", "f6"), mv("g1", "f3")}) b5.move(m);
+  EXPECT_EQ(polyglot::key(b4.get_state()), polyglot::key(b5.get_state()));
+  EXPECT_NE(polyglot::key(b4.get_state()), polyglot::key(Board{START_FEN}.get_state()));
+}
+
+TEST(BOOK, PublishedKeys) {
+  // reference keys of the format specification
+  Board b{START_FEN};
+  EXPECT_EQ(polyglot::key(b.get_state()), 0x463b96181691fc9cULL);
+  b.move(mv("e2", "e4"));
+  EXPECT_EQ(polyglot::key(b.get_state()), 0x823c9b50fd114196ULL);
+  b.move(mv("d7", "d5"));
+  EXPECT_EQ(polyglot::key(b.get_state()), 0x0756b94461c50fb0ULL);
+  b.move(mv("e4", "e5"));
+  EXPECT_EQ(polyglot::key(b.get_state()), 0x662fafb965db29d4ULL);
+
+  // after 1.a4 b5 2.h4 b4 3.c4 bxc3 4.Ra3
+  Board b2{"rnbqkbnr/p1pppppp/8/8/P6P/R1p5/1P1PPPP1/1NBQKBNR b Kkq - 0 4"};
+  EXPECT_EQ(polyglot::key(b2.get_state()), 0x5c3f9b829b279560ULL);
+}
+
+TEST(BOOK, Encoding) {
+  polyglot::Entry e{0x0123456789abcdefULL, polyglot::encode_move(mv("e2", "e4")), 300, 7};
+  auto bytes = polyglot::encode(e);
+  EXPECT_EQ(bytes[0], 0x01);
+  EXPECT_EQ(bytes[7], 0xef);
+  // e4 = 28, e2 = 12
+  EXPECT_EQ(e.move, 28 | 12 << 6);
+  auto d = polyglot::decode(bytes.data());
+  EXPECT_EQ(d.key, e.key);
+  EXPECT_EQ(d.weight, 300);
+  EXPECT_EQ(d.learn, 7);
+  EXPECT_EQ(polyglot::decode_move(d.move), mv("e2", "e4"));
+
+  std::ostringstream oss;
+  for (size_t i = 0; i < polyglot::RANDOM_SIZE; ++i) oss << "0x" << std::hex << i * 3 << (i % 4 == 3 ? ",\n" : " ");
+  std::istringstream iss{oss.str()};
+  EXPECT_THROW(polyglot::read_random64(iss), std::runtime_error);
+  std::string plain = oss.str();
+  std::replace(plain.begin(), plain.end(), ',', ' ');
+  std::istringstream iss2{plain};
+  auto random = polyglot::read_random64(iss2);
+  EXPECT_EQ(random[1], 3);
+  EXPECT_EQ(random[polyglot::RANDOM_TURN], 780 * 3);
+}
+
+TEST(BOOK, Probe) {
+  std::vector<polyglot::Entry> entries{
+      entry(START_FEN, mv("e2", "e4"), 10),
+      entry(START_FEN, mv("d2", "d4"), 30),
+      entry(START_FEN, mv("e2", "e5"), 100),  // illegal
+      entry(START_FEN, mv("a2", "a3"), 0),
+      entry(CASTLE_FEN, mv("e1", "h1"), 5),
+  };
+  std::string path = write_book("dwc_test_book_probe.bin", entries);
+  Book book{path};
+  EXPECT_EQ(book.size(), 5);
+
+  Board b{START_FEN};
+  EXPECT_EQ(book.key(b), polyglot::key(b.get_state()));
+  EXPECT_EQ(book.moves(b), (std::vector<BookMove>{{mv("d2", "d4"), 30}, {mv("e2", "e4"), 10}, {mv("a2", "a3"), 0}}));
+  EXPECT_EQ(book.pick_best(b), mv("d2", "d4"));
+
+  // polyglot castling is king takes rook
+  Board b2{CASTLE_FEN};
+  EXPECT_EQ(book.pick_best(b2), mv("e1", "g1"));
+
+  Board b3{START_FEN};
+  b3.move(mv("e2", "e4"));
+  EXPECT_TRUE(book.moves(b3).empty());
+  EXPECT_EQ(book.pick_best(b3), std::nullopt);
+
+  std::filesystem::remove(path);
+}
+
+TEST(BOOK, Weighted) {
+  std::vector<polyglot::Entry> entries{
+      entry(START_FEN, mv("e2", "e4"), 1),
+      entry(START_FEN, mv("d2", "d4"), 3),
+      entry(START_FEN, mv("a2", "a3"), 0),
+  };
+  std::string path = write_book("dwc_test_book_weighted.bin", entries);
+  Book book{path};
+  Board b{START_FEN};
+  std::mt19937_64 rng{42};
+  int e4 = 0;
+  int d4 = 0;
+  for (int i = 0; i < 4000; ++i) {
+    auto m = book.pick_weighted(b, rng);
+    ASSERT_TRUE(m.has_value());
+    ASSERT_FALSE(*m == mv("a2", "a3"));
+    (*m == mv("e2", "e4") ? e4 : d4)++;
+  }
+  EXPECT_NEAR(static_cast<double>(d4) / e4, 3.0, 0.5);
+
+  std::filesystem::remove(path);
+}
+
+TEST(BOOK, BadFile) {
+  EXPECT_THROW(Book{"/nonexistent/book.bin"}, std::runtime_error);
+
+  std::string path = (std::filesystem::temp_directory_path() / "dwc_test_book_bad.bin").string();
+  std::ofstream{path} << "not a book";
+  EXPECT_THROW(Book{path}, std::runtime_error);
+  std::filesystem::remove(path);
+
+  // empty book is fine, just never in book
+  std::string empty = write_book("dwc_test_book_empty.bin", {});
+  Book book{empty};
+  EXPECT_EQ(book.size(), 0);
+  EXPECT_EQ(book.pick_best(Board{START_FEN}), std::nullopt);
+  std::filesystem::remove(empty);
+}
@@ -0,0 +1,137 @@
+#include "game.hpp"
+
+#include <stdexcept>
+
+#include "src/framework/move_gen.hpp"
+
+namespace dwc::codec {
+namespace {
+// guards the allocation against corrupt lengths, 2^16 plies of at most 2 byte indices
+constexpr size_t MAX_RECORD = STATE_SIZE + VARINT_MAX + (size_t{1} << 16) * 2;
+
+void write_header(std::ostream& os, const std::array<char, 4>& magic) {
+  HeaderT h = make_header(magic);
+  os.write(reinterpret_cast<const char*>(h.data()), h.size());
+  if (!os) throw std::runtime_error("codec stream write failed");
+}
+
+void read_header(std::istream& is, const std::array<char, 4>& magic) {
+  HeaderT h{};
+  if (!is.read(reinterpret_cast<char*>(h.data()), h.size())) throw std::runtime_error("not a dwc codec stream");
+  check_header(h.data(), magic);
+}
+}  // namespace
+
+void encode_game(const State& start, const std::vector<Move>& moves, std::vector<uint8_t>& out) {
+  size_t at = out.size();
+  out.resize(at + STATE_SIZE);
+  pack(start, out.data() + at);
+  put_varint(moves.size(), out);
+
+  Board board{start};
+  for (const Move& move : moves) {
+    uint64_t idx = 0;
+    bool found = false;
+    for (const Move& legal : iter::LegalMoves{board}) {
+      if (legal == move) {
+        found = true;
+        break;
+      }
+      ++idx;
+    }
+    if (!found) throw std::invalid_argument("illegal move in game");
+    put_varint(idx, out);
+    board.apply_move(move);
+  }
+}
+
+GameRecord decode_game(const uint8_t* data, size_t size) {
+  if (size < STATE_SIZE) throw std::runtime_error("truncated game record");
+  const uint8_t* p = data + STATE_SIZE;
+  const uint8_t* end = data + size;
+  GameRecord game{unpack(data), {}};
+  uint64_t plies = get_varint(p, end);
+  // every ply takes at least a byte
+  if (plies > static_cast<size_t>(end - p)) throw std::runtime_error("truncated game record");
+  game.moves.reserve(plies);
+
+  Board board{game.start};
+  for (uint64_t i = 0; i < plies; ++i) {
+    uint64_t idx = get_varint(p, end);
+    std::optional<Move> move;
+    for (const Move& legal : iter::LegalMoves{board}) {
+      if (idx-- == 0) {
+        move = legal;
+        break;
+      }
+    }
+    if (!move.has_value()) throw std::runtime_error("game record move index out of range");
+    game.moves.push_back(*move);
+    board.apply_move(*move);
+  }
+  if (p != end) throw std::runtime_error("trailing bytes in game record");
+  return game;
+}
+
+PositionWriter::PositionWriter(std::ostream& os) : os_(os) {
+  write_header(os_, POSITION_MAGIC);
+}
+
+void PositionWriter::write(const State& state) {
+  PackedStateT packed = pack(state);
+  os_.write(reinterpret_cast<const char*>(packed.data()), packed.size());
+  if (!os_) throw std::runtime_error("codec stream write failed");
+  ++count_;
+}
+
+PositionReader::PositionReader(std::istream& is) : is_(is) {
+  read_header(is_, POSITION_MAGIC);
+}
+
+std::optional<State> PositionReader::next() {
+  PackedStateT packed;
+  is_.read(reinterpret_cast<char*>(packed.data()), packed.size());
+  if (is_.gcount() == 0 && is_.eof()) return std::nullopt;
+  if (static_cast<size_t>(is_.gcount()) != packed.size()) throw std::runtime_error("truncated position record");
+  return unpack(packed.data());
+}
+
+GameWriter::GameWriter(std::ostream& os) : os_(os) {
+  write_header(os_, GAME_MAGIC);
+}
+
+void GameWriter::write(const State& start, const std::vector<Move>& moves) {
+  buffer_.clear();
+  encode_game(start, moves, buffer_);
+  std::vector<uint8_t> length;
+  put_varint(buffer_.size(), length);
+  os_.write(reinterpret_cast<const char*>(length.data()), length.size());
+  os_.write(reinterpret_cast<const char*>(buffer_.data()), buffer_.size());
+  if (!os_) throw std::runtime_error("codec stream write failed");
+  ++count_;
+}
+
+GameReader::GameReader(std::istream& is) : is_(is) {
+  read_header(is_, GAME_MAGIC);
+}
+
+std::optional<GameRecord> GameReader::next() {
+  uint64_t size = 0;
+  for (size_t i = 0;; ++i) {
+    if (i == VARINT_MAX) throw std::runtime_error("varint too long");
+    int c = is_.get();
+    if (c == std::istream::traits_type::eof()) {
+      if (i == 0) return std::nullopt;
+      throw std::runtime_error("truncated game record");
+    }
+    size |= uint64_t{static_cast<uint8_t>(c) & 0x7fu} << (7 * i);
+    if (!(c & 0x80)) break;
+  }
+  if (size > MAX_RECORD) throw std::runtime_error("game record too large");
+
+  buffer_.resize(size);
+  if (!is_.read(reinterpret_cast<char*>(buffer_.data()), size)) throw std::runtime_error("truncated game record");
+  return decode_game(buffer_.data(), buffer_.size());
+}
+
+}  // namespace dwc::codec
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <array>
+#include <cstring>
+#include <istream>
+#include <optional>
+#include <ostream>
+#include <vector>
+
+#include "position.hpp"
+#include "src/framework/board.hpp"
+
+// Games are stored as the packed start State, the ply count and then each move as its index in the legal move list
+// (iter::LegalMoves order), counts and indices as LEB128 varints. Indices below 128 take a byte, so a game costs
+// about one byte per ply on top of the 32 byte start.
+// Streams open with an 8 byte header: the magic, the version and 3 zero bytes. Position streams go on with
+// STATE_SIZE records, game streams with records prefixed by their byte length as varint.
+
+namespace dwc::codec {
+
+constexpr size_t VARINT_MAX = 10;
+constexpr size_t HEADER_SIZE = 8;
+constexpr uint8_t VERSION = 1;
+constexpr std::array<char, 4> POSITION_MAGIC{'D', 'W', 'P', 'S'};
+constexpr std::array<char, 4> GAME_MAGIC{'D', 'W', 'G', 'M'};
+
+using HeaderT = std::array<uint8_t, HEADER_SIZE>;
+
+inline HeaderT make_header(const std::array<char, 4>& magic) {
+  HeaderT h{};
+  std::memcpy(h.data(), magic.data(), magic.size());
+  h[4] = VERSION;
+  return h;
+}
+
+// throws std::runtime_error if h isn't a header with this magic
+inline void check_header(const uint8_t* h, const std::array<char, 4>& magic) {
+  if (std::memcmp(h, magic.data(), magic.size()) != 0) throw std::runtime_error("not a dwc codec stream");
+  if (h[4] != VERSION) throw std::runtime_error("unsupported codec stream version");
+}
+
+inline void put_varint(uint64_t v, std::vector<uint8_t>& out) {
+  for (; v >= 0x80; v >>= 7) out.push_back(static_cast<uint8_t>(v | 0x80));
+  out.push_back(static_cast<uint8_t>(v));
+}
+
+// advances p, throws std::runtime_error if the varint runs past end or is too long
+inline uint64_t get_varint(const uint8_t*& p, const uint8_t* end) {
+  uint64_t v = 0;
+  for (size_t i = 0; i < VARINT_MAX; ++i) {
+    if (p == end) throw std::runtime_error("truncated varint");
+    uint8_t b = *p++;
+    v |= uint64_t{b & 0x7fu} << (7 * i);
+    if (!(b & 0x80)) return v;
+  }
+  throw std::runtime_error("varint too long");
+}
+
+struct GameRecord {
+  State start;
+  std::vector<Move> moves;
+};
+
+// appends the game to out, throws std::invalid_argument if a move isn't legal
+void encode_game(const State& start, const std::vector<Move>& moves, std::vector<uint8_t>& out);
+// throws std::runtime_error on corrupt data, trailing bytes included
+GameRecord decode_game(const uint8_t* data, size_t size);
+
+class PositionWriter {
+  std::ostream& os_;
+  size_t count_{0};
+
+ public:
+  // writes the header right away
+  explicit PositionWriter(std::ostream& os);
+  void write(const State& state);
+  size_t count() const { return count_; }
+};
+
+class PositionReader {
+  std::istream& is_;
+
+ public:
+  // throws std::runtime_error if the stream doesn't start with a position header
+  explicit PositionReader(std::istream& is);
+  // nullopt at the end of the stream, throws std::runtime_error on a truncated or corrupt record
+  std::optional<State> next();
+};
+
+class GameWriter {
+  std::ostream& os_;
+  std::vector<uint8_t> buffer_;
+  size_t count_{0};
+
+ public:
+  explicit GameWriter(std::ostream& os);
+  void write(const State& start, const std::vector<Move>& moves);
+  size_t count() const { return count_; }
+};
+
+class GameReader {
+  std::istream& is_;
+  std::vector<uint8_t> buffer_;
+
+ public:
+  explicit GameReader(std::istream& is);
+  std::optional<GameRecord> next();
+};
+
+}  // namespace dwc::codec
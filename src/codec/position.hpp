@@ -0,0 +1,166 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+
+#include "src/framework/attack_tables.hpp"
+#include "src/framework/basic_types.hpp"
+#include "src/framework/square_iter.hpp"
+
+// Fixed size binary State, 32 bytes against ~60 for the same position as FEN text. All numbers little-endian.
+//   0..7    occupancy bitboard, bit Pos::index()
+//   8..23   Piece::ordinal() of each occupied square in index order, a nibble each, low nibble first
+//   24      flags: bit 0 black to move, bits 1..4 castling rights KQkq, bit 5 no side to move
+//   25      en passant square, EP_NONE as State doesn't track it yet
+//   26..27  halfmove clock
+//   28..29  fullmove number
+//   30..31  castling files (3 bits each): king, king side rook, queen side rook
+
+namespace dwc::codec {
+
+constexpr size_t STATE_SIZE = 32;
+constexpr size_t MAX_PIECES = 32;
+constexpr uint8_t EP_NONE = 0xff;
+
+using PackedStateT = std::array<uint8_t, STATE_SIZE>;
+
+namespace _inner {
+constexpr uint8_t FLAG_BLACK = 1;
+constexpr uint8_t FLAG_CASTLING_SHIFT = 1;
+constexpr uint8_t FLAG_NO_TURN = 1 << 5;
+constexpr uint8_t FLAG_UNUSED = 1 << 6 | 1 << 7;
+
+// castling bit order KQkq, i.e. CastlingRules::index()
+constexpr std::array<Piece, 4> CASTLING_RIGHTS{
+    Piece{Type::KING, Side::WHITE}, {Type::QUEEN, Side::WHITE}, {Type::KING, Side::BLACK}, {Type::QUEEN, Side::BLACK}};
+
+inline void put_u16(uint8_t* p, uint16_t v) {
+  p[0] = static_cast<uint8_t>(v);
+  p[1] = static_cast<uint8_t>(v >> 8);
+}
+
+inline uint16_t get_u16(const uint8_t* p) {
+  return static_cast<uint16_t>(p[0] | p[1] << 8);
+}
+}  // namespace _inner
+
+// throws std::invalid_argument with more than MAX_PIECES pieces
+inline void pack(const State& state, uint8_t* out) {
+  attack::BitboardT occupied = 0;
+  size_t n = 0;
+  std::array<uint8_t, MAX_PIECES / 2> nibbles{};
+  for (uint8_t sq = 0; sq < 64; ++sq) {
+    auto p = board_ut::get(Pos::from_index(sq), state.board);
+    if (!p.has_value()) continue;
+    if (n == MAX_PIECES) throw std::invalid_argument("too many pieces to pack");
+    occupied |= attack::BitboardT{1} << sq;
+    nibbles[n / 2] |= static_cast<uint8_t>(p->ordinal() << (n % 2 * 4));
+    ++n;
+  }
+  for (size_t i = 0; i < 8; ++i) out[i] = static_cast<uint8_t>(occupied >> (i * 8));
+  for (size_t i = 0; i < nibbles.size(); ++i) out[8 + i] = nibbles[i];
+
+  uint8_t flags = 0;
+  if (!state.turn.has_value()) flags |= _inner::FLAG_NO_TURN;
+  if (state.turn == Side::BLACK) flags |= _inner::FLAG_BLACK;
+  for (Piece right : state.castling) {
+    flags |= static_cast<uint8_t>(1 << (_inner::FLAG_CASTLING_SHIFT + CastlingRules::index(right)));
+  }
+  out[24] = flags;
+  out[25] = EP_NONE;
+  _inner::put_u16(out + 26, state.halfmove);
+  _inner::put_u16(out + 28, state.fullmove);
+
+  const CastlingRules& rules = state.castling_rules;
+  const CastleInfo& king_side = rules[{Type::KING, Side::WHITE}];
+  const CastleInfo& queen_side = rules[{Type::QUEEN, Side::WHITE}];
+  int files = king_side.king_from % 8 | king_side.rook_from % 8 << 3 | queen_side.rook_from % 8 << 6;
+  _inner::put_u16(out + 30, static_cast<uint16_t>(files));
+}
+
+inline PackedStateT pack(const State& state) {
+  PackedStateT res;
+  pack(state, res.data());
+  return res;
+}
+
+// throws std::runtime_error if the bytes aren't a packed state
+inline State unpack(const uint8_t* data) {
+  attack::BitboardT occupied = 0;
+  for (size_t i = 0; i < 8; ++i) occupied |= attack::BitboardT{data[i]} << (i * 8);
+  if (attack::popcount(occupied) > MAX_PIECES) throw std::runtime_error("packed state has too many pieces");
+
+  State state;
+  size_t n = 0;
+  for (Pos pos : iter::squares_of(occupied)) {
+    uint8_t ordinal = data[8 + n / 2] >> (n % 2 * 4) & 0xf;
+    if (ordinal >= cast_t(Type::SIZE) * cast_t(Side::SIZE)) throw std::runtime_error("packed state has a bad piece");
+    board_ut::set(pos, {static_cast<Type>(ordinal / 2), static_cast<Side>(ordinal % 2)}, state.board);
+    ++n;
+  }
+
+  uint8_t flags = data[24];
+  if (flags & _inner::FLAG_UNUSED) throw std::runtime_error("packed state has unknown flags");
+  if (!(flags & _inner::FLAG_NO_TURN)) state.turn = flags & _inner::FLAG_BLACK ? Side::BLACK : Side::WHITE;
+  state.castling.clear();
+  for (size_t i = 0; i < _inner::CASTLING_RIGHTS.size(); ++i) {
+    if (flags & 1 << (_inner::FLAG_CASTLING_SHIFT + i)) state.castling.insert(_inner::CASTLING_RIGHTS[i]);
+  }
+  if (data[25] != EP_NONE) throw std::runtime_error("packed state has en passant, not supported");
+  state.halfmove = _inner::get_u16(data + 26);
+  state.fullmove = _inner::get_u16(data + 28);
+
+  uint16_t files = _inner::get_u16(data + 30);
+  int8_t king = files & 0x7;
+  int8_t king_rook = files >> 3 & 0x7;
+  int8_t queen_rook = files >> 6 & 0x7;
+  if (files >> 9 != 0 || !(queen_rook < king && king < king_rook)) {
+    throw std::runtime_error("packed state has bad castling files");
+  }
+  state.castling_rules = CastlingRules::make(king, king_rook, queen_rook);
+  return state;
+}
+
+// Zero copy read access to a packed state, valid as long as the bytes are. Accessors trust the record, state()
+// validates it.
+class PositionView {
+  const uint8_t* data_;
+
+ public:
+  explicit PositionView(const uint8_t* data) : data_(data) {}
+
+  const uint8_t* data() const { return data_; }
+
+  attack::BitboardT occupancy() const {
+    attack::BitboardT occupied = 0;
+    for (size_t i = 0; i < 8; ++i) occupied |= attack::BitboardT{data_[i]} << (i * 8);
+    return occupied;
+  }
+
+  std::optional<Piece> get(Pos pos) const {
+    attack::BitboardT occupied = occupancy();
+    attack::BitboardT bit = attack::BitboardT{1} << pos.index();
+    if (!(occupied & bit)) return std::nullopt;
+    size_t n = attack::popcount(occupied & (bit - 1));
+    uint8_t ordinal = data_[8 + n / 2] >> (n % 2 * 4) & 0xf;
+    return Piece{static_cast<Type>(ordinal / 2), static_cast<Side>(ordinal % 2)};
+  }
+
+  std::optional<Side> turn() const {
+    if (data_[24] & _inner::FLAG_NO_TURN) return std::nullopt;
+    return data_[24] & _inner::FLAG_BLACK ? Side::BLACK : Side::WHITE;
+  }
+
+  bool can_castle(Piece right) const {
+    return data_[24] & 1 << (_inner::FLAG_CASTLING_SHIFT + CastlingRules::index(right));
+  }
+
+  uint16_t halfmove() const { return _inner::get_u16(data_ + 26); }
+  uint16_t fullmove() const { return _inner::get_u16(data_ + 28); }
+
+  State state() const { return unpack(data_); }
+};
+
+}  // namespace dwc::codec
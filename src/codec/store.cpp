@@ -0,0 +1,59 @@
+#include "store.hpp"
+
+#include <filesystem>
+#include <stdexcept>
+
+namespace dwc::codec {
+
+PositionStore::PositionStore(const std::string& path) : file_(path) {
+  if (file_.size() < HEADER_SIZE) throw std::runtime_error("not a position store: " + path);
+  check_header(file_.data(), POSITION_MAGIC);
+  if ((file_.size() - HEADER_SIZE) % STATE_SIZE != 0) throw std::runtime_error("truncated position store: " + path);
+  size_ = (file_.size() - HEADER_SIZE) / STATE_SIZE;
+}
+
+PositionView PositionStore::at(size_t idx) const {
+  if (idx >= size_) throw std::out_of_range("position store index out of range");
+  return (*this)[idx];
+}
+
+PositionAppender::PositionAppender(const std::string& path) {
+  namespace fs = std::filesystem;
+  size_t size = fs::exists(path) ? fs::file_size(path) : 0;
+  if (size > 0) {
+    HeaderT h{};
+    std::ifstream ifs{path, std::ios::binary};
+    if (size < HEADER_SIZE || !ifs.read(reinterpret_cast<char*>(h.data()), h.size())) {
+      throw std::runtime_error("not a position store: " + path);
+    }
+    check_header(h.data(), POSITION_MAGIC);
+    count_ = (size - HEADER_SIZE) / STATE_SIZE;
+    size_t whole = HEADER_SIZE + count_ * STATE_SIZE;
+    if (whole != size) fs::resize_file(path, whole);
+  }
+
+  ofs_.open(path, std::ios::binary | std::ios::app);
+  if (!ofs_) throw std::runtime_error("cannot open " + path);
+  if (size == 0) {
+    HeaderT h = make_header(POSITION_MAGIC);
+    ofs_.write(reinterpret_cast<const char*>(h.data()), h.size());
+  }
+}
+
+void PositionAppender::append(const State& state) {
+  PackedStateT packed = pack(state);
+  append(PositionView{packed.data()});
+}
+
+void PositionAppender::append(PositionView view) {
+  ofs_.write(reinterpret_cast<const char*>(view.data()), STATE_SIZE);
+  if (!ofs_) throw std::runtime_error("position store write failed");
+  ++count_;
+}
+
+void PositionAppender::flush() {
+  ofs_.flush();
+  if (!ofs_) throw std::runtime_error("position store write failed");
+}
+
+}  // namespace dwc::codec
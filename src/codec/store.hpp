@@ -0,0 +1,70 @@
+#pragma once
+
+#include <fstream>
+#include <string>
+
+#include "game.hpp"
+#include "src/shared/mapped_file.hpp"
+
+// Position store: a position stream file (POSITION_MAGIC header, then STATE_SIZE records) read through mmap. Records
+// are fixed size, so record i sits at HEADER_SIZE + i * STATE_SIZE and the record number is the index.
+
+namespace dwc::codec {
+
+class PositionStore {
+  utils::MappedFile file_;
+  size_t size_{0};
+
+ public:
+  // throws std::runtime_error if the file can't be mapped or isn't a whole position stream
+  explicit PositionStore(const std::string& path);
+
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+  PositionView operator[](size_t idx) const { return PositionView{file_.data() + HEADER_SIZE + idx * STATE_SIZE}; }
+  // throws std::out_of_range
+  PositionView at(size_t idx) const;
+  // materialized on demand, throws std::runtime_error on a corrupt record
+  Board board(size_t idx) const { return Board{at(idx).state()}; }
+
+  // records [begin, end) of shard part out of parts, contiguous and balanced to one record
+  struct Shard {
+    size_t begin;
+    size_t end;
+  };
+  Shard shard(size_t part, size_t parts) const {
+    return {size_ * part / parts, size_ * (part + 1) / parts};
+  }
+
+  // f(view, idx, scratch) for every record, each worker of the pool takes one shard. Works with any pool offering
+  // size(), run(job(worker, scratch)) and wait(), like engine::ThreadPool. Returns once all shards are done.
+  template <typename POOL, typename F>
+  void for_each(POOL& pool, const F& f) const {
+    size_t parts = pool.size();
+    pool.run([this, parts, &f](size_t worker, auto& scratch) {
+      Shard s = shard(worker, parts);
+      for (size_t idx = s.begin; idx < s.end; ++idx) f((*this)[idx], idx, scratch);
+    });
+    pool.wait();
+  }
+};
+
+// Appends records to a position store file, creating it if needed. A partial record left by an interrupted writer
+// is cut off on open. Stores opened earlier don't see the new records, reopen them.
+class PositionAppender {
+  std::ofstream ofs_;
+  size_t count_{0};
+
+ public:
+  // throws std::runtime_error if the file can't be opened or isn't a position stream
+  explicit PositionAppender(const std::string& path);
+
+  void append(const State& state);
+  void append(PositionView view);
+  void flush();
+  // records in the file, old and appended
+  size_t count() const { return count_; }
+};
+
+}  // namespace dwc::codec
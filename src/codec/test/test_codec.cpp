@@ -0,0 +1,170 @@
+#include <gtest/gtest.h>
+
+#include <sstream>
+
+#include "src/codec/game.hpp"
+#include "src/framework/fen_lib.hpp"
+
+using namespace dwc;
+using namespace dwc::codec;
+
+namespace {
+constexpr std::string_view START_FEN = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+
+Move mv(std::string_view fr, std::string_view to) {
+  return {Pos{fr}, Pos{to}};
+}
+
+void expect_same(const State& a, const State& b) {
+  EXPECT_EQ(fen::to_fen(a), fen::to_fen(b));
+  EXPECT_EQ(a.turn, b.turn);
+  for (Side side : {Side::WHITE, Side::BLACK}) {
+    for (Type type : {Type::KING, Type::QUEEN}) {
+      Piece right{type, side};
+      EXPECT_EQ(a.castling_rules[right].king_from, b.castling_rules[right].king_from);
+      EXPECT_EQ(a.castling_rules[right].rook_from, b.castling_rules[right].rook_from);
+    }
+  }
+}
+
+std::vector<Move> opening() {
+  return {mv("e2", "e4"), mv("e7", "e5"), mv("g1", "f3"), mv("b8", "c6"), mv("f1", "c4"),
+          mv("g8", "f6"), mv("e1", "g1"), mv("f6", "e4"), mv("f1", "e1"), mv("e4", "f2")};
+}
+}  // namespace
+
+TEST(CODEC, Varint) {
+  std::vector<uint8_t> buf;
+  for (uint64_t v : {uint64_t{0}, uint64_t{127}, uint64_t{128}, uint64_t{300}, ~uint64_t{0}}) put_varint(v, buf);
+  EXPECT_EQ(buf.size(), 1 + 1 + 2 + 2 + VARINT_MAX);
+  const uint8_t* p = buf.data();
+  const uint8_t* end = buf.data() + buf.size();
+  for (uint64_t v : {uint64_t{0}, uint64_t{127}, uint64_t{128}, uint64_t{300}, ~uint64_t{0}}) {
+    EXPECT_EQ(get_varint(p, end), v);
+  }
+  EXPECT_EQ(p, end);
+  EXPECT_THROW(get_varint(p, end), std::runtime_error);
+}
+
+TEST(CODEC, PackState) {
+  std::vector<std::string_view> fens{START_FEN, "r3k2r/pppq1ppp/2n2n2/3pp3/1b2P3/2NP1N2/PPP2PPP/R1BQK2R b Kq - 4 8",
+                                     "8/4k3/8/8/2K5/8/8/8 b - - 37 280"};
+  for (std::string_view fen : fens) {
+    State state = Board{fen}.get_state();
+    PackedStateT packed = pack(state);
+    expect_same(unpack(packed.data()), state);
+  }
+
+  // layout: e1 is the 5th occupied square of the start position, a white king
+  PackedStateT packed = pack(Board{START_FEN}.get_state());
+  EXPECT_EQ(packed[0], 0xff);
+  EXPECT_EQ(packed[7], 0xff);
+  Piece king{Type::KING, Side::WHITE};
+  EXPECT_EQ(packed[8 + 2] & 0xf, king.ordinal());
+  EXPECT_EQ(packed[24], 0x1e);  // white to move, all castling rights
+  EXPECT_EQ(packed[25], EP_NONE);
+
+  // chess960 castling files and no side to move
+  State state = Board{"rk5r/8/8/8/8/8/8/RK5R w KQkq"}.get_state();
+  state.castling_rules = CastlingRules::make(1, 7, 0);
+  state.turn.reset();
+  expect_same(unpack(pack(state).data()), state);
+}
+
+TEST(CODEC, PackStateInvalid) {
+  State full;
+  for (uint8_t sq = 0; sq < 33; ++sq) board_ut::set(Pos::from_index(sq), {Type::PAWN, Side::WHITE}, full.board);
+  EXPECT_THROW(pack(full), std::invalid_argument);
+
+  PackedStateT packed = pack(Board{START_FEN}.get_state());
+  PackedStateT bad_piece = packed;
+  bad_piece[8] = 0xff;
+  EXPECT_THROW(unpack(bad_piece.data()), std::runtime_error);
+  PackedStateT bad_flags = packed;
+  bad_flags[24] |= 0x80;
+  EXPECT_THROW(unpack(bad_flags.data()), std::runtime_error);
+  PackedStateT bad_files = packed;
+  bad_files[30] = 0;
+  EXPECT_THROW(unpack(bad_files.data()), std::runtime_error);
+  PackedStateT too_many = packed;
+  too_many[3] = 0xff;
+  EXPECT_THROW(unpack(too_many.data()), std::runtime_error);
+}
+
+TEST(CODEC, Game) {
+  State start = Board{START_FEN}.get_state();
+  std::vector<uint8_t> buf;
+  encode_game(start, opening(), buf);
+  // every index fits a byte
+  EXPECT_EQ(buf.size(), STATE_SIZE + 1 + opening().size());
+
+  GameRecord game = decode_game(buf.data(), buf.size());
+  expect_same(game.start, start);
+  EXPECT_EQ(game.moves, opening());
+
+  std::vector<uint8_t> bad;
+  EXPECT_THROW(encode_game(start, {mv("e2", "e5")}, bad), std::invalid_argument);
+
+  buf.back() = 120;  // no such move
+  EXPECT_THROW(decode_game(buf.data(), buf.size()), std::runtime_error);
+  buf.push_back(0);
+  EXPECT_THROW(decode_game(buf.data(), buf.size()), std::runtime_error);
+  EXPECT_THROW(decode_game(buf.data(), STATE_SIZE - 1), std::runtime_error);
+}
+
+TEST(CODEC, Streams) {
+  std::stringstream ps;
+  PositionWriter pw{ps};
+  Board b{START_FEN};
+  for (const Move& m : opening()) {
+    pw.write(b.get_state());
+    b.move(m);
+  }
+  EXPECT_EQ(pw.count(), opening().size());
+  EXPECT_EQ(ps.str().size(), HEADER_SIZE + opening().size() * STATE_SIZE);
+
+  PositionReader pr{ps};
+  Board replay{START_FEN};
+  for (const Move& m : opening()) {
+    auto state = pr.next();
+    ASSERT_TRUE(state.has_value());
+    expect_same(*state, replay.get_state());
+    replay.move(m);
+  }
+  EXPECT_FALSE(pr.next().has_value());
+
+  std::stringstream gs;
+  GameWriter gw{gs};
+  gw.write(Board{START_FEN}.get_state(), opening());
+  gw.write(b.get_state(), {});
+  gw.write(Board{START_FEN}.get_state(), {mv("d2", "d4")});
+  EXPECT_EQ(gw.count(), 3);
+
+  GameReader gr{gs};
+  EXPECT_EQ(gr.next()->moves, opening());
+  auto empty = gr.next();
+  ASSERT_TRUE(empty.has_value());
+  expect_same(empty->start, b.get_state());
+  EXPECT_TRUE(empty->moves.empty());
+  EXPECT_EQ(gr.next()->moves, std::vector<Move>{mv("d2", "d4")});
+  EXPECT_FALSE(gr.next().has_value());
+}
+
+TEST(CODEC, BadStreams) {
+  std::stringstream wrong{"DWGM-not-positions"};
+  EXPECT_THROW(PositionReader{wrong}, std::runtime_error);
+  std::stringstream short_header{"DWPS"};
+  EXPECT_THROW(PositionReader{short_header}, std::runtime_error);
+
+  std::stringstream ps;
+  PositionWriter{ps}.write(Board{START_FEN}.get_state());
+  std::stringstream truncated{ps.str().substr(0, ps.str().size() - 1)};
+  PositionReader pr{truncated};
+  EXPECT_THROW(pr.next(), std::runtime_error);
+
+  std::stringstream gs;
+  GameWriter{gs}.write(Board{START_FEN}.get_state(), opening());
+  std::stringstream truncated_game{gs.str().substr(0, gs.str().size() - 1)};
+  GameReader gr{truncated_game};
+  EXPECT_THROW(gr.next(), std::runtime_error);
+}
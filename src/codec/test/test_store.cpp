@@ -0,0 +1,156 @@
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+
+#include "src/codec/store.hpp"
+#include "src/engine/search.hpp"
+#include "src/engine/thread_pool.hpp"
+#include "src/framework/fen_lib.hpp"
+#include "src/shared/test/temp_dir.hpp"
+
+using namespace dwc;
+using namespace dwc::codec;
+
+namespace {
+namespace fs = std::filesystem;
+
+constexpr std::string_view START_FEN = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+
+// positions of a short game, in order
+std::vector<State> game_states() {
+  std::vector<State> res;
+  Board b{START_FEN};
+  for (auto [fr, to] : {std::pair{"e2", "e4"}, {"e7", "e5"}, {"g1", "f3"}, {"b8", "c6"}, {"f1", "c4"}, {"g8", "f6"},
+                        {"e1", "g1"}, {"f6", "e4"}, {"f1", "e1"}, {"e4", "f2"}, {"g1", "f2"}}) {
+    res.push_back(b.get_state());
+    b.move({Pos{fr}, Pos{to}});
+  }
+  res.push_back(b.get_state());
+  return res;
+}
+
+size_t count_moves(const Board& board, MovesT& moves) {
+  size_t n = 0;
+  for (Pos pos : iter::squares_of(board.get_mailbox().occupancy(*board.get_state().turn))) {
+    moves = board.get_moves(pos);
+    n += moves.size();
+  }
+  return n;
+}
+
+struct Totals {
+  MovesT moves;
+  size_t positions{0};
+  size_t moves_total{0};
+  int64_t eval{0};
+};
+
+class StoreTest : public test::TempDirTest {
+ protected:
+  fs::path path_;
+  void SetUp() override {
+    TempDirTest::SetUp();
+    path_ = dir_ / "store.dwps";
+  }
+};
+}  // namespace
+
+TEST_F(StoreTest, AppendAndRead) {
+  auto states = game_states();
+  {
+    PositionAppender app{path_.string()};
+    for (size_t i = 0; i < 5; ++i) app.append(states[i]);
+    EXPECT_EQ(app.count(), 5);
+  }
+  {
+    // reopened, appends after the existing records
+    PositionAppender app{path_.string()};
+    EXPECT_EQ(app.count(), 5);
+    for (size_t i = 5; i < states.size(); ++i) app.append(states[i]);
+    app.flush();
+  }
+
+  PositionStore store{path_.string()};
+  ASSERT_EQ(store.size(), states.size());
+  for (size_t i = 0; i < states.size(); ++i) {
+    EXPECT_EQ(fen::to_fen(store[i].state()), fen::to_fen(states[i]));
+    EXPECT_EQ(store[i].turn(), states[i].turn);
+    EXPECT_EQ(store[i].fullmove(), states[i].fullmove);
+  }
+  EXPECT_EQ(store[0].get(Pos{"e1"}), (Piece{Type::KING, Side::WHITE}));
+  EXPECT_EQ(store[0].get(Pos{"e4"}), std::nullopt);
+  EXPECT_TRUE(store[0].can_castle({Type::QUEEN, Side::BLACK}));
+  EXPECT_FALSE(store[states.size() - 1].can_castle({Type::KING, Side::WHITE}));
+  EXPECT_EQ(store.board(1).get(Pos{"e4"}), (Piece{Type::PAWN, Side::WHITE}));
+  EXPECT_THROW(store.at(states.size()), std::out_of_range);
+}
+
+TEST_F(StoreTest, Shards) {
+  {
+    PositionAppender app{path_.string()};
+    for (const auto& s : game_states()) app.append(s);
+  }
+  PositionStore store{path_.string()};
+  size_t covered = 0;
+  for (size_t part = 0; part < 5; ++part) {
+    auto s = store.shard(part, 5);
+    EXPECT_EQ(s.begin, covered);
+    EXPECT_LE(s.end - s.begin, store.size() / 5 + 1);
+    covered = s.end;
+  }
+  EXPECT_EQ(covered, store.size());
+
+  // moves and eval of every position, in parallel and sequentially
+  engine::ThreadPool<Totals> pool{3};
+  store.for_each(pool, [](PositionView view, size_t, Totals& t) {
+    Board board{view.state()};
+    ++t.positions;
+    t.moves_total += count_moves(board, t.moves);
+    t.eval += engine::evaluate(board);
+  });
+  Totals parallel;
+  for (size_t w = 0; w < pool.size(); ++w) {
+    parallel.positions += pool.scratch(w).positions;
+    parallel.moves_total += pool.scratch(w).moves_total;
+    parallel.eval += pool.scratch(w).eval;
+  }
+
+  Totals serial;
+  for (size_t i = 0; i < store.size(); ++i) {
+    Board board = store.board(i);
+    serial.moves_total += count_moves(board, serial.moves);
+    serial.eval += engine::evaluate(board);
+  }
+  EXPECT_EQ(parallel.positions, store.size());
+  EXPECT_EQ(parallel.moves_total, serial.moves_total);
+  EXPECT_EQ(parallel.eval, serial.eval);
+  EXPECT_GT(serial.moves_total, 20 * store.size());
+}
+
+TEST_F(StoreTest, BadFiles) {
+  EXPECT_THROW(PositionStore{path_.string()}, std::runtime_error);
+
+  std::ofstream{path_} << "DWGM-games-not-positions";
+  EXPECT_THROW(PositionStore{path_.string()}, std::runtime_error);
+  EXPECT_THROW(PositionAppender{path_.string()}, std::runtime_error);
+  fs::remove(path_);
+
+  {
+    PositionAppender app{path_.string()};
+    app.append(Board{START_FEN}.get_state());
+  }
+  std::ofstream{path_, std::ios::binary | std::ios::app} << "partial";
+  EXPECT_THROW(PositionStore{path_.string()}, std::runtime_error);
+  // the appender cuts the partial record
+  PositionAppender app{path_.string()};
+  EXPECT_EQ(app.count(), 1);
+  app.append(Board{START_FEN}.get_state());
+  app.flush();
+  EXPECT_EQ(PositionStore{path_.string()}.size(), 2);
+
+  // an empty store is fine
+  fs::remove(path_);
+  PositionAppender{path_.string()}.flush();
+  EXPECT_TRUE(PositionStore{path_.string()}.empty());
+}
@@ -0,0 +1,85 @@
+#include "engine.hpp"
+
+namespace dwc::engine {
+
+Engine::Engine(size_t threads, size_t hash_mb) : pool_(threads), tt_(hash_mb) {
+  root_.reset_position();
+}
+
+Engine::~Engine() {
+  stop();
+  pool_.wait();
+}
+
+void Engine::set_threads(size_t threads) {
+  stop();
+  pool_.resize(threads);
+}
+
+void Engine::set_hash_size(size_t mb) {
+  stop();
+  pool_.wait();
+  tt_.resize(mb);
+}
+
+void Engine::set_search_options(const SearchOptions& options) {
+  stop();
+  pool_.wait();
+  shared_.options = options;
+}
+
+void Engine::new_game() {
+  stop();
+  pool_.wait();
+  tt_.clear();
+  for (size_t i = 0; i < pool_.size(); ++i) pool_.scratch(i).ordering.clear();
+}
+
+void Engine::set_position(const Board& board) {
+  stop();
+  pool_.wait();
+  root_ = board;
+}
+
+void Engine::go(const Limits& limits) {
+  stop();
+  pool_.wait();
+
+  tt_.new_search();
+  shared_.reset(limits);
+  pool_.run([this](size_t idx, SearchScratch& scratch) {
+    Searcher searcher(root_, shared_, tt_, scratch, idx);
+    SearchResult res = searcher.run(idx == 0 ? on_info_ : nullptr);
+    if (idx != 0) return;
+
+    // helpers only feed the hash table, stop them once the main thread is done
+    shared_.stop = true;
+    res.nodes = shared_.nodes;
+    result_ = res;
+    if (on_bestmove_) on_bestmove_(result_);
+  });
+}
+
+void Engine::ponderhit() {
+  shared_.restart_clock();
+  shared_.pondering = false;
+  shared_.release();
+}
+
+void Engine::stop() {
+  shared_.stop = true;
+  shared_.release();
+}
+
+SearchResult Engine::wait() {
+  pool_.wait();
+  return result_;
+}
+
+SearchResult Engine::analyse(const Board& board, const Limits& limits) {
+  set_position(board);
+  go(limits);
+  return wait();
+}
+
+}  // namespace dwc::engine
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <functional>
+
+#include "src/engine/search.hpp"
+#include "src/engine/thread_pool.hpp"
+#include "src/engine/transposition_table.hpp"
+#include "src/framework/board.hpp"
+
+namespace dwc::engine {
+
+// Search driver meant to live for a whole game (or many games).
+// The worker threads, their scratch memory and the hash table are created once and reused for every move,
+// only new_game() clears what was learned.
+class Engine {
+ public:
+  using InfoCallbackT = std::function<void(const SearchInfo&)>;
+  using BestMoveCallbackT = std::function<void(const SearchResult&)>;
+
+ private:
+  ThreadPool<SearchScratch> pool_;
+  TranspositionTable tt_;
+  SharedState shared_;
+  Board root_;
+  SearchResult result_;
+  InfoCallbackT on_info_;
+  BestMoveCallbackT on_bestmove_;
+
+ public:
+  explicit Engine(size_t threads = 1, size_t hash_mb = 16);
+  ~Engine();
+
+  void set_threads(size_t threads);
+  void set_hash_size(size_t mb);
+  size_t threads() const { return pool_.size(); }
+
+  // applies from the next search on
+  void set_search_options(const SearchOptions& options);
+  const SearchOptions& search_options() const { return shared_.options; }
+
+  // called from the main search thread, must not call back into wait()
+  void set_info_callback(InfoCallbackT cb) { on_info_ = std::move(cb); }
+  void set_bestmove_callback(BestMoveCallbackT cb) { on_bestmove_ = std::move(cb); }
+
+  // forget hash entries and move ordering statistics
+  void new_game();
+
+  // the next search starts from here, hash and history are kept
+  void set_position(const Board& board);
+
+  // starts the search in the background and returns immediately
+  void go(const Limits& limits);
+
+  // the opponent played the expected move: switch the pondering search to normal limits, starting the clock now
+  void ponderhit();
+
+  void stop();
+
+  // blocks until the search finished and returns its result
+  SearchResult wait();
+
+  // searches board and blocks until done; with limits.multipv > 1 the result has that many lines, best first
+  SearchResult analyse(const Board& board, const Limits& limits);
+
+  bool is_searching() { return pool_.is_running(); }
+
+  const TranspositionTable& tt() const { return tt_; }
+};
+
+}  // namespace dwc::engine
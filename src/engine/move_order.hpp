@@ -0,0 +1,111 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <optional>
+
+#include "src/framework/basic_types.hpp"
+
+namespace dwc::engine {
+
+// Move in 16 bits, from and to as Pos::index(). 0 (a1 to a1) is never a move, so it marks an empty slot.
+using PackedMoveT = uint16_t;
+constexpr PackedMoveT NO_MOVE = 0;
+
+constexpr PackedMoveT pack(Move m) {
+  return static_cast<PackedMoveT>(m.fr.index() << 6 | m.to.index());
+}
+
+inline Move unpack(PackedMoveT m) {
+  return {Pos::from_index(m >> 6), Pos::from_index(m & 63)};
+}
+
+// Butterfly history of quiet moves, indexed by [side][from][to]. Updates use gravity: a bonus moves an entry only
+// part of the way to +-MAX, so entries stay in range without clamping and recent results outweigh old ones.
+class HistoryTable {
+ public:
+  static constexpr int MAX = 1 << 14;
+
+ private:
+  std::array<int16_t, cast_t(Side::SIZE) * 64 * 64> table_{};
+
+  static size_t index(Side side, Move m) { return (cast_t(side) * 64 + m.fr.index()) * 64 + m.to.index(); }
+
+ public:
+  int get(Side side, Move m) const { return table_[index(side, m)]; }
+
+  // positive for a move that caused a cutoff, negative for the quiet moves tried before it
+  void update(Side side, Move m, int bonus) {
+    bonus = std::clamp(bonus, -MAX, MAX);
+    int16_t& h = table_[index(side, m)];
+    h = static_cast<int16_t>(h + bonus - h * std::abs(bonus) / MAX);
+  }
+
+  // between iterations, the last iteration's results count more than older ones
+  void age() {
+    for (int16_t& h : table_) h /= 2;
+  }
+
+  void clear() { table_ = {}; }
+};
+
+// Two quiet moves per ply that caused a cutoff in a sibling node, the most recent first.
+template <size_t PLIES>
+class KillerTable {
+  std::array<std::array<PackedMoveT, 2>, PLIES> table_{};
+
+ public:
+  void add(size_t ply, Move m) {
+    auto& slots = table_[ply];
+    PackedMoveT p = pack(m);
+    if (slots[0] == p) return;
+    slots[1] = slots[0];
+    slots[0] = p;
+  }
+
+  // 0 or 1 for the slot holding m, nullopt if m is no killer
+  std::optional<size_t> slot_of(size_t ply, Move m) const {
+    PackedMoveT p = pack(m);
+    for (size_t i = 0; i < 2; ++i) {
+      if (table_[ply][i] == p) return i;
+    }
+    return std::nullopt;
+  }
+
+  void clear() { table_ = {}; }
+};
+
+// Quiet move that refuted the previous move, indexed by [Piece::ordinal()][to] of the previous move.
+class CounterMoveTable {
+  std::array<std::array<PackedMoveT, 64>, cast_t(Type::SIZE) * cast_t(Side::SIZE)> table_{};
+
+ public:
+  void set(Piece prev_piece, Pos prev_to, Move m) { table_[prev_piece.ordinal()][prev_to.index()] = pack(m); }
+
+  bool is_counter(Piece prev_piece, Pos prev_to, Move m) const {
+    return table_[prev_piece.ordinal()][prev_to.index()] == pack(m);
+  }
+
+  void clear() { table_ = {}; }
+};
+
+// Everything one search thread learns about move quality.
+template <size_t PLIES>
+struct MoveOrdering {
+  HistoryTable history;
+  KillerTable<PLIES> killers;
+  CounterMoveTable counters;
+
+  // killers belong to plies of the previous search's tree
+  void new_search() { killers.clear(); }
+
+  void clear() {
+    history.clear();
+    killers.clear();
+    counters.clear();
+  }
+};
+
+}  // namespace dwc::engine
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+
+#include "src/engine/move_order.hpp"
+
+namespace dwc::engine {
+
+// Triangular principal variation table. Row ply holds the best line found from that ply on, a node copies its
+// child's row behind its own best move. Fixed size, nothing is allocated while searching.
+template <size_t PLIES>
+class PvTable {
+  std::array<std::array<PackedMoveT, PLIES>, PLIES> lines_{};
+  std::array<size_t, PLIES> lengths_{};
+
+ public:
+  // on entering a node, before its children are searched
+  void clear(size_t ply) { lengths_[ply] = 0; }
+
+  // m is the new best move at ply, its line continues with the one of ply + 1
+  void update(size_t ply, Move m) {
+    lines_[ply][0] = pack(m);
+    lengths_[ply] = 1;
+    if (ply + 1 == PLIES) return;
+    std::copy_n(lines_[ply + 1].begin(), lengths_[ply + 1], lines_[ply].begin() + 1);
+    lengths_[ply] += lengths_[ply + 1];
+  }
+
+  size_t length(size_t ply) const { return lengths_[ply]; }
+  Move at(size_t ply, size_t idx) const { return unpack(lines_[ply][idx]); }
+
+  // appended to line
+  void get(size_t ply, MovesT& line) const {
+    for (size_t i = 0; i < lengths_[ply]; ++i) line.push_back(at(ply, i));
+  }
+};
+
+}  // namespace dwc::engine
@@ -0,0 +1,442 @@
+#include "search.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+
+#include "src/framework/move_gen.hpp"
+#include "src/framework/zobrist.hpp"
+
+namespace dwc::engine {
+namespace {
+constexpr std::array<int, cast_t(Type::SIZE)> PIECE_VALUES{100, 320, 330, 500, 900, 0};
+
+// nodes between two updates of the shared counters
+constexpr uint64_t CHECK_INTERVAL = 1024;
+// nodes between two looks at the clock, a node takes some 10 - 20 us, so the search stops well within 1 ms of the
+// hard limit while the clock is read rarely enough not to matter
+constexpr uint64_t TIME_CHECK_INTERVAL = 16;
+
+// move ordering score bands, history scores lie within +-HistoryTable::MAX below them
+constexpr int CAPTURE_SCORE = 1 << 20;
+constexpr int KILLER_SCORE = 1 << 16;
+constexpr int COUNTER_SCORE = KILLER_SCORE - 2;
+
+int history_bonus(int depth) {
+  return std::min(32 * depth * depth, HistoryTable::MAX / 4);
+}
+
+// selective search parameters
+constexpr int NULL_MOVE_MIN_DEPTH = 3;
+constexpr int REVERSE_FUTILITY_MAX_DEPTH = 3;
+constexpr int REVERSE_FUTILITY_MARGIN = 120;  // per ply of depth
+constexpr std::array<int, 3> FUTILITY_MARGINS{0, 150, 300};  // by depth
+constexpr int LMR_MIN_DEPTH = 3;
+constexpr size_t LMR_MIN_MOVES = 3;  // searched at full depth before reducing
+constexpr int ASPIRATION_MIN_DEPTH = 4;
+constexpr int ASPIRATION_WINDOW = 30;       // initial half width, doubled on every fail
+constexpr int ASPIRATION_MAX_WINDOW = 500;  // beyond that the window is opened completely
+
+// a side with only pawns is likely in zugzwang, passing would be better than any move
+bool has_pieces(const Board& board, Side side) {
+  const mailbox::Mailbox& mailbox = board.get_mailbox();
+  for (Type type : {Type::KNIGHT, Type::BISHOP, Type::ROOK, Type::QUEEN}) {
+    if (mailbox.occupancy({type, side}) != 0) return true;
+  }
+  return false;
+}
+
+// plies to reduce a quiet move by, later moves and moves with a bad history less likely raise alpha
+int lmr_reduction(int depth, size_t idx, int history) {
+  int r = idx >= 2 * LMR_MIN_MOVES ? 2 : 1;
+  if (depth >= 8) ++r;
+  if (history > HistoryTable::MAX / 2) --r;
+  if (history < 0) ++r;
+  return std::max(r, 0);
+}
+
+Side side_to_move(const Board& board) {
+  return board.get_state().turn.value_or(Side::WHITE);
+}
+
+// mate scores are stored relative to the node, not the root
+int score_to_tt(int score, int ply) {
+  if (score >= MATE_BOUND) return score + ply;
+  if (score <= -MATE_BOUND) return score - ply;
+  return score;
+}
+
+int score_from_tt(int score, int ply) {
+  if (score >= MATE_BOUND) return score - ply;
+  if (score <= -MATE_BOUND) return score + ply;
+  return score;
+}
+
+// distance to the closest board edge, 0 - 3
+int centrality(Pos pos) {
+  int file = pos.file;
+  int rank = pos.rank;
+  return std::min(std::min(file, 7 - file), std::min(rank, 7 - rank));
+}
+
+int piece_value(const std::optional<Piece>& piece) {
+  return piece.has_value() ? PIECE_VALUES[cast_t(piece->type)] : 0;
+}
+}  // namespace
+
+int evaluate(const Board& board) {
+  int score = 0;
+  const mailbox::Mailbox& mailbox = board.get_mailbox();
+  for (Pos pos : iter::squares_of(mailbox.occupancy())) {
+    auto piece = mailbox.get(pos);
+    int rank = pos.rank;
+    int v = PIECE_VALUES[cast_t(piece->type)];
+    switch (piece->type) {
+      case Type::PAWN:
+        v += 5 * (piece->side == Side::WHITE ? rank - 1 : 6 - rank);
+        break;
+      case Type::KNIGHT:
+      case Type::BISHOP:
+        v += 8 * centrality(pos);
+        break;
+      default:
+        break;
+    }
+    score += piece->side == Side::WHITE ? v : -v;
+  }
+  return side_to_move(board) == Side::WHITE ? score : -score;
+}
+
+void generate_moves(const Board& board, MovesT& moves) {
+  for (const Move& m : iter::LegalMoves{board}) moves.push_back(m);
+}
+
+bool Searcher::should_stop() {
+  bool is_main = thread_idx_ == 0;
+  if (is_main && nodes_ % TIME_CHECK_INTERVAL == 0 && shared_.limits_active() && shared_.time.hard_limit_reached()) {
+    shared_.stop = true;
+  }
+  if (++nodes_unreported_ >= CHECK_INTERVAL) {
+    uint64_t total = shared_.nodes.fetch_add(nodes_unreported_) + nodes_unreported_;
+    nodes_unreported_ = 0;
+    const Limits& l = shared_.limits;
+    if (is_main && shared_.limits_active() && l.nodes.has_value() && total >= *l.nodes) shared_.stop = true;
+  }
+  return shared_.stop;
+}
+
+void Searcher::order_moves(std::optional<Move> tt_move, int ply) {
+  MovesT& moves = scratch_.move_stack[ply];
+  std::vector<int>& scores = scratch_.score_stack[ply];
+  const auto& ordering = scratch_.ordering;
+  Side side = side_to_move(board_);
+  const std::optional<Played>& prev = ply > 0 ? played_[ply - 1] : std::nullopt;
+
+  scores.clear();
+  for (const Move& m : moves) {
+    auto ranked = ply == 0 ? std::find(root_order_.begin(), root_order_.end(), m) : root_order_.end();
+    if (ranked != root_order_.end()) {
+      scores.push_back(INT32_MAX - static_cast<int>(ranked - root_order_.begin()));
+    } else if (tt_move.has_value() && m == *tt_move) {
+      scores.push_back(INT32_MAX);
+    } else if (auto victim = board_.get(m.to); victim.has_value()) {
+      scores.push_back(CAPTURE_SCORE + 10 * piece_value(victim) - piece_value(board_.get(m.fr)) / 100);
+    } else if (auto slot = ordering.killers.slot_of(ply, m)) {
+      scores.push_back(KILLER_SCORE - static_cast<int>(*slot));
+    } else if (prev.has_value() && ordering.counters.is_counter(prev->piece, prev->to, m)) {
+      scores.push_back(COUNTER_SCORE);
+    } else {
+      scores.push_back(ordering.history.get(side, m));
+    }
+  }
+
+  // insertion sort, the lists are short
+  for (size_t i = 1; i < moves.size(); ++i) {
+    for (size_t j = i; j > 0 && scores[j - 1] < scores[j]; --j) {
+      std::swap(scores[j - 1], scores[j]);
+      std::swap(moves[j - 1], moves[j]);
+    }
+  }
+}
+
+void Searcher::update_ordering(size_t cutoff_idx, int depth, int ply) {
+  auto& ordering = scratch_.ordering;
+  const MovesT& moves = scratch_.move_stack[ply];
+  Move cutoff = moves[cutoff_idx];
+  Side side = side_to_move(board_);
+  int bonus = history_bonus(depth);
+  ordering.history.update(side, cutoff, bonus);
+  for (size_t i = 0; i < scratch_.quiet_count[ply]; ++i) {
+    ordering.history.update(side, moves[scratch_.quiets_searched[ply][i]], -bonus);
+  }
+  ordering.killers.add(ply, cutoff);
+  if (ply == 0) return;
+  if (const auto& prev = played_[ply - 1]) ordering.counters.set(prev->piece, prev->to, cutoff);
+}
+
+void Searcher::filter_root_moves(MovesT& moves) const {
+  const auto& search = shared_.limits.searchmoves;
+  auto dropped = [&](Move m) {
+    return (!search.empty() && std::find(search.begin(), search.end(), m) == search.end()) ||
+           std::find(excluded_.begin(), excluded_.end(), m) != excluded_.end();
+  };
+  moves.erase(std::remove_if(moves.begin(), moves.end(), dropped), moves.end());
+}
+
+int Searcher::negamax(int depth, int alpha, int beta, int ply, bool in_check, bool null_ok) {
+  scratch_.pv.clear(ply);
+  if (depth <= 0 || ply >= MAX_PLY) return quiesce(alpha, beta, ply);
+  ++nodes_;
+  if (should_stop()) return 0;
+
+  // a repetition inside the search is scored as a draw already, the opponent can repeat again
+  if (ply > 0 && (board_.is_fifty_move_draw() || board_.repetition_count() > 0)) return 0;
+
+  // zero window nodes only tell whether a move beats alpha, the rest lie on a possible principal variation
+  bool pv_node = beta - alpha > 1;
+  zobrist::KeyT key = board_.get_key();
+  std::optional<Move> tt_move;
+  if (auto entry = tt_.probe(key)) {
+    tt_move = entry->move;
+    int score = score_from_tt(entry->score, ply);
+    // no cutoffs on pv nodes, so the pv table gets the whole line
+    if (!pv_node && entry->depth >= depth &&
+        (entry->bound == Bound::EXACT || (entry->bound == Bound::LOWER && score >= beta) ||
+         (entry->bound == Bound::UPPER && score <= alpha))) {
+      return score;
+    }
+  }
+
+  const SearchOptions& options = shared_.options;
+  Side side = side_to_move(board_);
+  bool prunable = !pv_node && !in_check;
+  int static_eval = prunable ? evaluate(board_) : 0;
+
+  // reverse futility: far enough above beta that no reply is likely to bring the score back
+  if (options.futility && prunable && depth <= REVERSE_FUTILITY_MAX_DEPTH && std::abs(beta) < MATE_BOUND &&
+      static_eval - REVERSE_FUTILITY_MARGIN * depth >= beta) {
+    return static_eval;
+  }
+
+  // null move: if passing still fails high, a real move will too
+  if (options.null_move && null_ok && prunable && depth >= NULL_MOVE_MIN_DEPTH && static_eval >= beta &&
+      has_pieces(board_, side)) {
+    int reduction = 2 + depth / 6;
+    played_[ply].reset();
+    board_.apply_null_move();
+    int score = -negamax(depth - 1 - reduction, -beta, -beta + 1, ply + 1, false, false);
+    board_.undo_move();
+    if (shared_.stop) return 0;
+    // an unproven mate from a null move search
+    if (score >= beta) return score >= MATE_BOUND ? beta : score;
+  }
+
+  MovesT& moves = scratch_.move_stack[ply];
+  moves.clear();
+  generate_moves(board_, moves);
+  if (moves.empty()) return in_check ? -MATE + ply : 0;
+  if (ply == 0) filter_root_moves(moves);
+  order_moves(tt_move, ply);
+  const std::vector<int>& order_scores = scratch_.score_stack[ply];
+
+  // futility: quiet moves are unlikely to raise the static eval past alpha this close to the horizon
+  bool futile = options.futility && prunable && depth < static_cast<int>(FUTILITY_MARGINS.size()) &&
+                std::abs(alpha) < MATE_BOUND && static_eval + FUTILITY_MARGINS[depth] <= alpha;
+
+  int alpha_orig = alpha;
+  int best = -INF;
+  std::optional<Move> best_move;
+  size_t& quiet_count = scratch_.quiet_count[ply];
+  quiet_count = 0;
+  for (size_t i = 0; i < moves.size(); ++i) {
+    Move m = moves[i];
+    bool quiet = !board_.get(m.to).has_value();
+    played_[ply] = Played{*board_.get(m.fr), m.to};
+    board_.apply_move(m);
+    bool gives_check = board_.is_king_threatened(side_to_move(board_));
+    if (futile && quiet && !gives_check && best_move.has_value()) {
+      board_.undo_move();
+      continue;
+    }
+
+    int new_depth = depth - 1 + (options.check_extensions && gives_check ? 1 : 0);
+    // late move reductions: well ordered moves far down the list rarely raise alpha, search them shallower first
+    // (killers and the countermove are not reduced)
+    int reduction = 0;
+    if (options.late_move_reductions && quiet && !in_check && !gives_check && depth >= LMR_MIN_DEPTH &&
+        i >= LMR_MIN_MOVES && order_scores[i] < COUNTER_SCORE) {
+      reduction = std::min(lmr_reduction(depth, i, order_scores[i]), new_depth - 1);
+    }
+    // principal variation search: the first move gets the full window, the others only have to prove they don't
+    // beat alpha, which a zero window search does cheaper
+    int score;
+    if (!best_move.has_value()) {
+      score = -negamax(new_depth, -beta, -alpha, ply + 1, gives_check);
+    } else {
+      score = -negamax(new_depth - reduction, -alpha - 1, -alpha, ply + 1, gives_check);
+      if (score > alpha && reduction > 0) {
+        ++stats_.lmr_researches;
+        score = -negamax(new_depth, -alpha - 1, -alpha, ply + 1, gives_check);
+      }
+      if (score > alpha && score < beta) {
+        ++stats_.pvs_researches;
+        score = -negamax(new_depth, -beta, -alpha, ply + 1, gives_check);
+      }
+    }
+    board_.undo_move();
+    if (shared_.stop) return 0;
+
+    bool first = !best_move.has_value();
+    if (score > best) {
+      best = score;
+      best_move = m;
+      if (ply == 0) root_best_ = m;
+    }
+    if (score > alpha) {
+      alpha = score;
+      scratch_.pv.update(ply, m);
+    }
+    if (alpha >= beta) {
+      ++stats_.cutoffs;
+      if (first) ++stats_.first_move_cutoffs;
+      if (quiet) update_ordering(i, depth, ply);
+      break;
+    }
+    if (quiet && quiet_count < SearchScratch::MAX_QUIETS) {
+      scratch_.quiets_searched[ply][quiet_count++] = static_cast<uint16_t>(i);
+    }
+  }
+
+  Bound bound = best <= alpha_orig ? Bound::UPPER : (best >= beta ? Bound::LOWER : Bound::EXACT);
+  // with moves excluded the root score is not the position's
+  if (ply > 0 || excluded_.empty()) tt_.store(key, best_move, score_to_tt(best, ply), depth, bound);
+  return best;
+}
+
+int Searcher::quiesce(int alpha, int beta, int ply) {
+  ++nodes_;
+  if (should_stop()) return 0;
+
+  int stand_pat = evaluate(board_);
+  if (ply >= MAX_PLY || stand_pat >= beta) return stand_pat;
+  alpha = std::max(alpha, stand_pat);
+
+  MovesT& moves = scratch_.move_stack[ply];
+  moves.clear();
+  generate_moves(board_, moves);
+  auto quiet = [this](const Move& m) { return !board_.get(m.to).has_value(); };
+  moves.erase(std::remove_if(moves.begin(), moves.end(), quiet), moves.end());
+  order_moves(std::nullopt, ply);
+
+  for (size_t i = 0; i < moves.size(); ++i) {
+    board_.apply_move(moves[i]);
+    int score = -quiesce(-beta, -alpha, ply + 1);
+    board_.undo_move();
+    if (shared_.stop) return 0;
+    if (score >= beta) return score;
+    alpha = std::max(alpha, score);
+  }
+  return alpha;
+}
+
+int Searcher::aspiration(int depth, int prev_score, bool in_check) {
+  if (depth < ASPIRATION_MIN_DEPTH || std::abs(prev_score) >= MATE_BOUND) return negamax(depth, -INF, INF, 0, in_check);
+
+  int delta = ASPIRATION_WINDOW;
+  int alpha = prev_score - delta;
+  int beta = prev_score + delta;
+  while (true) {
+    root_best_.reset();
+    int score = negamax(depth, alpha, beta, 0, in_check);
+    if (shared_.stop) return score;
+    if (score > alpha && score < beta) return score;
+
+    delta *= 2;
+    if (score <= alpha) {
+      ++stats_.aspiration_fail_lows;
+      alpha = delta > ASPIRATION_MAX_WINDOW ? -INF : std::max(score - delta, -INF);
+    } else {
+      ++stats_.aspiration_fail_highs;
+      beta = delta > ASPIRATION_MAX_WINDOW ? INF : std::min(score + delta, INF);
+    }
+  }
+}
+
+SearchResult Searcher::run(const std::function<void(const SearchInfo&)>& on_info) {
+  SearchResult result;
+  bool is_main = thread_idx_ == 0;
+
+  MovesT root_moves;
+  generate_moves(board_, root_moves);
+  filter_root_moves(root_moves);
+  if (!root_moves.empty()) {
+    // always have a move to play, even when stopped right away
+    result.best = root_moves.front();
+
+    scratch_.ordering.new_search();
+    root_order_.clear();
+    bool in_check = board_.is_king_threatened(side_to_move(board_));
+    int max_depth = std::min(shared_.limits.depth.value_or(MAX_PLY), MAX_PLY);
+    // helper threads only fill the transposition table, a single line does that best
+    size_t multipv = is_main ? std::clamp<size_t>(shared_.limits.multipv, 1, root_moves.size()) : 1;
+    for (int depth = 1; depth <= max_depth; ++depth) {
+      // lazy SMP: helper threads skip alternating depths so they run ahead of the main thread
+      if (!is_main && depth > 1 && (depth + thread_idx_) % 2 == 0) continue;
+      if (depth > 1) scratch_.ordering.history.age();
+
+      // one root search per line, each without the moves of the lines before; they share the transposition table
+      // and the ordering, so the later lines are much cheaper than searches of their own
+      std::vector<PvLine> lines;
+      excluded_.clear();
+      for (size_t k = 0; k < multipv; ++k) {
+        root_best_.reset();
+        ++stats_.iterations;
+        int prev_score = k < result.lines.size() ? result.lines[k].score : result.score;
+        int score = aspiration(depth, prev_score, in_check);
+        if (shared_.stop) break;
+        PvLine& line = lines.emplace_back(PvLine{*root_best_, score, {}});
+        scratch_.pv.get(0, line.pv);
+        excluded_.push_back(*root_best_);
+      }
+      excluded_.clear();
+      if (shared_.stop) {
+        if (result.depth == 0 && !lines.empty()) result.best = lines.front().move;
+        if (result.depth == 0 && lines.empty() && root_best_.has_value()) result.best = root_best_;
+        break;
+      }
+
+      // a later line can come out ahead, when the search of an earlier one was unstable
+      std::stable_sort(lines.begin(), lines.end(), [](const PvLine& a, const PvLine& b) { return a.score > b.score; });
+      root_order_.clear();
+      for (const PvLine& line : lines) root_order_.push_back(line.move);
+
+      const PvLine& top = lines.front();
+      result.best = top.move;
+      result.score = top.score;
+      result.depth = depth;
+      result.ponder = top.pv.size() > 1 ? std::optional<Move>{top.pv[1]} : std::nullopt;
+      result.lines = std::move(lines);
+      if (is_main && on_info) {
+        for (size_t k = 0; k < result.lines.size(); ++k) {
+          const PvLine& line = result.lines[k];
+          on_info({depth, line.score, shared_.nodes + nodes_unreported_, shared_.elapsed(), line.pv, k + 1});
+        }
+      }
+
+      // a found mate won't change with more depth, unless there are more lines to fill
+      if (multipv == 1 && std::abs(result.score) >= MATE_BOUND) break;
+      if (is_main) {
+        shared_.time.on_iteration(*result.best, result.score);
+        if (shared_.limits_active() && shared_.time.soft_limit_reached()) break;
+      }
+    }
+  }
+
+  shared_.nodes += nodes_unreported_;
+  nodes_unreported_ = 0;
+  if (is_main) shared_.wait_for_release();
+  result.nodes = nodes_;
+  result.stats = stats_;
+  return result;
+}
+
+}  // namespace dwc::engine
@@ -0,0 +1,210 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+#include "src/engine/move_order.hpp"
+#include "src/engine/pv_table.hpp"
+#include "src/engine/time_manager.hpp"
+#include "src/engine/transposition_table.hpp"
+#include "src/framework/board.hpp"
+
+namespace dwc::engine {
+
+constexpr int MAX_PLY = 64;
+constexpr int INF = 32001;
+constexpr int MATE = 32000;
+constexpr int MATE_BOUND = MATE - MAX_PLY;
+
+struct Limits {
+  std::optional<int> depth;
+  std::optional<uint64_t> nodes;
+  std::optional<std::chrono::milliseconds> movetime;
+  // clock of the side to move, the TimeManager makes a budget of it
+  std::optional<std::chrono::milliseconds> time;
+  std::chrono::milliseconds inc{0};
+  std::optional<int> movestogo;
+  bool infinite{false};
+  bool ponder{false};
+  // number of best root moves to search lines for, each with its own score
+  size_t multipv{1};
+  // only these root moves are searched, all if empty
+  std::vector<Move> searchmoves;
+};
+
+// selective search, each feature can be switched off to measure what it buys
+struct SearchOptions {
+  bool null_move{true};
+  bool late_move_reductions{true};
+  bool futility{true};  // futility and reverse futility pruning
+  bool check_extensions{true};
+};
+
+struct SearchInfo {
+  int depth{0};
+  int score{0};
+  uint64_t nodes{0};
+  std::chrono::milliseconds time{0};
+  MovesT pv;
+  size_t multipv{1};  // rank of the line, 1 is the best
+};
+
+// counters of one thread's search, for tuning
+struct SearchStats {
+  uint64_t iterations{0};  // root searches, one per line and depth
+  uint64_t aspiration_fail_lows{0};
+  uint64_t aspiration_fail_highs{0};
+  uint64_t cutoffs{0};
+  uint64_t first_move_cutoffs{0};  // share of cutoffs tells how good the move ordering is
+  uint64_t lmr_researches{0};      // reduced searches that beat alpha and were repeated at full depth
+  uint64_t pvs_researches{0};      // zero window searches that landed inside the window and were repeated with it
+
+  SearchStats& operator+=(const SearchStats& o) {
+    iterations += o.iterations;
+    aspiration_fail_lows += o.aspiration_fail_lows;
+    aspiration_fail_highs += o.aspiration_fail_highs;
+    cutoffs += o.cutoffs;
+    first_move_cutoffs += o.first_move_cutoffs;
+    lmr_researches += o.lmr_researches;
+    pvs_researches += o.pvs_researches;
+    return *this;
+  }
+
+  double aspiration_fail_rate() const {
+    return iterations == 0 ? 0 : static_cast<double>(aspiration_fail_lows + aspiration_fail_highs) / iterations;
+  }
+  double first_move_cutoff_rate() const {
+    return cutoffs == 0 ? 0 : static_cast<double>(first_move_cutoffs) / cutoffs;
+  }
+};
+
+// one root move of a MultiPV search with its score and principal variation
+struct PvLine {
+  Move move;
+  int score{0};
+  MovesT pv;
+};
+
+struct SearchResult {
+  std::optional<Move> best;
+  std::optional<Move> ponder;
+  int score{0};
+  int depth{0};
+  uint64_t nodes{0};
+  SearchStats stats;  // of the main thread
+  // best first, from the last finished iteration; best and score follow lines[0]
+  std::vector<PvLine> lines;
+};
+
+// Per-thread scratch memory. Owned by the thread pool, so it survives between searches and stays warm.
+struct SearchScratch {
+  std::array<MovesT, MAX_PLY + 1> move_stack;
+  std::array<std::vector<int>, MAX_PLY + 1> score_stack;
+  // indices into move_stack of the quiet moves searched at each ply so far, for the history malus; futility pruned
+  // ones aren't in, nor the ones past MAX_QUIETS
+  static constexpr size_t MAX_QUIETS = 64;
+  std::array<std::array<uint16_t, MAX_QUIETS>, MAX_PLY + 1> quiets_searched;
+  std::array<size_t, MAX_PLY + 1> quiet_count{};
+  // kept between searches, new_game() clears it
+  MoveOrdering<MAX_PLY + 1> ordering;
+  PvTable<MAX_PLY + 1> pv;
+};
+
+// State shared by all threads of one search.
+class SharedState {
+  std::mutex m_;
+  std::condition_variable cv_;
+
+ public:
+  Limits limits;
+  SearchOptions options;
+  // the main thread is the only one asking it while searching
+  TimeManager time;
+  std::atomic<bool> stop{false};
+  std::atomic<bool> pondering{false};
+  std::atomic<uint64_t> nodes{0};
+
+  void reset(const Limits& l) {
+    limits = l;
+    stop = false;
+    pondering = l.ponder;
+    nodes = 0;
+    time.start({l.movetime, l.time, l.inc, l.movestogo});
+  }
+
+  void restart_clock() { time.restart(); }
+
+  std::chrono::milliseconds elapsed() const { return time.elapsed(); }
+
+  // time and node limits only apply once the engine is no longer pondering
+  bool limits_active() const { return !pondering && !limits.infinite; }
+
+  // called on ponderhit or stop
+  void release() {
+    std::lock_guard lk(m_);
+    cv_.notify_all();
+  }
+
+  // a pondering or infinite search must not report its move before it is told to
+  void wait_for_release() {
+    std::unique_lock lk(m_);
+    cv_.wait(lk, [this] { return stop || limits_active(); });
+  }
+};
+
+int evaluate(const Board& board);
+
+// all legal moves of the side to move, appended to moves
+void generate_moves(const Board& board, MovesT& moves);
+
+class Searcher {
+  // make / unmake on a single board, so the repetition history is never copied
+  Board board_;
+  SharedState& shared_;
+  TranspositionTable& tt_;
+  SearchScratch& scratch_;
+  size_t thread_idx_;
+  uint64_t nodes_{0};
+  uint64_t nodes_unreported_{0};
+  std::optional<Move> root_best_;
+  // MultiPV: root moves of the lines already found this iteration, the root search skips them
+  MovesT excluded_;
+  // drops the root moves not in limits.searchmoves or excluded
+  void filter_root_moves(MovesT& moves) const;
+  // best moves of the previous iteration's lines, by rank, searched first at the root
+  MovesT root_order_;
+  SearchStats stats_;
+  // piece and target square of the move played at each ply, for countermoves
+  struct Played {
+    Piece piece;
+    Pos to;
+  };
+  std::array<std::optional<Played>, MAX_PLY + 1> played_;
+
+  bool should_stop();
+  // tt move, captures by MVV-LVA, killers, countermove, then quiet moves by history; at the root the previous
+  // iteration's lines go first
+  void order_moves(std::optional<Move> tt_move, int ply);
+  // the quiet move at cutoff_idx of the ply's move list caused a beta cutoff, the quiet moves searched before it didn't
+  void update_ordering(size_t cutoff_idx, int depth, int ply);
+  // in_check: the side to move is in check, null_ok: a null move may be tried
+  int negamax(int depth, int alpha, int beta, int ply, bool in_check, bool null_ok = true);
+  int quiesce(int alpha, int beta, int ply);
+  // root search in a window around the previous iteration's score, widened until the score lands inside
+  int aspiration(int depth, int prev_score, bool in_check);
+
+ public:
+  Searcher(const Board& root, SharedState& shared, TranspositionTable& tt, SearchScratch& scratch, size_t thread_idx)
+      : board_(root), shared_(shared), tt_(tt), scratch_(scratch), thread_idx_(thread_idx) {}
+
+  // iterative deepening, only the main thread (index 0) reports info
+  SearchResult run(const std::function<void(const SearchInfo&)>& on_info = nullptr);
+};
+
+}  // namespace dwc::engine
@@ -0,0 +1,338 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <set>
+#include <thread>
+
+#include "src/engine/engine.hpp"
+#include "src/engine/move_order.hpp"
+#include "src/engine/pv_table.hpp"
+#include "src/engine/thread_pool.hpp"
+#include "src/engine/transposition_table.hpp"
+#include "src/framework/zobrist.hpp"
+
+using namespace dwc;
+using namespace dwc::engine;
+using namespace std::chrono_literals;
+
+namespace {
+// Ra8 mates
+constexpr std::string_view MATE_IN_1 = "6k1/5ppp/8/8/8/8/8/R5K1 w";
+// Rxd5 wins the queen
+constexpr std::string_view HANGING_QUEEN = "4k3/8/8/3q4/8/8/3R4/4K3 w";
+}  // namespace
+
+TEST(ENGINE, TTStoreProbe) {
+  TranspositionTable tt(1);
+  zobrist::KeyT key = zobrist::compute(Board{MATE_IN_1}.get_state());
+  EXPECT_FALSE(tt.probe(key).has_value());
+
+  tt.store(key, Move{{"a1"}, {"a8"}}, -1234, 5, Bound::LOWER);
+  auto e = tt.probe(key);
+  ASSERT_TRUE(e.has_value());
+  EXPECT_EQ(e->move, (Move{{"a1"}, {"a8"}}));
+  EXPECT_EQ(e->score, -1234);
+  EXPECT_EQ(e->depth, 5);
+  EXPECT_EQ(e->bound, Bound::LOWER);
+  EXPECT_FALSE(tt.probe(key ^ 1).has_value());
+
+  // shallower entry doesn't replace a deeper one from the same search
+  tt.store(key, std::nullopt, 0, 2, Bound::UPPER);
+  EXPECT_EQ(tt.probe(key)->depth, 5);
+
+  // but does from an older search, and keeps the move
+  tt.new_search();
+  tt.store(key, std::nullopt, 0, 2, Bound::UPPER);
+  EXPECT_EQ(tt.probe(key)->depth, 2);
+  EXPECT_EQ(tt.probe(key)->move, (Move{{"a1"}, {"a8"}}));
+
+  tt.clear();
+  EXPECT_FALSE(tt.probe(key).has_value());
+}
+
+TEST(ENGINE, MoveOrderingTables) {
+  Move e4{{"e2"}, {"e4"}};
+  Move d4{{"d2"}, {"d4"}};
+  EXPECT_EQ(unpack(pack(e4)), e4);
+
+  HistoryTable history;
+  for (int i = 0; i < 1000; ++i) history.update(Side::WHITE, e4, HistoryTable::MAX);
+  // gravity saturates instead of overflowing
+  EXPECT_EQ(history.get(Side::WHITE, e4), HistoryTable::MAX);
+  EXPECT_EQ(history.get(Side::BLACK, e4), 0);
+  history.update(Side::WHITE, d4, -100);
+  EXPECT_LT(history.get(Side::WHITE, d4), 0);
+  history.age();
+  EXPECT_EQ(history.get(Side::WHITE, e4), HistoryTable::MAX / 2);
+
+  KillerTable<4> killers;
+  killers.add(1, e4);
+  killers.add(1, e4);
+  killers.add(1, d4);
+  EXPECT_EQ(killers.slot_of(1, d4), 0);
+  EXPECT_EQ(killers.slot_of(1, e4), 1);
+  EXPECT_FALSE(killers.slot_of(2, e4).has_value());
+
+  CounterMoveTable counters;
+  Piece black_knight{Type::KNIGHT, Side::BLACK};
+  counters.set(black_knight, {"f6"}, e4);
+  EXPECT_TRUE(counters.is_counter(black_knight, {"f6"}, e4));
+  EXPECT_FALSE(counters.is_counter(black_knight, {"f6"}, d4));
+  EXPECT_FALSE(counters.is_counter(black_knight, {"c6"}, e4));
+}
+
+TEST(ENGINE, PvTable) {
+  Move e4{{"e2"}, {"e4"}};
+  Move e5{{"e7"}, {"e5"}};
+  Move nf3{{"g1"}, {"f3"}};
+  PvTable<4> pv;
+  pv.clear(3);
+  pv.update(3, nf3);
+  pv.clear(2);
+  pv.update(2, e5);
+  // a better move at ply 2 whose child returned without a line
+  pv.clear(3);
+  pv.update(2, nf3);
+  pv.update(1, e4);
+  EXPECT_EQ(pv.length(1), 2);
+  EXPECT_EQ(pv.at(1, 0), e4);
+  EXPECT_EQ(pv.at(1, 1), nf3);
+
+  MovesT line;
+  pv.get(1, line);
+  EXPECT_EQ(line, (MovesT{e4, nf3}));
+}
+
+TEST(ENGINE, ThreadPoolReusesThreads) {
+  ThreadPool<int> pool(3);
+  std::mutex m;
+  std::set<std::thread::id> first;
+  std::set<std::thread::id> second;
+
+  auto job = [&m](std::set<std::thread::id>& ids) {
+    return [&m, &ids](size_t, int& scratch) {
+      std::lock_guard lk(m);
+      ids.insert(std::this_thread::get_id());
+      ++scratch;
+    };
+  };
+  pool.run(job(first));
+  pool.run(job(second));
+  pool.wait();
+
+  EXPECT_EQ(first.size(), 3);
+  EXPECT_EQ(first, second);
+  for (size_t i = 0; i < pool.size(); ++i) EXPECT_EQ(pool.scratch(i), 2);
+
+  // growing keeps the warm scratch of the existing threads
+  pool.resize(4);
+  EXPECT_EQ(pool.scratch(0), 2);
+  EXPECT_EQ(pool.scratch(3), 0);
+}
+
+TEST(ENGINE, SearchFindsBestMove) {
+  Engine e;
+  Limits l;
+
+  e.set_position(Board{HANGING_QUEEN});
+  l.depth = 1;
+  e.go(l);
+  auto res = e.wait();
+  ASSERT_TRUE(res.best.has_value());
+  EXPECT_EQ(*res.best, (Move{{"d2"}, {"d5"}}));
+
+  e.set_position(Board{MATE_IN_1});
+  l.depth = 3;
+  e.go(l);
+  res = e.wait();
+  ASSERT_TRUE(res.best.has_value());
+  EXPECT_EQ(*res.best, (Move{{"a1"}, {"a8"}}));
+  EXPECT_EQ(res.score, MATE - 1);
+}
+
+TEST(ENGINE, SelectiveSearch) {
+  constexpr std::string_view MIDDLEGAME = "r3k2r/pppq1ppp/2n2n2/3pp3/1b2P3/2NP1N2/PPP2PPP/R1BQK2R w KQkq - 4 8";
+  auto search = [](const SearchOptions& options, std::string_view fen, int depth) {
+    Engine e;
+    e.set_search_options(options);
+    e.set_position(Board{fen});
+    Limits l;
+    l.depth = depth;
+    e.go(l);
+    return e.wait();
+  };
+  SearchOptions off{false, false, false, false};
+
+  for (const SearchOptions& options : {SearchOptions{}, off}) {
+    auto res = search(options, MATE_IN_1, 3);
+    ASSERT_TRUE(res.best.has_value());
+    EXPECT_EQ(*res.best, (Move{{"a1"}, {"a8"}}));
+    EXPECT_EQ(res.score, MATE - 1);
+    EXPECT_EQ(*search(options, HANGING_QUEEN, 4).best, (Move{{"d2"}, {"d5"}}));
+  }
+  EXPECT_LT(search({}, MIDDLEGAME, 5).nodes, search(off, MIDDLEGAME, 5).nodes);
+}
+
+TEST(ENGINE, AspirationAndPv) {
+  // smothered mate in 4, the score jumps from material to mate once the search sees it
+  Engine e;
+  e.set_position(Board{"r6k/6pp/8/6N1/2Q5/8/6PP/6K1 w - - 0 1"});
+  MovesT pv;
+  e.set_info_callback([&pv](const SearchInfo& info) { pv = info.pv; });
+  Limits l;
+  l.depth = 8;
+  e.go(l);
+  auto res = e.wait();
+
+  EXPECT_EQ(res.score, MATE - 7);
+  EXPECT_GT(res.stats.aspiration_fail_highs, 0);
+  EXPECT_EQ(res.stats.iterations, res.depth);
+  EXPECT_GT(res.stats.cutoffs, res.stats.first_move_cutoffs);
+  ASSERT_EQ(pv.size(), 7);
+  EXPECT_EQ(pv.front(), (Move{{"g5"}, {"f7"}}));
+  EXPECT_EQ(pv.back(), (Move{{"h6"}, {"f7"}}));
+  EXPECT_EQ(res.ponder, pv[1]);
+}
+
+TEST(ENGINE, MultiPv) {
+  Board board{"4k3/8/8/3q4/8/8/3R4/4K3 w - - 0 1"};
+  Engine e;
+  std::vector<size_t> ranks;
+  e.set_info_callback([&ranks](const SearchInfo& info) { ranks.push_back(info.multipv); });
+  Limits l;
+  l.depth = 5;
+  auto single = e.analyse(board, l);
+  ASSERT_EQ(single.lines.size(), 1);
+  EXPECT_EQ(single.lines[0].move, *single.best);
+
+  e.new_game();
+  ranks.clear();
+  l.multipv = 4;
+  auto res = e.analyse(board, l);
+  ASSERT_EQ(res.lines.size(), 4);
+  EXPECT_EQ(res.best, (Move{{"d2"}, {"d5"}}));
+  EXPECT_EQ(res.lines[0].move, *res.best);
+  EXPECT_EQ(res.lines[0].score, res.score);
+  for (size_t i = 0; i < res.lines.size(); ++i) {
+    EXPECT_EQ(res.lines[i].pv.front(), res.lines[i].move);
+    for (size_t j = 0; j < i; ++j) EXPECT_FALSE(res.lines[i].move == res.lines[j].move);
+    if (i > 0) {
+      EXPECT_LE(res.lines[i].score, res.lines[i - 1].score);
+    }
+  }
+  // the rook is lost in the other lines
+  EXPECT_LT(res.lines[1].score, res.score - 400);
+  // every line of every depth is reported
+  EXPECT_EQ(ranks.size(), 4 * 5);
+  EXPECT_EQ(ranks.back(), 4);
+
+  // the same lines one search each, every one without the moves found before
+  Limits separate = l;
+  separate.multipv = 1;
+  MovesT all;
+  generate_moves(board, all);
+  separate.searchmoves.assign(all.begin(), all.end());
+  uint64_t separate_nodes = 0;
+  for (const PvLine& line : res.lines) {
+    e.new_game();
+    auto r = e.analyse(board, separate);
+    EXPECT_EQ(r.best, line.move);
+    separate_nodes += r.nodes;
+    separate.searchmoves.erase(std::find(separate.searchmoves.begin(), separate.searchmoves.end(), line.move));
+  }
+  // the later lines reuse the hash and the ordering of the first
+  EXPECT_LT(res.nodes, separate_nodes);
+
+  // no more lines than moves
+  l.multipv = 10;
+  EXPECT_EQ(e.analyse(Board{"7k/8/8/8/8/8/8/K7 w - - 0 1"}, l).lines.size(), 3);
+}
+
+TEST(ENGINE, SearchMultiThreaded) {
+  Engine e(4);
+  e.set_position(Board{MATE_IN_1});
+  Limits l;
+  l.depth = 3;
+  e.go(l);
+  auto res = e.wait();
+  ASSERT_TRUE(res.best.has_value());
+  EXPECT_EQ(*res.best, (Move{{"a1"}, {"a8"}}));
+}
+
+TEST(ENGINE, NoLegalMove) {
+  Engine e;
+  e.set_position(Board{"R5k1/5ppp/8/8/8/8/8/6K1 b"});
+  e.go({});
+  EXPECT_FALSE(e.wait().best.has_value());
+}
+
+TEST(ENGINE, PonderWaitsForPonderhit) {
+  Engine e;
+  e.set_position(Board{HANGING_QUEEN});
+  Limits l;
+  l.depth = 1;
+  l.ponder = true;
+  e.go(l);
+
+  // depth 1 is done quickly, but no result until the ponderhit
+  std::this_thread::sleep_for(100ms);
+  EXPECT_TRUE(e.is_searching());
+
+  e.ponderhit();
+  auto res = e.wait();
+  EXPECT_FALSE(e.is_searching());
+  ASSERT_TRUE(res.best.has_value());
+  EXPECT_EQ(*res.best, (Move{{"d2"}, {"d5"}}));
+}
+
+TEST(ENGINE, StopInfinite) {
+  Engine e;
+  e.set_position(Board{"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq"});
+  Limits l;
+  l.infinite = true;
+  e.go(l);
+  std::this_thread::sleep_for(50ms);
+  EXPECT_TRUE(e.is_searching());
+  e.stop();
+  EXPECT_TRUE(e.wait().best.has_value());
+}
+
+TEST(ENGINE, ClockLimits) {
+  Engine e;
+  e.set_position(Board{"r3k2r/pppq1ppp/2n2n2/3pp3/1b2P3/2NP1N2/PPP2PPP/R1BQK2R w KQkq - 4 8"});
+  Limits l;
+  l.time = 1030ms;
+  l.movestogo = 10;
+  auto start = ClockT::now();
+  e.go(l);
+  auto res = e.wait();
+  // 100 ms planned, at most 400 ms
+  EXPECT_LT(ClockT::now() - start, 450ms);
+  EXPECT_TRUE(res.best.has_value());
+  EXPECT_GT(res.depth, 0);
+}
+
+TEST(ENGINE, HashKeptAcrossMoves) {
+  Engine e;
+  Board b{HANGING_QUEEN};
+  zobrist::KeyT key = zobrist::compute(b.get_state());
+  Limits l;
+  l.depth = 2;
+
+  e.set_position(b);
+  e.go(l);
+  e.wait();
+  EXPECT_TRUE(e.tt().probe(key).has_value());
+
+  // next move of the same game still sees the entries
+  b.move({{"d2"}, {"d5"}});
+  e.set_position(b);
+  e.go(l);
+  e.wait();
+  EXPECT_TRUE(e.tt().probe(key).has_value());
+
+  e.new_game();
+  EXPECT_FALSE(e.tt().probe(key).has_value());
+}
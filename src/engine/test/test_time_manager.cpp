@@ -0,0 +1,114 @@
+#include <gtest/gtest.h>
+
+#include "src/engine/time_manager.hpp"
+
+using namespace dwc;
+using namespace dwc::engine;
+using namespace std::chrono_literals;
+
+namespace {
+// moves only when told to
+struct FakeClock {
+  ClockT::time_point now{};
+  void advance(std::chrono::milliseconds d) { now += d; }
+};
+
+class TimeManagerTest : public ::testing::Test {
+ protected:
+  FakeClock clock_;
+  TimeManager tm_{[this] { return clock_.now; }};
+  const Move e4_{{"e2"}, {"e4"}};
+  const Move d4_{{"d2"}, {"d4"}};
+};
+}  // namespace
+
+TEST_F(TimeManagerTest, Unlimited) {
+  tm_.start({});
+  clock_.advance(1000h);
+  EXPECT_FALSE(tm_.soft_limit_reached());
+  EXPECT_FALSE(tm_.hard_limit_reached());
+  EXPECT_FALSE(tm_.scaled_soft_limit().has_value());
+}
+
+TEST_F(TimeManagerTest, MoveTime) {
+  tm_.start({1000ms});
+  EXPECT_EQ(tm_.soft_limit(), 500ms);
+  EXPECT_EQ(tm_.hard_limit(), 1000ms);
+  // used exactly, the search doesn't change it
+  for (int i = 0; i < 5; ++i) tm_.on_iteration(e4_, 0);
+  EXPECT_EQ(tm_.scaled_soft_limit(), 500ms);
+
+  clock_.advance(499ms);
+  EXPECT_FALSE(tm_.soft_limit_reached());
+  clock_.advance(1ms);
+  EXPECT_TRUE(tm_.soft_limit_reached());
+  EXPECT_FALSE(tm_.hard_limit_reached());
+  clock_.advance(500ms);
+  EXPECT_TRUE(tm_.hard_limit_reached());
+}
+
+TEST_F(TimeManagerTest, Clock) {
+  // sudden death: a share of the remaining time, plus most of the increment
+  tm_.start({std::nullopt, 60030ms, 1000ms});
+  EXPECT_EQ(tm_.soft_limit(), 60000ms / TimeManager::DEFAULT_MOVES_TO_GO + 750ms);
+  EXPECT_EQ(tm_.hard_limit(), 4 * *tm_.soft_limit());
+
+  // the last move before the time control may use all but the overhead
+  tm_.start({std::nullopt, 10030ms, 0ms, 1});
+  EXPECT_EQ(tm_.soft_limit(), 10000ms);
+  EXPECT_EQ(tm_.hard_limit(), 10000ms);
+
+  // otherwise at most half of it
+  tm_.start({std::nullopt, 10030ms, 0ms, 2});
+  EXPECT_EQ(tm_.hard_limit(), 5000ms);
+
+  // less than the overhead left still makes a move
+  tm_.start({std::nullopt, 10ms});
+  EXPECT_EQ(tm_.hard_limit(), 1ms);
+}
+
+TEST_F(TimeManagerTest, Stability) {
+  tm_.start({std::nullopt, 30030ms, 0ms, 10});
+  ASSERT_EQ(tm_.soft_limit(), 3000ms);
+
+  // a best move that keeps changing gets more time
+  tm_.on_iteration(e4_, 0);
+  tm_.on_iteration(d4_, 0);
+  EXPECT_GT(*tm_.scaled_soft_limit(), 3000ms);
+
+  // a stable one less
+  for (int i = 0; i < 5; ++i) tm_.on_iteration(d4_, 0);
+  auto stable = *tm_.scaled_soft_limit();
+  EXPECT_LT(stable, 3000ms);
+
+  clock_.advance(stable);
+  EXPECT_TRUE(tm_.soft_limit_reached());
+}
+
+TEST_F(TimeManagerTest, ScoreDrop) {
+  tm_.start({std::nullopt, 30030ms, 0ms, 10});
+  for (int i = 0; i < 5; ++i) tm_.on_iteration(e4_, 50);
+  auto stable = *tm_.scaled_soft_limit();
+
+  tm_.on_iteration(e4_, 0);
+  auto small_drop = *tm_.scaled_soft_limit();
+  EXPECT_GT(small_drop, stable);
+
+  tm_.on_iteration(e4_, -100);
+  EXPECT_GT(*tm_.scaled_soft_limit(), small_drop);
+  // never past the hard limit
+  EXPECT_LE(*tm_.scaled_soft_limit(), *tm_.hard_limit());
+
+  // a new search forgets the adjustments
+  tm_.start({std::nullopt, 30030ms, 0ms, 10});
+  EXPECT_EQ(tm_.scaled_soft_limit(), 3000ms);
+}
+
+TEST_F(TimeManagerTest, Restart) {
+  tm_.start({1000ms});
+  clock_.advance(800ms);
+  tm_.restart();
+  EXPECT_EQ(tm_.elapsed(), 0ms);
+  clock_.advance(999ms);
+  EXPECT_FALSE(tm_.hard_limit_reached());
+}
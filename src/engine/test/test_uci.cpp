@@ -0,0 +1,95 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <sstream>
+#include <thread>
+
+#include "src/engine/uci.hpp"
+
+using namespace dwc;
+using namespace dwc::engine;
+using namespace std::chrono_literals;
+
+namespace {
+bool has(const std::ostringstream& out, std::string_view str) {
+  return out.str().find(str) != std::string::npos;
+}
+}  // namespace
+
+TEST(UCI, Handshake) {
+  std::ostringstream out;
+  Uci uci(out);
+  EXPECT_TRUE(uci.handle("uci"));
+  EXPECT_TRUE(has(out, "id name"));
+  EXPECT_TRUE(has(out, "option name Ponder"));
+  EXPECT_TRUE(has(out, "option name NullMove type check default true"));
+  EXPECT_TRUE(has(out, "uciok"));
+
+  EXPECT_TRUE(uci.handle("isready"));
+  EXPECT_TRUE(has(out, "readyok"));
+
+  EXPECT_FALSE(uci.handle("quit"));
+}
+
+TEST(UCI, PositionAndGo) {
+  std::ostringstream out;
+  Uci uci(out);
+  uci.handle("setoption name Threads value 2");
+  uci.handle("setoption name Hash value 4");
+  uci.handle("setoption name NullMove value false");
+  uci.handle("ucinewgame");
+  uci.handle("position fen 4k3/8/8/3q4/8/8/3R4/4K3 w - - 0 1");
+  uci.handle("go depth 1");
+  uci.wait();
+  EXPECT_TRUE(has(out, "info depth 1"));
+  EXPECT_TRUE(has(out, "bestmove d2d5"));
+
+  uci.handle("position startpos moves e2e4 e7e5 g1f3");
+  uci.handle("go depth 1");
+  uci.wait();
+  EXPECT_FALSE(has(out, "error"));
+
+  uci.handle("position startpos moves e2e5");
+  EXPECT_TRUE(has(out, "info string error"));
+}
+
+TEST(UCI, MultiPv) {
+  std::ostringstream out;
+  Uci uci(out);
+  uci.handle("uci");
+  EXPECT_TRUE(has(out, "option name MultiPV type spin default 1"));
+  uci.handle("setoption name MultiPV value 3");
+  uci.handle("position startpos");
+  uci.handle("go depth 2");
+  uci.wait();
+  EXPECT_TRUE(has(out, "info depth 2 multipv 1 "));
+  EXPECT_TRUE(has(out, "info depth 2 multipv 3 "));
+  EXPECT_FALSE(has(out, "multipv 4"));
+  EXPECT_TRUE(has(out, "bestmove "));
+}
+
+TEST(UCI, PonderHit) {
+  std::ostringstream out;
+  Uci uci(out);
+  uci.handle("position fen 6k1/5ppp/8/8/8/8/8/R5K1 w");
+  uci.handle("go ponder depth 3");
+  std::this_thread::sleep_for(100ms);
+  uci.handle("isready");
+  EXPECT_FALSE(has(out, "bestmove"));
+
+  uci.handle("ponderhit");
+  uci.wait();
+  EXPECT_TRUE(has(out, "score mate 1"));
+  EXPECT_TRUE(has(out, "bestmove a1a8"));
+}
+
+TEST(UCI, PonderStop) {
+  std::ostringstream out;
+  Uci uci(out);
+  uci.handle("position startpos");
+  uci.handle("go ponder wtime 1000 btime 1000");
+  std::this_thread::sleep_for(50ms);
+  uci.handle("stop");
+  uci.wait();
+  EXPECT_TRUE(has(out, "bestmove "));
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace dwc::engine {
+
+// Persistent worker threads, each owning a SCRATCH object that stays warm between jobs.
+// run() hands the same job to every worker, so the threads are created once per engine instead of once per move.
+template <typename SCRATCH>
+class ThreadPool {
+ public:
+  using JobT = std::function<void(size_t idx, SCRATCH& scratch)>;
+
+ private:
+  std::vector<std::thread> threads_;
+  std::vector<std::unique_ptr<SCRATCH>> scratch_;
+
+  std::mutex m_;
+  std::condition_variable cv_job_;
+  std::condition_variable cv_done_;
+  JobT job_;
+  uint64_t job_id_{0};
+  size_t running_{0};
+  bool quit_{false};
+
+  void worker(size_t idx, uint64_t seen_job) {
+    while (true) {
+      JobT job;
+      {
+        std::unique_lock lk(m_);
+        cv_job_.wait(lk, [&] { return quit_ || job_id_ != seen_job; });
+        if (quit_) return;
+        seen_job = job_id_;
+        job = job_;
+      }
+      job(idx, *scratch_[idx]);
+      {
+        std::lock_guard lk(m_);
+        if (--running_ == 0) cv_done_.notify_all();
+      }
+    }
+  }
+
+  void start(size_t n) {
+    while (scratch_.size() < n) scratch_.emplace_back(std::make_unique<SCRATCH>());
+    scratch_.resize(n);
+    quit_ = false;
+    // new threads must not pick up the job that ran before they existed
+    for (size_t i = 0; i < n; ++i) threads_.emplace_back(&ThreadPool::worker, this, i, job_id_);
+  }
+
+  void join() {
+    wait();
+    {
+      std::lock_guard lk(m_);
+      quit_ = true;
+    }
+    cv_job_.notify_all();
+    for (auto& t : threads_) t.join();
+    threads_.clear();
+  }
+
+ public:
+  explicit ThreadPool(size_t n = 1) { start(n == 0 ? 1 : n); }
+  ~ThreadPool() { join(); }
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  size_t size() const { return threads_.size(); }
+
+  // only valid while no job is running
+  SCRATCH& scratch(size_t idx) { return *scratch_[idx]; }
+
+  // existing threads keep their scratch, new ones start cold
+  void resize(size_t n) {
+    if (n == 0) n = 1;
+    if (n == size()) return;
+    join();
+    start(n);
+  }
+
+  // dispatch job to all threads and return immediately
+  void run(JobT job) {
+    wait();
+    {
+      std::lock_guard lk(m_);
+      job_ = std::move(job);
+      running_ = threads_.size();
+      ++job_id_;
+    }
+    cv_job_.notify_all();
+  }
+
+  void wait() {
+    std::unique_lock lk(m_);
+    cv_done_.wait(lk, [&] { return running_ == 0; });
+  }
+
+  bool is_running() {
+    std::lock_guard lk(m_);
+    return running_ != 0;
+  }
+};
+
+}  // namespace dwc::engine
@@ -0,0 +1,80 @@
+#include "time_manager.hpp"
+
+#include <algorithm>
+#include <array>
+
+namespace dwc::engine {
+namespace {
+using std::chrono::milliseconds;
+
+// the hard limit allows this many times the planned time, for iterations that need more
+constexpr int HARD_RATIO = 4;
+
+// by iterations in a row with the same best move
+constexpr std::array<double, 5> STABILITY_SCALE{1.4, 1.2, 1.0, 0.85, 0.7};
+
+// score drops since the last iteration, in centipawns, and the extra time they buy
+constexpr int SMALL_DROP = 30;
+constexpr int LARGE_DROP = 80;
+constexpr double SMALL_DROP_SCALE = 1.25;
+constexpr double LARGE_DROP_SCALE = 1.5;
+}  // namespace
+
+void TimeManager::start(const TimeControl& tc) {
+  soft_.reset();
+  hard_.reset();
+  adjustable_ = false;
+  scale_ = 1.0;
+  last_best_.reset();
+  last_score_.reset();
+  stable_iterations_ = 0;
+
+  if (tc.movetime.has_value()) {
+    // no iteration is started past half of it, the next one would hardly finish
+    hard_ = *tc.movetime;
+    soft_ = *tc.movetime / 2;
+  } else if (tc.remaining.has_value()) {
+    milliseconds available = std::max(milliseconds{1}, *tc.remaining - MOVE_OVERHEAD);
+    int moves = std::max(1, tc.movestogo.value_or(DEFAULT_MOVES_TO_GO));
+    milliseconds planned = available / moves + tc.inc * 3 / 4;
+    // the last move before the time control may use everything, otherwise some is kept for the moves after
+    milliseconds cap = moves == 1 ? available : available / 2;
+    hard_ = std::max(milliseconds{1}, std::min(planned * HARD_RATIO, cap));
+    soft_ = std::min(planned, *hard_);
+    adjustable_ = true;
+  }
+  restart();
+}
+
+milliseconds TimeManager::elapsed() const {
+  auto start = ClockT::time_point{ClockT::duration{start_.load()}};
+  return std::chrono::duration_cast<milliseconds>(now_() - start);
+}
+
+std::optional<milliseconds> TimeManager::scaled_soft_limit() const {
+  if (!soft_.has_value()) return std::nullopt;
+  auto scaled = milliseconds{static_cast<milliseconds::rep>(soft_->count() * scale_)};
+  return std::min(scaled, *hard_);
+}
+
+void TimeManager::on_iteration(Move best, int score) {
+  stable_iterations_ = last_best_.has_value() && *last_best_ == best ? stable_iterations_ + 1 : 0;
+  if (adjustable_) {
+    scale_ = STABILITY_SCALE[std::min<size_t>(stable_iterations_, STABILITY_SCALE.size() - 1)];
+    int drop = last_score_.has_value() ? *last_score_ - score : 0;
+    if (drop >= LARGE_DROP) {
+      scale_ *= LARGE_DROP_SCALE;
+    } else if (drop >= SMALL_DROP) {
+      scale_ *= SMALL_DROP_SCALE;
+    }
+  }
+  last_best_ = best;
+  last_score_ = score;
+}
+
+bool TimeManager::soft_limit_reached() const {
+  auto limit = scaled_soft_limit();
+  return limit.has_value() && elapsed() >= *limit;
+}
+
+}  // namespace dwc::engine
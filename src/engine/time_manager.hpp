@@ -0,0 +1,69 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <optional>
+
+#include "src/framework/basic_types.hpp"
+
+namespace dwc::engine {
+
+using ClockT = std::chrono::steady_clock;
+
+// what "go" says about the time of the side to move
+struct TimeControl {
+  std::optional<std::chrono::milliseconds> movetime;   // exactly this long
+  std::optional<std::chrono::milliseconds> remaining;  // on the own clock
+  std::chrono::milliseconds inc{0};
+  std::optional<int> movestogo;  // until the next time control, sudden death if unset
+};
+
+// Decides how long one search may take. The soft limit is checked between iterations and scaled by how the search
+// goes: a best move that keeps changing or a dropping score buys more time, a stable one less. The hard limit is
+// polled while searching and never scaled. Without a time control both are unlimited.
+class TimeManager {
+ public:
+  using NowFnT = std::function<ClockT::time_point()>;
+
+  // kept on the clock for communication latency
+  static constexpr std::chrono::milliseconds MOVE_OVERHEAD{30};
+  static constexpr int DEFAULT_MOVES_TO_GO = 30;
+
+ private:
+  NowFnT now_;
+  std::atomic<ClockT::rep> start_{0};
+  std::optional<std::chrono::milliseconds> soft_;
+  std::optional<std::chrono::milliseconds> hard_;
+  bool adjustable_{false};  // a movetime is used exactly
+  double scale_{1.0};
+  std::optional<Move> last_best_;
+  std::optional<int> last_score_;
+  int stable_iterations_{0};
+
+ public:
+  // the clock is injectable, so tests don't have to wait
+  explicit TimeManager(NowFnT now = ClockT::now) : now_(std::move(now)) { restart(); }
+
+  // computes the limits and starts the clock
+  void start(const TimeControl& tc);
+  // the clock starts over, limits stay (ponderhit)
+  void restart() { start_ = now_().time_since_epoch().count(); }
+
+  std::chrono::milliseconds elapsed() const;
+
+  // unscaled, nullopt if unlimited
+  std::optional<std::chrono::milliseconds> soft_limit() const { return soft_; }
+  std::optional<std::chrono::milliseconds> hard_limit() const { return hard_; }
+  // soft limit with the adjustments so far
+  std::optional<std::chrono::milliseconds> scaled_soft_limit() const;
+
+  // after every finished iteration, by the main thread
+  void on_iteration(Move best, int score);
+  // no new iteration should be started
+  bool soft_limit_reached() const;
+  // the search has to stop now
+  bool hard_limit_reached() const { return hard_.has_value() && elapsed() >= *hard_; }
+};
+
+}  // namespace dwc::engine
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <optional>
+
+#include "src/framework/basic_types.hpp"
+#include "src/framework/zobrist.hpp"
+
+namespace dwc::engine {
+
+enum class Bound : uint8_t {
+  NONE,
+  UPPER,
+  LOWER,
+  EXACT,
+};
+
+struct TTEntry {
+  std::optional<Move> move;
+  int score;
+  int depth;
+  Bound bound;
+};
+
+namespace _inner {
+// 16 bits: from (6) | to (6) | valid flag
+constexpr uint64_t encode_move(std::optional<Move> move) {
+  if (!move.has_value()) return 0;
+  return move->fr.index() | (move->to.index() << 6) | (1 << 12);
+}
+
+constexpr std::optional<Move> decode_move(uint64_t v) {
+  if (!(v & (1 << 12))) return std::nullopt;
+  return Move{Pos::from_index(v & 0x3F), Pos::from_index((v >> 6) & 0x3F)};
+}
+}  // namespace _inner
+
+// Shared by all search threads and kept across moves of a game, only cleared on new game.
+// Lockless: each slot stores key ^ data, so a torn write from a concurrent store reads as a miss.
+class TranspositionTable {
+  struct Slot {
+    std::atomic<uint64_t> key_xor_data{0};
+    std::atomic<uint64_t> data{0};
+  };
+
+  // data layout: move (16) | score (16) | depth (8) | bound (8) | generation (8)
+  static constexpr uint64_t pack(std::optional<Move> move, int score, int depth, Bound bound, uint8_t gen) {
+    return _inner::encode_move(move) | (static_cast<uint64_t>(static_cast<uint16_t>(score)) << 16) |
+           (static_cast<uint64_t>(static_cast<uint8_t>(depth)) << 32) | (static_cast<uint64_t>(bound) << 40) |
+           (static_cast<uint64_t>(gen) << 48);
+  }
+  static constexpr int depth_of(uint64_t data) { return static_cast<uint8_t>(data >> 32); }
+  static constexpr uint8_t gen_of(uint64_t data) { return static_cast<uint8_t>(data >> 48); }
+
+  std::unique_ptr<Slot[]> slots_;
+  size_t mask_{0};
+  uint8_t generation_{0};
+
+ public:
+  explicit TranspositionTable(size_t mb = 16) { resize(mb); }
+
+  // rounds down to a power of two number of slots, drops all entries
+  void resize(size_t mb) {
+    size_t count = 1;
+    while (count * 2 * sizeof(Slot) <= mb * 1024 * 1024) count *= 2;
+    slots_ = std::make_unique<Slot[]>(count);
+    mask_ = count - 1;
+  }
+
+  void clear() {
+    for (size_t i = 0; i <= mask_; ++i) {
+      slots_[i].key_xor_data.store(0, std::memory_order_relaxed);
+      slots_[i].data.store(0, std::memory_order_relaxed);
+    }
+    generation_ = 0;
+  }
+
+  // entries from older searches become preferred replacement victims
+  void new_search() { ++generation_; }
+
+  size_t size() const { return mask_ + 1; }
+
+  std::optional<TTEntry> probe(zobrist::KeyT key) const {
+    const Slot& s = slots_[key & mask_];
+    uint64_t data = s.data.load(std::memory_order_relaxed);
+    uint64_t kxd = s.key_xor_data.load(std::memory_order_relaxed);
+    if (data == 0 || (kxd ^ data) != key) return std::nullopt;
+    return TTEntry{_inner::decode_move(data), static_cast<int16_t>(data >> 16), depth_of(data),
+                   static_cast<Bound>((data >> 40) & 0xFF)};
+  }
+
+  void store(zobrist::KeyT key, std::optional<Move> move, int score, int depth, Bound bound) {
+    Slot& s = slots_[key & mask_];
+    uint64_t old = s.data.load(std::memory_order_relaxed);
+    bool same_key = (s.key_xor_data.load(std::memory_order_relaxed) ^ old) == key;
+    if (old != 0 && gen_of(old) == generation_ && depth < depth_of(old) && !(same_key && bound == Bound::EXACT)) {
+      return;
+    }
+    // keep the known best move if this store has none
+    if (!move.has_value() && same_key) move = _inner::decode_move(old);
+    uint64_t data = pack(move, score, depth, bound, generation_);
+    s.data.store(data, std::memory_order_relaxed);
+    s.key_xor_data.store(key ^ data, std::memory_order_relaxed);
+  }
+
+  // permille of the first 1000 slots used by the current search, as reported by UCI
+  int hashfull() const {
+    size_t n = std::min<size_t>(1000, size());
+    size_t used = 0;
+    for (size_t i = 0; i < n; ++i) {
+      uint64_t data = slots_[i].data.load(std::memory_order_relaxed);
+      if (data != 0 && gen_of(data) == generation_) ++used;
+    }
+    return static_cast<int>(used * 1000 / n);
+  }
+};
+
+}  // namespace dwc::engine
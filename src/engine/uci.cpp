@@ -0,0 +1,208 @@
+#include "uci.hpp"
+
+#include <cstdlib>
+#include <map>
+#include <sstream>
+#include <string>
+
+namespace dwc::engine {
+namespace {
+constexpr std::string_view START_FEN = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq";
+
+Move parse_move(std::string_view str) {
+  if (str.size() != 4) throw std::runtime_error("unsupported move notation");
+  return {Pos{str.substr(0, 2)}, Pos{str.substr(2, 2)}};
+}
+
+// the check options switching search features
+const std::map<std::string, bool SearchOptions::*> SEARCH_OPTIONS{
+    {"NullMove", &SearchOptions::null_move},
+    {"LateMoveReductions", &SearchOptions::late_move_reductions},
+    {"Futility", &SearchOptions::futility},
+    {"CheckExtensions", &SearchOptions::check_extensions},
+};
+
+std::string format_score(int score) {
+  if (std::abs(score) < MATE_BOUND) return "cp " + std::to_string(score);
+  int moves = (MATE - std::abs(score) + 1) / 2;
+  return "mate " + std::to_string(score > 0 ? moves : -moves);
+}
+
+std::optional<uint64_t> to_number(const utils::StringVecT& tokens, size_t idx) {
+  if (idx >= tokens.size()) return std::nullopt;
+  return std::strtoull(std::string{tokens[idx]}.c_str(), nullptr, 10);
+}
+}  // namespace
+
+Uci::Uci(std::ostream& out, size_t threads, size_t hash_mb) : engine_(threads, hash_mb), out_(out) {
+  board_.reset_position();
+
+  engine_.set_info_callback([this](const SearchInfo& info) {
+    std::ostringstream oss;
+    oss << "info depth " << info.depth << " multipv " << info.multipv << " score " << format_score(info.score)
+        << " nodes " << info.nodes << " time " << info.time.count() << " hashfull " << engine_.tt().hashfull()
+        << " pv";
+    char buf[UCI_MAX];
+    for (const auto& m : info.pv) oss.put(' ').write(buf, write_uci(m, buf) - buf);
+    send(oss.str());
+  });
+
+  engine_.set_bestmove_callback([this](const SearchResult& res) {
+    std::string line = "bestmove " + (res.best.has_value() ? to_uci(*res.best) : std::string{"0000"});
+    if (res.ponder.has_value()) line += " ponder " + to_uci(*res.ponder);
+    send(line);
+  });
+}
+
+void Uci::send(std::string_view line) {
+  std::lock_guard lk(out_m_);
+  out_ << line << std::endl;
+}
+
+void Uci::cmd_uci() {
+  send("id name dw_chess");
+  send("id author dannywi");
+  send("option name Hash type spin default 16 min 1 max 65536");
+  send("option name Threads type spin default 1 min 1 max 256");
+  send("option name Ponder type check default false");
+  send("option name MultiPV type spin default 1 min 1 max 256");
+  for (const auto& [name, member] : SEARCH_OPTIONS) send("option name " + name + " type check default true");
+  send("uciok");
+}
+
+void Uci::cmd_setoption(const utils::StringVecT& tokens) {
+  // setoption name <id> [value <x>]
+  std::string name;
+  std::string value;
+  std::string* curr = nullptr;
+  for (size_t i = 1; i < tokens.size(); ++i) {
+    if (tokens[i] == "name") {
+      curr = &name;
+    } else if (tokens[i] == "value") {
+      curr = &value;
+    } else if (curr != nullptr) {
+      if (!curr->empty()) *curr += " ";
+      *curr += tokens[i];
+    }
+  }
+
+  if (name == "Hash") {
+    engine_.set_hash_size(std::max(1, std::atoi(value.c_str())));
+  } else if (name == "Threads") {
+    engine_.set_threads(std::max(1, std::atoi(value.c_str())));
+  } else if (name == "MultiPV") {
+    multipv_ = std::max(1, std::atoi(value.c_str()));
+  } else if (auto it = SEARCH_OPTIONS.find(name); it != SEARCH_OPTIONS.end()) {
+    SearchOptions options = engine_.search_options();
+    options.*(it->second) = value == "true";
+    engine_.set_search_options(options);
+  }
+  // Ponder only tells us the GUI may send "go ponder", nothing to set up
+}
+
+void Uci::cmd_position(const utils::StringVecT& tokens) {
+  // position [startpos | fen <fen>] [moves <m1> ... <mn>]
+  auto moves_it = std::find(tokens.begin(), tokens.end(), "moves");
+  Board board;
+  if (tokens.size() >= 2 && tokens[1] == "startpos") {
+    board = Board{START_FEN};
+  } else if (tokens.size() >= 3 && tokens[1] == "fen") {
+    std::string fen;
+    for (auto it = tokens.begin() + 2; it != moves_it; ++it) fen += std::string{*it} + " ";
+    board = Board{fen};
+  } else {
+    throw std::runtime_error("invalid position command");
+  }
+
+  if (moves_it != tokens.end()) {
+    for (auto it = moves_it + 1; it != tokens.end(); ++it) board.move(parse_move(*it));
+  }
+  board_ = board;
+  engine_.set_position(board_);
+}
+
+void Uci::cmd_go(const utils::StringVecT& tokens) {
+  Limits limits;
+  limits.multipv = multipv_;
+  std::optional<uint64_t> time[cast_t(Side::SIZE)];
+  std::optional<uint64_t> inc[cast_t(Side::SIZE)];
+
+  for (size_t i = 1; i < tokens.size(); ++i) {
+    std::string_view t = tokens[i];
+    if (t == "ponder") {
+      limits.ponder = true;
+    } else if (t == "infinite") {
+      limits.infinite = true;
+    } else if (t == "depth") {
+      if (auto v = to_number(tokens, ++i)) limits.depth = static_cast<int>(*v);
+    } else if (t == "nodes") {
+      limits.nodes = to_number(tokens, ++i);
+    } else if (t == "movetime") {
+      if (auto v = to_number(tokens, ++i)) limits.movetime = std::chrono::milliseconds(*v);
+    } else if (t == "wtime") {
+      time[cast_t(Side::WHITE)] = to_number(tokens, ++i);
+    } else if (t == "btime") {
+      time[cast_t(Side::BLACK)] = to_number(tokens, ++i);
+    } else if (t == "winc") {
+      inc[cast_t(Side::WHITE)] = to_number(tokens, ++i);
+    } else if (t == "binc") {
+      inc[cast_t(Side::BLACK)] = to_number(tokens, ++i);
+    } else if (t == "movestogo") {
+      if (auto v = to_number(tokens, ++i)) limits.movestogo = static_cast<int>(*v);
+    }
+  }
+
+  // the engine's time manager only gets the own clock
+  size_t side = cast_t(board_.get_state().turn.value_or(Side::WHITE));
+  if (time[side].has_value()) limits.time = std::chrono::milliseconds(*time[side]);
+  limits.inc = std::chrono::milliseconds(inc[side].value_or(0));
+
+  engine_.go(limits);
+}
+
+bool Uci::handle(std::string_view line) {
+  utils::StringVecT tokens = utils::split(line, " ");
+  if (tokens.empty()) return true;
+
+  std::string_view cmd = tokens[0];
+  try {
+    if (cmd == "uci") {
+      cmd_uci();
+    } else if (cmd == "isready") {
+      send("readyok");
+    } else if (cmd == "ucinewgame") {
+      engine_.new_game();
+    } else if (cmd == "setoption") {
+      cmd_setoption(tokens);
+    } else if (cmd == "position") {
+      cmd_position(tokens);
+    } else if (cmd == "go") {
+      cmd_go(tokens);
+    } else if (cmd == "ponderhit") {
+      engine_.ponderhit();
+    } else if (cmd == "stop") {
+      engine_.stop();
+    } else if (cmd == "quit") {
+      engine_.stop();
+      engine_.wait();
+      return false;
+    } else {
+      send("info string unknown command: " + std::string{cmd});
+    }
+  } catch (const std::exception& e) {
+    send("info string error: " + std::string{e.what()});
+  }
+  return true;
+}
+
+void Uci::loop(std::istream& in) {
+  std::string line;
+  while (std::getline(in, line)) {
+    if (!line.empty() && line.back() == '\r') line.pop_back();
+    if (!handle(line)) return;
+  }
+  engine_.stop();
+  engine_.wait();
+}
+
+}  // namespace dwc::engine
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <iostream>
+#include <mutex>
+#include <string_view>
+
+#include "src/engine/engine.hpp"
+#include "src/framework/board.hpp"
+
+namespace dwc::engine {
+
+// Universal Chess Interface front end over Engine.
+// One instance serves a whole session, so threads and hash survive between "go" commands.
+class Uci {
+  Engine engine_;
+  Board board_;
+  std::ostream& out_;
+  std::mutex out_m_;
+  // lines per search, an option rather than a "go" parameter
+  size_t multipv_{1};
+
+  void send(std::string_view line);
+  void cmd_uci();
+  void cmd_setoption(const utils::StringVecT& tokens);
+  void cmd_position(const utils::StringVecT& tokens);
+  void cmd_go(const utils::StringVecT& tokens);
+
+ public:
+  explicit Uci(std::ostream& out, size_t threads = 1, size_t hash_mb = 16);
+
+  // returns false on "quit"
+  bool handle(std::string_view line);
+
+  // reads commands until "quit" or end of input
+  void loop(std::istream& in);
+
+  // blocks until the running search printed its bestmove
+  void wait() { engine_.wait(); }
+};
+
+}  // namespace dwc::engine
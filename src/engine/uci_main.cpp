@@ -0,0 +1,9 @@
+#include <iostream>
+
+#include "uci.hpp"
+
+int main() {
+  dwc::engine::Uci uci(std::cout);
+  uci.loop(std::cin);
+  return 0;
+}
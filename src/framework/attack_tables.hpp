@@ -0,0 +1,129 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include "basic_types.hpp"
+
+namespace dwc::attack {
+// one bit per square, bit index is Pos::index()
+using BitboardT = uint64_t;
+using TableT = std::array<BitboardT, 64>;
+using TablesT = std::array<TableT, cast_t(Type::SIZE) * cast_t(Side::SIZE)>;
+
+constexpr BitboardT bit(Pos pos) {
+  return BitboardT{1} << pos.index();
+}
+
+constexpr size_t popcount(BitboardT bb) {
+  return static_cast<size_t>(__builtin_popcountll(bb));
+}
+
+// index of the lowest set bit, bb must not be empty
+constexpr size_t lsb(BitboardT bb) {
+  return static_cast<size_t>(__builtin_ctzll(bb));
+}
+
+namespace _inner {
+struct Offset {
+  int file;
+  int rank;
+};
+
+constexpr std::array<Offset, 8> KNIGHT_OFFSETS{{{1, 2}, {2, 1}, {2, -1}, {1, -2}, {-1, -2}, {-2, -1}, {-2, 1}, {-1, 2}}};
+constexpr std::array<Offset, 8> KING_OFFSETS{{{0, 1}, {1, 1}, {1, 0}, {1, -1}, {0, -1}, {-1, -1}, {-1, 0}, {-1, 1}}};
+constexpr std::array<Offset, 2> WHITE_PAWN_OFFSETS{{{-1, 1}, {1, 1}}};
+constexpr std::array<Offset, 2> BLACK_PAWN_OFFSETS{{{-1, -1}, {1, -1}}};
+
+template <size_t N>
+constexpr TableT make_table(const std::array<Offset, N>& offsets) {
+  TableT table{};
+  for (size_t idx = 0; idx < 64; ++idx) {
+    int file = static_cast<int>(idx % 8);
+    int rank = static_cast<int>(idx / 8);
+    for (const auto& o : offsets) {
+      int f = file + o.file;
+      int r = rank + o.rank;
+      if (0 <= f && f < 8 && 0 <= r && r < 8) table[idx] |= BitboardT{1} << (r * 8 + f);
+    }
+  }
+  return table;
+}
+
+constexpr TablesT make_tables() {
+  TablesT tables{};
+  for (Side side : {Side::WHITE, Side::BLACK}) {
+    tables[Piece{Type::KNIGHT, side}.ordinal()] = make_table(KNIGHT_OFFSETS);
+    tables[Piece{Type::KING, side}.ordinal()] = make_table(KING_OFFSETS);
+  }
+  tables[Piece{Type::PAWN, Side::WHITE}.ordinal()] = make_table(WHITE_PAWN_OFFSETS);
+  tables[Piece{Type::PAWN, Side::BLACK}.ordinal()] = make_table(BLACK_PAWN_OFFSETS);
+  return tables;
+}
+
+constexpr std::array<Offset, 4> ROOK_DIRECTIONS{{{0, 1}, {1, 0}, {0, -1}, {-1, 0}}};
+constexpr std::array<Offset, 4> BISHOP_DIRECTIONS{{{1, 1}, {1, -1}, {-1, -1}, {-1, 1}}};
+
+template <size_t N>
+constexpr BitboardT ray_attacks(const std::array<Offset, N>& directions, Pos pos, BitboardT occupied) {
+  BitboardT res = 0;
+  for (const auto& d : directions) {
+    int f = static_cast<int>(pos.index() % 8) + d.file;
+    int r = static_cast<int>(pos.index() / 8) + d.rank;
+    for (; 0 <= f && f < 8 && 0 <= r && r < 8; f += d.file, r += d.rank) {
+      BitboardT b = BitboardT{1} << (r * 8 + f);
+      res |= b;
+      if (occupied & b) break;
+    }
+  }
+  return res;
+}
+
+constexpr size_t total_popcount(const TableT& table) {
+  size_t n = 0;
+  for (auto bb : table) n += popcount(bb);
+  return n;
+}
+}  // namespace _inner
+
+// Attacked squares of the single step pieces (knight, king, and pawn captures), indexed by Piece::ordinal() and
+// Pos::index(). Sliding pieces have empty tables.
+inline constexpr TablesT LEAPER_ATTACKS = _inner::make_tables();
+
+constexpr BitboardT attacks(Piece piece, Pos pos) {
+  return LEAPER_ATTACKS[piece.ordinal()][pos.index()];
+}
+
+// Attacked squares of a bishop, rook or queen on pos: each ray stops at the first occupied square, including it.
+// Empty for the other types.
+constexpr BitboardT slider_attacks(Type type, Pos pos, BitboardT occupied) {
+  BitboardT res = 0;
+  if (type == Type::ROOK || type == Type::QUEEN) res |= _inner::ray_attacks(_inner::ROOK_DIRECTIONS, pos, occupied);
+  if (type == Type::BISHOP || type == Type::QUEEN) res |= _inner::ray_attacks(_inner::BISHOP_DIRECTIONS, pos, occupied);
+  return res;
+}
+
+// leaper table or slider rays, whichever applies to the piece
+constexpr BitboardT attacks(Piece piece, Pos pos, BitboardT occupied) {
+  return attacks(piece, pos) | slider_attacks(piece.type, pos, occupied);
+}
+
+// well known totals over all squares
+static_assert(_inner::total_popcount(LEAPER_ATTACKS[Piece{Type::KNIGHT, Side::WHITE}.ordinal()]) == 336);
+static_assert(_inner::total_popcount(LEAPER_ATTACKS[Piece{Type::KING, Side::BLACK}.ordinal()]) == 420);
+static_assert(_inner::total_popcount(LEAPER_ATTACKS[Piece{Type::PAWN, Side::WHITE}.ordinal()]) == 98);
+static_assert(_inner::total_popcount(LEAPER_ATTACKS[Piece{Type::QUEEN, Side::WHITE}.ordinal()]) == 0);
+
+// spot checks
+static_assert(attacks({Type::KNIGHT, Side::WHITE}, Pos{"a1"}) == (bit(Pos{"b3"}) | bit(Pos{"c2"})));
+static_assert(attacks({Type::KING, Side::WHITE}, Pos{"h8"}) == (bit(Pos{"g8"}) | bit(Pos{"g7"}) | bit(Pos{"h7"})));
+static_assert(attacks({Type::PAWN, Side::WHITE}, Pos{"e4"}) == (bit(Pos{"d5"}) | bit(Pos{"f5"})));
+static_assert(attacks({Type::PAWN, Side::BLACK}, Pos{"a7"}) == bit(Pos{"b6"}));
+static_assert(attacks({Type::PAWN, Side::WHITE}, Pos{"c8"}) == 0);
+static_assert(popcount(slider_attacks(Type::ROOK, Pos{"d4"}, 0)) == 14);
+static_assert(popcount(slider_attacks(Type::QUEEN, Pos{"a1"}, 0)) == 21);
+static_assert(slider_attacks(Type::ROOK, Pos{"a1"}, bit(Pos{"a3"}) | bit(Pos{"c1"})) ==
+              (bit(Pos{"a2"}) | bit(Pos{"a3"}) | bit(Pos{"b1"}) | bit(Pos{"c1"})));
+static_assert(slider_attacks(Type::KNIGHT, Pos{"a1"}, 0) == 0);
+
+}  // namespace dwc::attack
@@ -2,8 +2,12 @@
 
 #include <array>
 #include <map>
+#include <memory_resource>
 #include <optional>
 #include <set>
+#include <string>
+#include <string_view>
+#include <vector>
 
 #include "src/shared/utils.hpp"
 
@@ -27,6 +31,15 @@ enum class Side : uint8_t {
   SIZE,
 };
 
+enum class GameStatus : uint8_t {
+  ONGOING,
+  CHECKMATE,
+  STALEMATE,
+  FIFTY_MOVE,
+  REPETITION,
+  INSUFFICIENT_MATERIAL,
+};
+
 template <typename ENUM, typename T = size_t>
 constexpr T cast_t(ENUM e) {
   return static_cast<T>(e);
@@ -56,6 +69,12 @@ struct Pos {
 
   Pos() = delete;
 
+  // square index, a1 = 0, b1 = 1, ..., h8 = 63
+  constexpr size_t index() const { return static_cast<size_t>(rank) * 8 + static_cast<size_t>(file); }
+  static constexpr Pos from_index(size_t idx) {
+    return {static_cast<FileT>(static_cast<int8_t>(idx % 8)), static_cast<RankT>(static_cast<int8_t>(idx / 8))};
+  }
+
   bool operator==(const Pos& p) const { return file == p.file && rank == p.rank; }
 
   friend std::ostream& operator<<(std::ostream& os, dwc::Pos pos) {
@@ -75,7 +94,28 @@ struct Move {
   }
 };
 
-using MovesT = std::vector<Move>;
+// square name, e.g. "e4". Writes to out and returns the end of the written chars.
+constexpr char* write_square(Pos pos, char* out) {
+  *out++ = static_cast<char>('a' + pos.index() % 8);
+  *out++ = static_cast<char>('1' + pos.index() / 8);
+  return out;
+}
+
+// buffer size write_uci needs at most, with room for a promotion piece
+constexpr size_t UCI_MAX = 5;
+
+// long algebraic move as used by UCI, e.g. "e2e4". Writes to out and returns the end of the written chars.
+constexpr char* write_uci(Move move, char* out) {
+  return write_square(move.to, write_square(move.fr, out));
+}
+
+inline std::string to_uci(Move move) {
+  char buf[UCI_MAX];
+  return {buf, write_uci(move, buf)};
+}
+
+// polymorphic, so scratch buffers can draw from a utils::Arena; default constructed ones use the heap
+using MovesT = std::pmr::vector<Move>;
 
 struct Piece {
   Type type;
@@ -94,20 +134,20 @@ struct Square {
 using BoardT = std::array<std::array<Square, 8>, 8>;
 
 namespace board_ut {
-void set(Pos pos, Piece piece, BoardT& board) {
+inline void set(Pos pos, Piece piece, BoardT& board) {
   board[pos.file][pos.rank].piece = piece;
 }
 
-void clear(Pos pos, BoardT& board) {
+inline void clear(Pos pos, BoardT& board) {
   board[pos.file][pos.rank].piece.reset();
 }
 
-std::optional<Piece> get(Pos pos, const BoardT& board) {
+inline std::optional<Piece> get(Pos pos, const BoardT& board) {
   return board[pos.file][pos.rank].piece;
 }
 }  // namespace board_ut
 
-std::map<Piece, char> getPieceCharMap() {
+inline std::map<Piece, char> getPieceCharMap() {
   std::map<Piece, char> map;
 
   map[{Type::PAWN, Side::WHITE}] = 'P';
@@ -127,7 +167,7 @@ std::map<Piece, char> getPieceCharMap() {
   return map;
 }
 
-std::map<char, Piece> getCharPieceMap() {
+inline std::map<char, Piece> getCharPieceMap() {
   std::map<Piece, char> inv = getPieceCharMap();
   std::map<char, Piece> map;
   for (auto v : inv) { map[v.second] = v.first; }
@@ -135,11 +175,95 @@ std::map<char, Piece> getCharPieceMap() {
   return map;
 }
 
+// FEN letters by Piece::ordinal(), map free for the hot parsers
+inline constexpr std::string_view PIECE_CHARS = "PpNnBbRrQqKk";
+
+constexpr char piece_char(Piece piece) {
+  return PIECE_CHARS[piece.ordinal()];
+}
+
+constexpr std::optional<Piece> piece_from_char(char c) {
+  size_t i = PIECE_CHARS.find(c);
+  if (i == std::string_view::npos) return std::nullopt;
+  return Piece{static_cast<Type>(i / 2), static_cast<Side>(i % 2)};
+}
+
+// squares of one castling right, as Pos::index()
+struct CastleInfo {
+  uint8_t king_from;
+  uint8_t king_to;
+  uint8_t rook_from;
+  uint8_t rook_to;
+  // square the castling move points to: king_to, or rook_from for chess960 where it's written as king takes own rook
+  uint8_t move_to;
+  uint64_t must_empty;  // squares that must be empty, apart from the castling king and rook
+  uint64_t must_safe;   // king start, the squares it crosses and its destination, must not be attacked
+};
+
+// Castling squares of all four rights, precomputed from the start files of the king and rooks.
+class CastlingRules {
+  std::array<CastleInfo, 4> rights_{};
+
+  static constexpr CastleInfo make_info(int8_t rank, int8_t king_file, int8_t rook_file, int8_t king_to_file,
+                                        int8_t rook_to_file, bool chess960) {
+    auto idx = [rank](int8_t file) { return static_cast<uint8_t>(rank * 8 + file); };
+    auto bit = [rank](int8_t file) { return uint64_t{1} << (rank * 8 + file); };
+    auto min = [](int8_t a, int8_t b) { return a < b ? a : b; };
+    auto max = [](int8_t a, int8_t b) { return a < b ? b : a; };
+
+    CastleInfo info{idx(king_file), idx(king_to_file), idx(rook_file), idx(rook_to_file), 0, 0, 0};
+    info.move_to = chess960 ? info.rook_from : info.king_to;
+
+    // everything the king and the rook cross or land on, except themselves
+    int8_t lo = min(min(king_file, king_to_file), min(rook_file, rook_to_file));
+    int8_t hi = max(max(king_file, king_to_file), max(rook_file, rook_to_file));
+    for (int8_t f = lo; f <= hi; ++f) info.must_empty |= bit(f);
+    info.must_empty &= ~(bit(king_file) | bit(rook_file));
+
+    // only the king's path, the rook may be attacked
+    for (int8_t f = min(king_file, king_to_file); f <= max(king_file, king_to_file); ++f) info.must_safe |= bit(f);
+    return info;
+  }
+
+ public:
+  // files are 0 (a) to 7 (h), the king has to stand between the rooks
+  static constexpr CastlingRules make(int8_t king_file, int8_t king_rook_file, int8_t queen_rook_file) {
+    if (!(0 <= queen_rook_file && queen_rook_file < king_file && king_file < king_rook_file && king_rook_file < 8)) {
+      throw std::logic_error("invalid castling files");
+    }
+    bool chess960 = !(king_file == 4 && king_rook_file == 7 && queen_rook_file == 0);
+    CastlingRules rules;
+    for (Side side : {Side::WHITE, Side::BLACK}) {
+      int8_t rank = side == Side::WHITE ? 0 : 7;
+      rules.rights_[index({Type::KING, side})] = make_info(rank, king_file, king_rook_file, 6, 5, chess960);
+      rules.rights_[index({Type::QUEEN, side})] = make_info(rank, king_file, queen_rook_file, 2, 3, chess960);
+    }
+    return rules;
+  }
+
+  // castling rights are stored as KING or QUEEN piece of the side
+  static constexpr size_t index(Piece right) {
+    return cast_t(right.side) * 2 + (right.type == Type::QUEEN ? 1 : 0);
+  }
+
+  constexpr const CastleInfo& operator[](Piece right) const { return rights_[index(right)]; }
+};
+
+inline constexpr CastlingRules STANDARD_CASTLING = CastlingRules::make(4, 7, 0);
+static_assert(STANDARD_CASTLING[{Type::KING, Side::WHITE}].must_empty == 0x60);  // f1 g1
+static_assert(STANDARD_CASTLING[{Type::QUEEN, Side::WHITE}].must_empty == 0x0e);  // b1 c1 d1
+static_assert(STANDARD_CASTLING[{Type::KING, Side::BLACK}].must_safe == 0x70ULL << 56);  // e8 f8 g8
+static_assert(STANDARD_CASTLING[{Type::QUEEN, Side::BLACK}].move_to == 58);  // c8
+
 struct State {
   BoardT board;
   std::optional<Side> turn;
   std::set<dwc::Piece> castling{
       {Type::KING, Side::WHITE}, {Type::QUEEN, Side::WHITE}, {Type::KING, Side::BLACK}, {Type::QUEEN, Side::BLACK}};
+  // plies since the last capture or pawn move, for the 50 move rule
+  uint16_t halfmove{0};
+  uint16_t fullmove{1};
+  CastlingRules castling_rules{STANDARD_CASTLING};
 };
 
 }  // namespace dwc
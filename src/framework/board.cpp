@@ -3,8 +3,24 @@
 #include <iostream>
 
 #include "legal_move.hpp"
+#include "move_gen.hpp"
+#include "mover_pipeline.hpp"
+#include "src/shared/arena.hpp"
 
 namespace dwc {
+namespace {
+constexpr std::array<Piece, 4> CASTLING_RIGHTS{
+    Piece{Type::KING, Side::WHITE}, {Type::QUEEN, Side::WHITE}, {Type::KING, Side::BLACK}, {Type::QUEEN, Side::BLACK}};
+
+uint8_t castling_bits(const std::set<Piece>& castling) {
+  uint8_t bits = 0;
+  for (size_t i = 0; i < CASTLING_RIGHTS.size(); ++i) {
+    if (castling.find(CASTLING_RIGHTS[i]) != castling.end()) bits |= 1 << i;
+  }
+  return bits;
+}
+}  // namespace
+
 void Board::check_move(Pos fr, Pos to) const {
   std::optional<Piece> piece = get(fr);
   if (!piece.has_value()) { throw std::logic_error("moving empty square"); }
@@ -18,24 +34,92 @@ void Board::check_move(Pos fr, Pos to) const {
   }
 }
 
+std::optional<Piece> Board::castling_of(Piece piece, Move move) const {
+  if (piece.type != Type::KING) return std::nullopt;
+  for (Type type : {Type::KING, Type::QUEEN}) {
+    Piece right{type, piece.side};
+    const CastleInfo& ci = state_.castling_rules[right];
+    if (move.fr.index() == ci.king_from && move.to.index() == ci.move_to && state_.castling.count(right) != 0) {
+      return right;
+    }
+  }
+  return std::nullopt;
+}
+
+bool Board::is_king_threatened_after(Move move) const {
+  auto piece = get(move.fr);
+  DWC_COUNT(BOARD_COPIES);
+  Board b_copy{state_, mailbox_, NoHistoryT{}};
+  b_copy.move_internal(move, *piece, castling_of(*piece, move));
+  return b_copy.is_king_threatened(piece->side);
+}
+
+void Board::call_movers(Pos pos, MovesT& moves) const {
+  auto piece = get(pos);
+  if (!piece.has_value()) return;
+  pipeline::Pipeline<MoverUpdaterList>::get_moves(*this, state_, *piece, pos, moves);
+}
+
+void Board::call_updaters(State& state, Piece piece, Move move) const {
+  pipeline::Pipeline<MoverUpdaterList>::update_state(state, piece, move);
+}
+
 MovesT Board::get_moves(Pos pos) const {
   MovesT moves;
-  call_movers<MoverUpdaterList>(pos, moves);
+  collect_moves(pos, moves);
+  return moves;
+}
+
+void Board::collect_moves(Pos pos, MovesT& moves) const {
+  DWC_COUNT(GET_MOVES);
+  if (is_checking_threats()) DWC_COUNT(GET_MOVES_NESTED);
+  call_movers(pos, moves);
 
   // pinned piece can still threaten castling or king, so don't check its king
   if (!is_checking_threats()) {
-    auto king_is_threatened_after = [this](const Move& move) {
-      auto piece = this->get(move.fr);
-      Side side = piece->side;
-      Board b_copy = *this;
-      b_copy.move_internal(move, *piece);
-      return b_copy.is_king_threatened(side);
-    };
+    auto king_is_threatened_after = [this](const Move& move) { return is_king_threatened_after(move); };
     auto new_end = std::remove_if(moves.begin(), moves.end(), king_is_threatened_after);
     moves.erase(new_end, moves.end());
   }
+}
 
-  return moves;
+void Board::get_pseudo_moves(Pos pos, MovesT& moves) const {
+  call_movers(pos, moves);
+}
+
+bool Board::has_legal_move() const {
+  iter::LegalMoves moves{*this};
+  return moves.begin() != moves.end();
+}
+
+bool Board::is_insufficient_material() const {
+  // bishops per square color, other minor pieces, anything else makes mate possible
+  constexpr attack::BitboardT DARK_SQUARES = 0xaa55aa55aa55aa55ULL;
+  auto both_sides = [this](Type type) {
+    return mailbox_.occupancy({type, Side::WHITE}) | mailbox_.occupancy({type, Side::BLACK});
+  };
+  attack::BitboardT bishops = both_sides(Type::BISHOP);
+  attack::BitboardT knights_bb = both_sides(Type::KNIGHT);
+  if (mailbox_.occupancy() & ~(both_sides(Type::KING) | bishops | knights_bb)) return false;
+
+  size_t knights = attack::popcount(knights_bb);
+  size_t dark = attack::popcount(bishops & DARK_SQUARES);
+  size_t light = attack::popcount(bishops & ~DARK_SQUARES);
+
+  size_t minors = knights + dark + light;
+  if (minors <= 1) return true;
+  return knights == 0 && (dark == 0 || light == 0);
+}
+
+GameStatus Board::status() const {
+  if (is_insufficient_material()) return GameStatus::INSUFFICIENT_MATERIAL;
+  if (!has_legal_move()) {
+    return is_king_threatened(state_.turn.value_or(Side::WHITE)) ? GameStatus::CHECKMATE : GameStatus::STALEMATE;
+  }
+  // a mate on the 50th move still counts, so check this after the moves
+  if (is_fifty_move_draw()) return GameStatus::FIFTY_MOVE;
+  if (is_threefold_repetition()) return GameStatus::REPETITION;
+  return GameStatus::ONGOING;
 }
 
 void Board::dump_moves(Pos pos) const {
@@ -45,10 +129,94 @@ void Board::dump_moves(Pos pos) const {
 }
 
 void Board::move(Move move) {
+  DWC_COUNT(MOVES);
+  DWC_SCOPED_TIMER(MOVE_NS);
   check_move(move.fr, move.to);
-  std::optional<Piece> piece = get(move.fr);
-  move_internal(move, piece.value());
-  call_updaters<MoverUpdaterList>(state_, move);
+  apply_move(move);
+}
+
+void Board::apply_move(Move move) {
+  Piece piece = get(move.fr).value();
+  std::optional<Piece> castled = castling_of(piece, move);
+  // a chess960 castling move points to the own rook, that's not a capture
+  std::optional<Piece> captured = castled.has_value() ? std::nullopt : get(move.to);
+  uint8_t castling_before = castling_bits(state_.castling);
+  history_.push_back(
+      {move, piece, captured, castled, state_.turn, castling_before, state_.halfmove, state_.fullmove, key_});
+
+  move_internal(move, piece, castled);
+  Move king_move = move;
+  if (castled.has_value()) {
+    const CastleInfo& ci = state_.castling_rules[*castled];
+    king_move = {move.fr, Pos::from_index(ci.king_to)};
+    Piece rook{Type::ROOK, piece.side};
+    key_ ^= zobrist::piece_key(rook, Pos::from_index(ci.rook_from));
+    key_ ^= zobrist::piece_key(rook, Pos::from_index(ci.rook_to));
+  }
+  call_updaters(state_, piece, king_move);
+
+  bool irreversible = piece.type == Type::PAWN || captured.has_value();
+  state_.halfmove = irreversible ? 0 : state_.halfmove + 1;
+  if (piece.side == Side::BLACK) ++state_.fullmove;
+
+  // incremental key update
+  key_ ^= zobrist::piece_key(piece, king_move.fr) ^ zobrist::piece_key(piece, king_move.to);
+  if (captured.has_value()) key_ ^= zobrist::piece_key(*captured, move.to);
+  key_ ^= zobrist::turn_key(history_.back().turn) ^ zobrist::turn_key(state_.turn);
+  uint8_t castling_changed = castling_before ^ castling_bits(state_.castling);
+  for (size_t i = 0; i < CASTLING_RIGHTS.size(); ++i) {
+    if (castling_changed & (1 << i)) key_ ^= zobrist::castling_key(CASTLING_RIGHTS[i]);
+  }
+}
+
+void Board::apply_null_move() {
+  // any piece and move, only the turn and counters are restored
+  Piece king{Type::KING, state_.turn.value_or(Side::WHITE)};
+  Move none{Pos::from_index(0), Pos::from_index(0)};
+  history_.push_back({none, king, std::nullopt, std::nullopt, state_.turn, castling_bits(state_.castling),
+                      state_.halfmove, state_.fullmove, key_, true});
+  // same turn change as UpdaterTurn
+  legal_move::UpdaterTurn::update_state(state_, king, none);
+  state_.halfmove = 0;
+  if (king.side == Side::BLACK) ++state_.fullmove;
+  key_ ^= zobrist::turn_key(history_.back().turn) ^ zobrist::turn_key(state_.turn);
+}
+
+void Board::undo_move() {
+  if (history_.empty()) throw std::logic_error("no move to undo");
+  const Undo& u = history_.back();
+  if (!u.null_move) {
+    if (u.castled.has_value()) {
+      const CastleInfo& ci = state_.castling_rules[*u.castled];
+      remove(Pos::from_index(ci.king_to));
+      remove(Pos::from_index(ci.rook_to));
+      put(Pos::from_index(ci.rook_from), {Type::ROOK, u.piece.side});
+    } else if (u.captured.has_value()) {
+      put(u.move.to, *u.captured);
+    } else {
+      remove(u.move.to);
+    }
+    put(u.move.fr, u.piece);
+  }
+  for (size_t i = 0; i < CASTLING_RIGHTS.size(); ++i) {
+    if (u.castling & (1 << i)) state_.castling.insert(CASTLING_RIGHTS[i]);
+  }
+  state_.turn = u.turn;
+  state_.halfmove = u.halfmove;
+  state_.fullmove = u.fullmove;
+  key_ = u.key;
+  history_.pop_back();
+}
+
+size_t Board::repetition_count() const {
+  // positions before the last irreversible move cannot repeat, and only every other ply has the same side to move
+  size_t n = history_.size();
+  size_t limit = std::min<size_t>(state_.halfmove, n);
+  size_t count = 0;
+  for (size_t i = 2; i <= limit; i += 2) {
+    if (history_[n - i].key == key_) ++count;
+  }
+  return count;
 }
 
 bool Board::is_threatened(Pos pos) const {
@@ -58,6 +226,7 @@ bool Board::is_threatened(Pos pos) const {
 }
 
 bool Board::is_threatened(Pos pos, Side side) const {
+  DWC_COUNT(THREAT_CHECKS);
   // if necessary move this to util lib with added features
   struct set_true {
     bool& b;
@@ -65,37 +234,40 @@ bool Board::is_threatened(Pos pos, Side side) const {
     ~set_true() { b = false; }
   } g{is_checking_threats_};
 
-  // todo: create an iterator, using generator coroutine if possible
-  for (char rank = '8'; rank >= '1'; --rank) {
-    for (char file = 'A'; file <= 'H'; ++file) {
-      Pos curr_pos{std::string{file, rank}};
-      if (pos == curr_pos) { continue; }
-      auto curr_pcs = get(curr_pos);
-      if (!curr_pcs.has_value() || curr_pcs->side == side) { continue; }
-      auto moves = get_moves(curr_pos);
-      for (const auto& move : moves) {
-        if (move.to == pos) { return true; }
-      }
+  // runs for every legality check, so the buffer comes from the thread's arena instead of the heap
+  utils::ArenaScope scope;
+  MovesT moves{scope.resource()};
+  moves.reserve(MAX_PIECE_MOVES);
+  Side opp = side == Side::WHITE ? Side::BLACK : Side::WHITE;
+  for (Pos curr_pos : iter::squares_of(mailbox_.occupancy(opp))) {
+    if (pos == curr_pos) { continue; }
+    moves.clear();
+    collect_moves(curr_pos, moves);
+    for (const auto& move : moves) {
+      if (move.to == pos) { return true; }
     }
   }
 
   return false;
 }
 
-bool Board::is_king_threatened(Side side) const {
-  std::optional<Pos> pos_king;
-  // todo: create an iterator, using generator coroutine if possible
-  for (char rank = '8'; rank >= '1'; --rank) {
-    for (char file = 'A'; file <= 'H'; ++file) {
-      Pos curr_pos{std::string{file, rank}};
-      auto curr_pcs = get(curr_pos);
-      if (curr_pcs.has_value() && curr_pcs->type == Type::KING && curr_pcs->side == side) {
-        pos_king = curr_pos;
-        break;
-      }
-    }
-  }
+bool Board::is_attacked(Pos pos, Side by) const {
+  // the attackers are found from pos: a piece of by attacks pos iff the same piece on pos attacks it back,
+  // except pawns which attack the other way
+  Side other = by == Side::WHITE ? Side::BLACK : Side::WHITE;
+  auto pieces = [this, by](Type type) { return mailbox_.occupancy({type, by}); };
+  if (attack::attacks({Type::PAWN, other}, pos) & pieces(Type::PAWN)) return true;
+  if (attack::attacks({Type::KNIGHT, by}, pos) & pieces(Type::KNIGHT)) return true;
+  if (attack::attacks({Type::KING, by}, pos) & pieces(Type::KING)) return true;
 
+  attack::BitboardT occupied = mailbox_.occupancy();
+  attack::BitboardT queens = pieces(Type::QUEEN);
+  if (attack::slider_attacks(Type::ROOK, pos, occupied) & (pieces(Type::ROOK) | queens)) return true;
+  return (attack::slider_attacks(Type::BISHOP, pos, occupied) & (pieces(Type::BISHOP) | queens)) != 0;
+}
+
+bool Board::is_king_threatened(Side side) const {
+  std::optional<Pos> pos_king = mailbox_.find({Type::KING, side});
   if (!pos_king.has_value()) throw std::logic_error("this side has no king on board");
 
   return is_threatened(*pos_king);
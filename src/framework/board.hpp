@@ -1,10 +1,14 @@
 #pragma once
 
 #include <optional>
+#include <vector>
 
 #include "basic_types.hpp"
 #include "fen_lib.hpp"
+#include "instrument.hpp"
+#include "mailbox.hpp"
 #include "src/shared/type_list.hpp"
+#include "zobrist.hpp"
 
 namespace dwc {
 
@@ -18,68 +22,133 @@ class MoverCastling;
 
 class Board {
  private:
+  // everything needed to take back a move
+  struct Undo {
+    Move move;
+    Piece piece;
+    std::optional<Piece> captured;
+    std::optional<Piece> castled;  // castling right used by the move
+    std::optional<Side> turn;
+    uint8_t castling;  // castling rights before the move, one bit per entry
+    uint16_t halfmove;
+    uint16_t fullmove;
+    zobrist::KeyT key;  // key of the position before the move
+    bool null_move{false};
+  };
+
   dwc::State state_;
+  // packed mirror of state_.board for fast scans, kept in sync by every board change
+  mailbox::Mailbox mailbox_;
+  zobrist::KeyT key_{0};
+  // one entry per move played, doubles as the position key history for repetition checks
+  std::vector<Undo> history_;
   mutable bool is_checking_threats_{false};
 
+  // cheap copy for checking a move, without key, history and castling rights (the std::set would allocate)
+  struct NoHistoryT {};
+  Board(const State& state, const mailbox::Mailbox& mailbox, NoHistoryT)
+      : state_{state.board, state.turn, {}, state.halfmove, state.fullmove, state.castling_rules}, mailbox_(mailbox) {}
+
   void check_move(Pos fr, Pos to) const;
+  // the castling right if the move is castling
+  std::optional<Piece> castling_of(Piece piece, Move move) const;
 
-  void move_internal(Move move, Piece piece) {
-    board_ut::clear(move.fr, state_.board);
-    board_ut::set(move.to, piece, state_.board);
+  void put(Pos pos, Piece piece) {
+    board_ut::set(pos, piece, state_.board);
+    mailbox_.set(pos, piece);
+  }
+
+  void remove(Pos pos) {
+    board_ut::clear(pos, state_.board);
+    mailbox_.clear(pos);
+  }
+
+  // castled is castling_of(piece, move), taken from the board the move was generated on
+  void move_internal(Move move, Piece piece, std::optional<Piece> castled) {
+    if (castled.has_value()) {
+      // king and rook may swap or land on each other's start square, so clear both first
+      const CastleInfo& ci = state_.castling_rules[*castled];
+      remove(Pos::from_index(ci.king_from));
+      remove(Pos::from_index(ci.rook_from));
+      put(Pos::from_index(ci.king_to), piece);
+      put(Pos::from_index(ci.rook_to), {Type::ROOK, piece.side});
+      return;
+    }
+    remove(move.fr);
+    put(move.to, piece);
   }
 
   void init(std::string_view fen_str) {
     dwc::fen::FenParser fp(fen_str);
     state_.board = fp.get_board_pos();
+    mailbox_ = mailbox::Mailbox{state_.board};
     state_.turn = fp.get_turn_side().value_or(Side::WHITE);
     state_.castling = fp.get_castling();
+    state_.halfmove = fp.get_halfmove();
+    state_.fullmove = fp.get_fullmove();
+    state_.castling_rules = STANDARD_CASTLING;
+    key_ = zobrist::compute(state_);
+    history_.clear();
   }
 
   using MoverUpdaterList = utils::type_list<legal_move::MoverBasic, legal_move::UpdaterTurn, legal_move::MoverPawnAhead,
                                             legal_move::MoverPawnTake, legal_move::MoverCastling>;
-  // todo: static check here for no duplicated types
-
-  template <typename TL>
-  void call_updaters(State& state, Move move) const {
-    auto piece = get(move.to);
-    if (!piece.has_value()) return;
-
-    using T = dwc::utils::head_t<TL>;
-    if (dwc::utils::contains(T::TargetTypes, piece->type)) { T::update_state(state, *piece, move); }
 
-    using TAIL = dwc::utils::tail_t<TL>;
-    if constexpr (dwc::utils::size_v < TAIL >> 0) call_updaters<TAIL>(state, move);
-  }
-
-  template <typename TL>
-  void call_movers(Pos pos, MovesT& moves) const {
-    auto piece = get(pos);
-    if (!piece.has_value()) return;
-
-    using T = dwc::utils::head_t<TL>;
-    if (dwc::utils::contains(T::TargetTypes, piece->type)) {
-      MovesT res = T::get_moves(*this, state_, pos);
-      moves.insert(end(moves), begin(res), end(res));
-    }
-
-    using TAIL = dwc::utils::tail_t<TL>;
-    if constexpr (dwc::utils::size_v < TAIL >> 0) call_movers<TAIL>(pos, moves);
-  }
+  // dispatch through pipeline::Pipeline<MoverUpdaterList>, defined in board.cpp where the movers are complete
+  void call_movers(Pos pos, MovesT& moves) const;
+  // get_moves() into the caller's buffer
+  void collect_moves(Pos pos, MovesT& moves) const;
+  void call_updaters(State& state, Piece piece, Move move) const;
 
  public:
-  Board() {}
+  // pseudo legal moves of one piece fit, a queen has at most 27
+  static constexpr size_t MAX_PIECE_MOVES = 32;
+
+  Board() : key_(zobrist::compute(state_)) {}
   Board(std::string_view fen_str) { init(fen_str); }
+  // position set up square by square, e.g. by a table generator, starts without history
+  explicit Board(const State& state) : state_(state), mailbox_(state.board), key_(zobrist::compute(state_)) {}
 
   std::optional<Piece> get(Pos pos) const { return board_ut::get(pos, state_.board); }
+  const State& get_state() const { return state_; }
+  const mailbox::Mailbox& get_mailbox() const { return mailbox_; }
+  zobrist::KeyT get_key() const { return key_; }
+
+  // for chess960 start positions, call after loading the position
+  void set_castling_rules(const CastlingRules& rules) { state_.castling_rules = rules; }
 
   void reset_position() { init("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq"); }
 
   void move(Move move);
+  // same as move(), but without the legality checks, only use with moves given by get_moves()
+  void apply_move(Move move);
+  // passes the turn without moving, for null move pruning; taken back by undo_move().
+  // Counts as irreversible, so no repetition is detected across it.
+  void apply_null_move();
+  // take back the last move
+  void undo_move();
+
+  // how often the current position occurred before, only looks back to the last capture or pawn move
+  size_t repetition_count() const;
+  bool is_threefold_repetition() const { return repetition_count() >= 2; }
+  bool is_fifty_move_draw() const { return state_.halfmove >= 100; }
 
   MovesT get_moves(Pos pos) const;
+  // moves of the piece on pos before dropping the ones that leave the own king in check, appended to moves
+  void get_pseudo_moves(Pos pos, MovesT& moves) const;
+  bool is_king_threatened_after(Move move) const;
+
+  // stops at the first legal move found, cheaper than get_moves on every square
+  bool has_legal_move() const;
+  // no sequence of legal moves can lead to a mate: only kings, plus a single minor piece or same colored bishops
+  bool is_insufficient_material() const;
+  // result of the game from the view of the side to move, e.g. CHECKMATE means the side to move lost
+  GameStatus status() const;
 
   bool is_threatened(Pos pos) const;
   bool is_threatened(Pos pos, Side side) const;
+  // whether a piece of side by attacks pos, empty or not; attack tables only, no move generation
+  bool is_attacked(Pos pos, Side by) const;
   bool is_king_threatened(Side side) const;
   bool is_checking_threats() const { return is_checking_threats_; }
 
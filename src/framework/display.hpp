@@ -8,8 +8,8 @@
 namespace dwc {
 namespace _inner {
 
-const char* SEPARATOR = " ";
-const char* EMPTY = ".";
+inline const char* SEPARATOR = " ";
+inline const char* EMPTY = ".";
 
 struct GetPieceSymbol {
   const char* operator()(Type type, Side side) {
@@ -58,16 +58,17 @@ struct GetPieceSymbolUni {
 };
 
 template <typename MAPPER, typename T = typename std::enable_if<std::is_invocable<MAPPER, dwc::Type, dwc::Side>::value>>
-void display(const Board& board) {
+inline void display(const Board& board) {
   // todo: add option to remove file/rank marker
   // todo: add option to flip vertically and have black at bottom
   // assuming monospace
   std::cout << "┏━━━━━━━━━━━━━━━━━━━━┓\n";
 
-  for (char rank = '8'; rank >= '1'; --rank) {
-    std::cout << "┃ " << rank << "  ";
-    for (char file = 'A'; file <= 'H'; ++file) {
-      auto piece = board.get({std::string{file, rank}});
+  const mailbox::Mailbox& mailbox = board.get_mailbox();
+  for (int8_t rank = 7; rank >= 0; --rank) {
+    std::cout << "┃ " << static_cast<char>('1' + rank) << "  ";
+    for (int8_t file = 0; file < 8; ++file) {
+      auto piece = mailbox.get({file, rank});
       std::cout << (piece.has_value() ? MAPPER()(piece.value().type, piece.value().side) : _inner::EMPTY);
       std::cout << _inner::SEPARATOR;
     }
@@ -80,7 +81,7 @@ void display(const Board& board) {
 }
 }  // namespace _inner
 
-void display(const Board& board) {
+inline void display(const Board& board) {
   _inner::display<_inner::GetPieceSymbolUni>(board);
 }
 }  // namespace dwc
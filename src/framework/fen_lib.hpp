@@ -2,25 +2,23 @@
 
 #include <iostream>  // delete
 #include <set>
+#include <string>
 #include <string_view>
 
 #include "basic_types.hpp"
+#include "src/shared/arena.hpp"
 #include "src/shared/utils.hpp"
 
 namespace dwc::fen {
 namespace _inner {
-bool is_fen_num(char c) {
+inline bool is_fen_num(char c) {
   return '1' <= c && c <= '8';
 }
 
-utils::StringVecT split_segments(std::string_view fen_str) {
-  return utils::split(fen_str, " ");
-}
-
-dwc::BoardT parse_board_pos(std::string_view str) {
+inline dwc::BoardT parse_board_pos(std::string_view str) {
   dwc::BoardT b;
-  auto charPieceMap = getCharPieceMap();
-  utils::StringVecT strings = utils::split(str, "/");
+  utils::ArenaScope scope;
+  auto strings = utils::split(str, "/", scope.resource());
   if (strings.size() != 8) throw std::runtime_error("fen board ill formatted - rank");
 
   for (size_t rank = 0; rank < 8; ++rank) {
@@ -37,15 +35,15 @@ dwc::BoardT parse_board_pos(std::string_view str) {
         if (file > 8) throw std::runtime_error("fen board ill formatted - skip count");
         continue;
       }
-      auto it = charPieceMap.find(c);
-      if (it == charPieceMap.end()) throw std::runtime_error("fen board ill formatted - notation");
-      b[file++][rank] = {it->second};
+      auto piece = piece_from_char(c);
+      if (!piece.has_value()) throw std::runtime_error("fen board ill formatted - notation");
+      b[file++][rank] = {piece};
     }
   }
   return b;
 }
 
-std::optional<dwc::Side> parse_side(std::string_view str) {
+inline std::optional<dwc::Side> parse_side(std::string_view str) {
   std::optional<dwc::Side> ret;
   if (str.size() != 1) throw std::runtime_error("fen string ill formatted - turn side");
   switch (str[0]) {
@@ -63,44 +61,110 @@ std::optional<dwc::Side> parse_side(std::string_view str) {
   return ret;
 }
 
-std::set<dwc::Piece> parse_castling(std::string_view str) {
+inline std::set<dwc::Piece> parse_castling(std::string_view str) {
   if (str.size() > 4) throw std::runtime_error("fen string ill formatted - too many castling entries");
   std::set<dwc::Piece> castling;
-  std::set<dwc::Piece> allowed_values{
-      {Type::KING, Side::WHITE}, {Type::QUEEN, Side::WHITE}, {Type::KING, Side::BLACK}, {Type::QUEEN, Side::BLACK}};
-  const auto charPieceMap = dwc::getCharPieceMap();
-
+  if (str == "-") return castling;
   for (char c : str) {
-    auto it = charPieceMap.find(c);
-    if (it == charPieceMap.end() || allowed_values.find(it->second) == allowed_values.end()) {
+    auto piece = piece_from_char(c);
+    if (!piece.has_value() || (piece->type != Type::KING && piece->type != Type::QUEEN)) {
       throw std::runtime_error("fen string ill formatted - unrecognized castling entry");
     }
-    dwc::Piece p = it->second;
+    dwc::Piece p = *piece;
     if (castling.find(p) != castling.end()) { throw std::runtime_error("fen string ill formatted - double entry"); }
     castling.insert(p);
   }
   return castling;
 }
 
+inline std::optional<dwc::Pos> parse_en_passant(std::string_view str) {
+  if (str == "-") return std::nullopt;
+  auto is_ep_rank = [](char c) { return c == '3' || c == '6'; };
+  if (str.size() != 2 || !is_ep_rank(str[1])) throw std::runtime_error("fen string ill formatted - en passant");
+  try {
+    return dwc::Pos{str};
+  } catch (const std::logic_error&) {
+    throw std::runtime_error("fen string ill formatted - en passant");
+  }
+}
+
+inline uint16_t parse_move_number(std::string_view str) {
+  if (str.empty() || str.size() > 4) throw std::runtime_error("fen string ill formatted - move number");
+  uint16_t v = 0;
+  for (char c : str) {
+    if (c < '0' || '9' < c) throw std::runtime_error("fen string ill formatted - move number");
+    v = v * 10 + (c - '0');
+  }
+  return v;
+}
+
 }  // namespace _inner
 
 class FenParser {
-  utils::StringVecT segments_;
   dwc::BoardT board_;
   std::optional<dwc::Side> turn_side_;
   std::set<dwc::Piece> castling_;
+  std::optional<dwc::Pos> en_passant_;
+  uint16_t halfmove_{0};
+  uint16_t fullmove_{1};
 
  public:
-  FenParser(std::string_view fen_str)
-      : segments_(_inner::split_segments(fen_str)), board_(_inner::parse_board_pos(segments_[0])) {
-    if (segments_.size() >= 2) turn_side_ = _inner::parse_side(segments_[1]);
-    if (segments_.size() >= 3) castling_ = _inner::parse_castling(segments_[2]);
-    if (segments_.size() > 3) throw std::runtime_error("fen string has too many segments");
+  FenParser(std::string_view fen_str) {
+    // the segments are only needed while parsing, they come from the thread's arena
+    utils::ArenaScope scope;
+    auto segments = utils::split(fen_str, " ", scope.resource());
+    if (segments.empty()) throw std::runtime_error("fen board ill formatted - rank");
+    board_ = _inner::parse_board_pos(segments[0]);
+    if (segments.size() >= 2) turn_side_ = _inner::parse_side(segments[1]);
+    if (segments.size() >= 3) castling_ = _inner::parse_castling(segments[2]);
+    if (segments.size() >= 4) en_passant_ = _inner::parse_en_passant(segments[3]);
+    if (segments.size() >= 5) halfmove_ = _inner::parse_move_number(segments[4]);
+    if (segments.size() >= 6) fullmove_ = _inner::parse_move_number(segments[5]);
+    if (segments.size() > 6) throw std::runtime_error("fen string has too many segments");
   }
 
   dwc::BoardT get_board_pos() const { return board_; }
   std::optional<dwc::Side> get_turn_side() const { return turn_side_; }
   std::set<dwc::Piece> get_castling() const { return castling_; }
+  // parsed and validated, but not used by Board yet (no en passant support)
+  std::optional<dwc::Pos> get_en_passant() const { return en_passant_; }
+  uint16_t get_halfmove() const { return halfmove_; }
+  uint16_t get_fullmove() const { return fullmove_; }
 };
 
+// inverse of FenParser, all six segments; en passant is always "-" as State doesn't track it
+inline std::string to_fen(const dwc::State& state) {
+  std::string res;
+  res.reserve(90);
+  for (int rank = 7; rank >= 0; --rank) {
+    char empty = '0';
+    for (int file = 0; file < 8; ++file) {
+      auto p = board_ut::get(Pos::from_index(rank * 8 + file), state.board);
+      if (!p.has_value()) {
+        ++empty;
+        continue;
+      }
+      if (empty != '0') res += empty;
+      empty = '0';
+      res += piece_char(*p);
+    }
+    if (empty != '0') res += empty;
+    if (rank != 0) res += '/';
+  }
+
+  res += state.turn == dwc::Side::BLACK ? " b " : " w ";
+  size_t castling_at = res.size();
+  for (dwc::Side side : {dwc::Side::WHITE, dwc::Side::BLACK}) {
+    for (dwc::Type type : {dwc::Type::KING, dwc::Type::QUEEN}) {
+      if (state.castling.count({type, side}) != 0) res += piece_char({type, side});
+    }
+  }
+  if (res.size() == castling_at) res += '-';
+  res += " - ";
+  res += std::to_string(state.halfmove);
+  res += ' ';
+  res += std::to_string(state.fullmove);
+  return res;
+}
+
 }  // namespace dwc::fen
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <sstream>
+#include <string>
+#include <string_view>
+
+#include "basic_types.hpp"
+#include "src/shared/counters.hpp"
+
+// Hot path counters of Board, compiled in with DWC_ENABLE_COUNTERS (bazel build --config=counters).
+// The timer around Board::move additionally needs DWC_ENABLE_TIMERS (--config=timers).
+// Without them the hooks expand to nothing, the dump API stays available and reports zeros.
+
+namespace dwc::instrument {
+
+enum class Counter : uint8_t {
+  GET_MOVES,         // Board::get_moves calls
+  GET_MOVES_NESTED,  // of those, made while checking threats
+  THREAT_CHECKS,     // Board::is_threatened scans
+  BOARD_COPIES,      // copies made to test a move for own king safety
+  MOVER_CALLS,       // mover invocations dispatched by call_movers
+  MOVES,             // Board::move calls
+  MOVE_NS,           // time spent in Board::move
+  SIZE,
+};
+
+inline constexpr std::array<std::string_view, cast_t(Counter::SIZE)> COUNTER_NAMES{
+    "get_moves", "get_moves_nested", "threat_checks", "board_copies", "mover_calls", "moves", "move_ns",
+};
+
+#ifdef DWC_ENABLE_COUNTERS
+inline constexpr bool ENABLED = true;
+#else
+inline constexpr bool ENABLED = false;
+#endif
+
+using CountersT = utils::Counters<Counter>;
+
+// merged over all threads
+inline CountersT::ValuesT snapshot() {
+  return CountersT::snapshot();
+}
+
+inline void reset() {
+  CountersT::reset();
+}
+
+// one "dwc_<name> <value>" line per counter, prometheus text format
+inline std::string dump() {
+  auto values = snapshot();
+  std::ostringstream oss;
+  for (size_t i = 0; i < values.size(); ++i) oss << "dwc_" << COUNTER_NAMES[i] << " " << values[i] << "\n";
+  return oss.str();
+}
+
+}  // namespace dwc::instrument
+
+#ifdef DWC_ENABLE_COUNTERS
+#define DWC_COUNT(counter) ::dwc::instrument::CountersT::add(::dwc::instrument::Counter::counter)
+#else
+#define DWC_COUNT(counter) static_cast<void>(0)
+#endif
+
+#if defined(DWC_ENABLE_COUNTERS) && defined(DWC_ENABLE_TIMERS)
+#define DWC_SCOPED_TIMER(counter) \
+  ::dwc::utils::ScopedTimer<::dwc::instrument::Counter> dwc_scoped_timer_ { ::dwc::instrument::Counter::counter }
+#else
+#define DWC_SCOPED_TIMER(counter) static_cast<void>(0)
+#endif
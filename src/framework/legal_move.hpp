@@ -4,12 +4,13 @@
 #include <map>
 #include <vector>
 
+#include "attack_tables.hpp"
 #include "board.hpp"
-#include "src/shared/static_map.hpp"
+#include "square_iter.hpp"
 
 namespace dwc::legal_move {
 
-bool is_legal_move(const Board& board, Pos pos, Move move) {
+inline bool is_legal_move(const Board& board, Pos pos, Move move) {
   auto moves = board.get_moves(pos);
   for (auto m : moves) {
     if (m == move) return true;
@@ -163,7 +164,7 @@ class MoverBasic {
     return {0, 0};
   }
 
-  static Pos move(Pos fr, MoveDiff md) {
+  static constexpr Pos move(Pos fr, MoveDiff md) {
     return {static_cast<Pos::FileT>(fr.file + md.file), static_cast<Pos::RankT>(fr.rank + md.rank)};
   }
 
@@ -177,60 +178,92 @@ class MoverBasic {
     return true;
   }
 
-  static MovesT get_moves_from_mover(const Board& board, Piece piece, Pos pos, Mover mover) {
-    MovesT moves;
+  // single step pieces read their targets from the precomputed tables
+  static void get_moves_from_table(const Board& board, Piece piece, Pos pos, MovesT& moves) {
+    for (attack::BitboardT bb = attack::attacks(piece, pos); bb != 0; bb &= bb - 1) {
+      Pos new_pos = Pos::from_index(attack::lsb(bb));
+      auto tgt_piece = board.get(new_pos);
+      if (!tgt_piece.has_value() || tgt_piece->side != piece.side) moves.push_back({pos, new_pos});
+    }
+  }
+
+  static void get_moves_from_mover(const Board& board, Piece piece, Pos pos, Mover mover, MovesT& moves) {
+    if (mover.limit == MoveLimit::ONCE) return get_moves_from_table(board, piece, pos, moves);
     for (size_t i = 0; i < mover.directions_size; ++i) {
       MoveDiff md = get_move_diff(mover.directions[i]);
       Pos curr_pos = pos;
-      size_t limit = mover.limit == MoveLimit::ONCE ? 1 : 8;
-      for (size_t i = 0; i < limit; ++i) {
-        if (can_move(board, piece, curr_pos, md)) {
-          Pos new_pos = move(curr_pos, md);
-          moves.push_back({pos, new_pos});
-          if (board.get(new_pos).has_value()) break;  // stop on capture square
-          curr_pos = new_pos;
-        } else {
-          break;
-        }
+      // sliders run until the edge, an own piece or a capture
+      while (can_move(board, piece, curr_pos, md)) {
+        Pos new_pos = move(curr_pos, md);
+        moves.push_back({pos, new_pos});
+        if (board.get(new_pos).has_value()) break;  // stop on capture square
+        curr_pos = new_pos;
       }
     }
-    return moves;
   }
 
  public:
   static constexpr TypesT<5> TargetTypes{Type::KNIGHT, Type::BISHOP, Type::ROOK, Type::QUEEN, Type::KING};
 
-  static MovesT get_moves(const dwc::Board& board, const dwc::State&, Pos pos) {
-    auto piece = board.get(pos);
-    if (!piece.has_value()) return {};
-    return get_moves_from_mover(board, piece.value(), pos, get_mover_dict()[piece.value().ordinal()]);
+  static void get_moves(const dwc::Board& board, const dwc::State&, Piece piece, Pos pos, MovesT& moves) {
+    get_moves_from_mover(board, piece, pos, get_mover_dict()[piece.ordinal()], moves);
   };
 
   static void update_state(State&, Piece, Move) {}
+
+  // squares reached in one step by the mover model, pawns use their capture directions
+  static constexpr attack::BitboardT model_attacks(Piece piece, Pos pos) {
+    Mover mover = get_mover_dict()[piece.ordinal()];
+    if (piece.type == Type::PAWN) {
+      mover = piece.side == Side::WHITE ? Mover{{MoveDirection::UPLEFT, MoveDirection::UPRIGHT}, 2}
+                                        : Mover{{MoveDirection::DOWNLEFT, MoveDirection::DOWNRIGHT}, 2};
+    } else if (mover.limit != MoveLimit::ONCE) {
+      return 0;
+    }
+
+    attack::BitboardT bb = 0;
+    for (size_t i = 0; i < mover.directions_size; ++i) {
+      Pos new_pos = move(pos, get_move_diff(mover.directions[i]));
+      if (0 <= new_pos.file && new_pos.file < 8 && 0 <= new_pos.rank && new_pos.rank < 8) bb |= attack::bit(new_pos);
+    }
+    return bb;
+  }
 };
 
+namespace _inner {
+constexpr bool attack_tables_match_model() {
+  for (size_t ord = 0; ord < attack::LEAPER_ATTACKS.size(); ++ord) {
+    Piece piece{static_cast<Type>(ord / 2), static_cast<Side>(ord % 2)};
+    for (size_t idx = 0; idx < 64; ++idx) {
+      Pos pos = Pos::from_index(idx);
+      if (attack::attacks(piece, pos) != MoverBasic::model_attacks(piece, pos)) return false;
+    }
+  }
+  return true;
+}
+}  // namespace _inner
+
+static_assert(_inner::attack_tables_match_model(), "attack tables diverge from the MoverBasic direction model");
+
 class MoverPawnAhead {
  public:
   static constexpr TypesT<1> TargetTypes{Type::PAWN};
 
-  static MovesT get_moves(const dwc::Board& board, const dwc::State&, Pos pos) {
-    auto piece = board.get(pos);
-    MovesT moves;
+  static void get_moves(const dwc::Board& board, const dwc::State&, Piece piece, Pos pos, MovesT& moves) {
     auto add_ahead = [&](Pos::RankT rank) {
+      if (rank < 0 || 8 <= rank) return false;  // no promotion yet, a pawn on the last rank is stuck
       Pos pos_ahead{pos.file, rank};
       auto ahead = board.get(pos_ahead);
-      if (!ahead.has_value()) { moves.push_back({pos, pos_ahead}); }
+      if (ahead.has_value()) return false;
+      moves.push_back({pos, pos_ahead});
+      return true;
     };
 
-    uint8_t mult = piece->side == Side::WHITE ? 1 : -1;
+    uint8_t mult = piece.side == Side::WHITE ? 1 : -1;
 
-    // basic step
-    add_ahead(pos.rank + mult);
-
-    // one more if starting from second rank
-    if (pos.rank == (piece->side == Side::WHITE ? 1 : 6)) { add_ahead(pos.rank + 2 * mult); }
-
-    return moves;
+    // basic step, then one more if starting from second rank (cannot jump over a blocking piece)
+    bool stepped = add_ahead(pos.rank + mult);
+    if (stepped && pos.rank == (piece.side == Side::WHITE ? 1 : 6)) { add_ahead(pos.rank + 2 * mult); }
   };
 
   static void update_state(State&, Piece, Move) {}
@@ -240,26 +273,13 @@ class MoverPawnTake {
  public:
   static constexpr TypesT<1> TargetTypes{Type::PAWN};
 
-  static MovesT get_moves(const dwc::Board& board, const dwc::State&, Pos pos) {
+  static void get_moves(const dwc::Board& board, const dwc::State&, Piece piece, Pos pos, MovesT& moves) {
     // diagonal capture if possible
-    auto within = [](auto v) { return 0 <= v && v <= 7; };
-    auto inside = [within](Pos pos) { return within(pos.file) && within(pos.rank); };
-    auto has_opp = [&board](Side my_side, Pos pos) {
-      auto p = board.get(pos);
-      return p.has_value() && p->side != my_side;
-    };
-
-    auto piece = board.get(pos);
-    MovesT moves;
-    auto add_capt = [&](Pos pos_cap) {
-      if (inside(pos_cap) && has_opp(piece->side, pos_cap)) moves.push_back({pos, pos_cap});
-    };
-
-    uint8_t mult = piece->side == Side::WHITE ? 1 : -1;
-    add_capt({static_cast<Pos::FileT>(pos.file - 1), static_cast<Pos::RankT>(pos.rank + mult)});
-    add_capt({static_cast<Pos::FileT>(pos.file + 1), static_cast<Pos::RankT>(pos.rank + mult)});
-
-    return moves;
+    for (attack::BitboardT bb = attack::attacks(piece, pos); bb != 0; bb &= bb - 1) {
+      Pos pos_cap = Pos::from_index(attack::lsb(bb));
+      auto p = board.get(pos_cap);
+      if (p.has_value() && p->side != piece.side) moves.push_back({pos, pos_cap});
+    }
   };
 
   static void update_state(State&, Piece, Move) {}
@@ -270,7 +290,7 @@ class UpdaterTurn {
   static constexpr TypesT<cast_t(Type::SIZE)> TargetTypes{Type::PAWN, Type::KNIGHT, Type::BISHOP,
                                                           Type::ROOK, Type::QUEEN,  Type::KING};
 
-  static MovesT get_moves(const dwc::Board&, const dwc::State&, Pos) { return {}; };
+  static void get_moves(const dwc::Board&, const dwc::State&, Piece, Pos, MovesT&) {};
 
   static void update_state(State& state, Piece, Move) {
     state.turn = state.turn == Side::BLACK ? Side::WHITE : Side::BLACK;
@@ -278,78 +298,49 @@ class UpdaterTurn {
 };
 
 class MoverCastling {
-  struct CastleInfo {
-    Pos king_pos;
-    Pos king_dest;
-    Pos rook_pos;
-    Pos rook_dest;
-  };
-
-  static constexpr utils::Map<Piece, CastleInfo, 4> type_castle_info_{{
-      std::make_pair<Piece, CastleInfo>({Type::KING, Side::WHITE}, {{"e1"}, {"g1"}, {"h1"}, {"f1"}}),
-      std::make_pair<Piece, CastleInfo>({Type::QUEEN, Side::WHITE}, {{"e1"}, {"c1"}, {"a1"}, {"d1"}}),
-      std::make_pair<Piece, CastleInfo>({Type::KING, Side::BLACK}, {{"e8"}, {"g8"}, {"h8"}, {"f8"}}),
-      std::make_pair<Piece, CastleInfo>({Type::QUEEN, Side::BLACK}, {{"e8"}, {"c8"}, {"a8"}, {"d8"}}),
-  }};
-
-  static constexpr bool empty_inbetween(const dwc::Board& board, const CastleInfo& ac) {
-    auto sort_horz = [](Pos a, Pos b) { return (a.file < b.file) ? std::make_pair(a, b) : std::make_pair(b, a); };
-    std::pair<Pos, Pos> must_empty = sort_horz(ac.king_pos, ac.rook_pos);
-    for (Pos p{must_empty.first.file + 1, must_empty.first.rank}; p.file != must_empty.second.file;
-         p.file = p.file + 1) {
-      if (board.get(p).has_value()) { return false; }
-    }
-    return true;
-  }
-
  public:
-  static constexpr TypesT<2> TargetTypes{Type::KING, Type::ROOK};
+  // rights are lost when their king or rook leaves its start square, or when something lands on it
+  static constexpr TypesT<cast_t(Type::SIZE)> TargetTypes{Type::PAWN, Type::KNIGHT, Type::BISHOP,
+                                                          Type::ROOK, Type::QUEEN,  Type::KING};
 
-  static MovesT get_moves(const dwc::Board& board, const dwc::State& state, Pos pos) {
+  static void get_moves(const dwc::Board& board, const dwc::State& state, Piece piece, Pos pos, MovesT& moves) {
     // can skip this if checking for threats, castling can never take opponent's piece
-    if (board.is_checking_threats()) { return {}; }
-
-    auto piece = board.get(pos);
-    if (!piece.has_value() || piece->type != Type::KING) { return {}; }
+    if (board.is_checking_threats()) { return; }
+    if (piece.type != Type::KING) { return; }
 
-    // get allowed castling
-    std::vector<CastleInfo> allowed_castles;
-    for (const auto& i : state.castling) {
-      if (i.side == piece->side) { allowed_castles.emplace_back(type_castle_info_[i]); }
-    }
+    const mailbox::Mailbox& mailbox = board.get_mailbox();
+    for (Type type : {Type::KING, Type::QUEEN}) {
+      Piece right{type, piece.side};
+      if (state.castling.count(right) == 0) continue;
 
-    // for remaining castling, check conditions
-    MovesT moves;
-    for (const auto& ac : allowed_castles) {
+      const CastleInfo& ci = state.castling_rules[right];
+      if (pos.index() != ci.king_from) continue;
       // check if rook is in position (theoretically not necessary, but just in case we allow different chess rules)
-      auto p = board.get(ac.rook_pos);
-      if (!p.has_value() || p->side != piece->side || p->type != Type::ROOK) continue;
-
-      if (!empty_inbetween(board, ac)) { continue; }
-
-      // no need to check king destination here, would've been caught by normal king threatened check
-      if (board.is_threatened(ac.king_pos)) { continue; }
-      if (board.is_threatened(ac.rook_pos)) { continue; }
-      if (board.is_threatened(ac.rook_dest, piece->side)) { continue; }
-
-      // add move (only from King side)
-      moves.push_back({pos, ac.king_dest});
+      auto rook = mailbox.get(Pos::from_index(ci.rook_from));
+      if (!rook.has_value() || rook->side != piece.side || rook->type != Type::ROOK) continue;
+      if (mailbox.occupancy() & ci.must_empty) continue;
+
+      // king destination is checked again by the normal king threatened check
+      Side opp = piece.side == Side::WHITE ? Side::BLACK : Side::WHITE;
+      bool attacked = false;
+      for (Pos sq : iter::squares_of(ci.must_safe)) {
+        if (board.is_attacked(sq, opp)) {
+          attacked = true;
+          break;
+        }
+      }
+      if (!attacked) moves.push_back({pos, Pos::from_index(ci.move_to)});
     }
-
-    return moves;
   };
 
-  static void update_state(State& state, Piece piece, Move move) {
-    if (piece.type == Type::KING) {
-      state.castling.erase(piece);
-      state.castling.erase({Type::QUEEN, piece.side});
-    } else if (piece.type == Type::ROOK) {
-      auto is_queen_rook = [](Pos p) { return p == Pos{"a1"} || p == Pos{"a8"}; };
-      auto is_king_rook = [](Pos p) { return p == Pos{"h1"} || p == Pos{"h8"}; };
-      if (is_queen_rook(move.fr) || is_queen_rook(move.to)) {
-        state.castling.erase({Type::QUEEN, piece.side});
-      } else if (is_king_rook(move.fr) || is_king_rook(move.to)) {
-        state.castling.erase({Type::KING, piece.side});
+  static void update_state(State& state, Piece, Move move) {
+    if (state.castling.empty()) return;
+    attack::BitboardT touched = attack::bit(move.fr) | attack::bit(move.to);
+    for (Side side : {Side::WHITE, Side::BLACK}) {
+      for (Type type : {Type::KING, Type::QUEEN}) {
+        const CastleInfo& ci = state.castling_rules[{type, side}];
+        attack::BitboardT start = (attack::BitboardT{1} << ci.king_from) | (attack::BitboardT{1} << ci.rook_from);
+        if (touched & start) state.castling.erase({type, side});
       }
     }
   }
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <optional>
+
+#if !defined(DWC_MAILBOX_SCALAR) && defined(__AVX2__)
+#include <immintrin.h>
+#define DWC_MAILBOX_AVX2
+#elif !defined(DWC_MAILBOX_SCALAR) && defined(__SSE2__)
+#include <emmintrin.h>
+#define DWC_MAILBOX_SSE2
+#endif
+
+#include "attack_tables.hpp"
+#include "basic_types.hpp"
+
+namespace dwc::mailbox {
+
+enum class Isa : uint8_t {
+  SCALAR,
+  SSE2,
+  AVX2,
+};
+
+// picked at compile time, define DWC_MAILBOX_SCALAR to force the plain loop
+#if defined(DWC_MAILBOX_AVX2)
+inline constexpr Isa ISA = Isa::AVX2;
+#elif defined(DWC_MAILBOX_SSE2)
+inline constexpr Isa ISA = Isa::SSE2;
+#else
+inline constexpr Isa ISA = Isa::SCALAR;
+#endif
+
+using CountsT = std::array<uint8_t, cast_t(Type::SIZE) * cast_t(Side::SIZE)>;
+
+// Packed copy of the board, one byte per square in Pos::index() order, so a whole board fits in a single cache line
+// and can be compared against a value with a few vector instructions.
+// A byte is 0 for an empty square, or Piece::ordinal() + 1. White pieces have odd codes, black pieces even ones.
+class Mailbox {
+  alignas(64) std::array<uint8_t, 64> squares_{};
+
+  static constexpr uint8_t code(Piece piece) { return static_cast<uint8_t>(piece.ordinal() + 1); }
+
+  // bit set for every square where (byte & mask) == value
+  attack::BitboardT match(uint8_t mask, uint8_t value) const {
+#if defined(DWC_MAILBOX_AVX2)
+    const __m256i m = _mm256_set1_epi8(static_cast<char>(mask));
+    const __m256i v = _mm256_set1_epi8(static_cast<char>(value));
+    attack::BitboardT bb = 0;
+    for (size_t i = 0; i < 2; ++i) {
+      __m256i chunk = _mm256_load_si256(reinterpret_cast<const __m256i*>(squares_.data() + 32 * i));
+      uint32_t bits = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_and_si256(chunk, m), v)));
+      bb |= attack::BitboardT{bits} << (32 * i);
+    }
+    return bb;
+#elif defined(DWC_MAILBOX_SSE2)
+    const __m128i m = _mm_set1_epi8(static_cast<char>(mask));
+    const __m128i v = _mm_set1_epi8(static_cast<char>(value));
+    attack::BitboardT bb = 0;
+    for (size_t i = 0; i < 4; ++i) {
+      __m128i chunk = _mm_load_si128(reinterpret_cast<const __m128i*>(squares_.data() + 16 * i));
+      uint32_t bits = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(chunk, m), v)));
+      bb |= attack::BitboardT{bits} << (16 * i);
+    }
+    return bb;
+#else
+    attack::BitboardT bb = 0;
+    for (size_t i = 0; i < 64; ++i) {
+      if ((squares_[i] & mask) == value) bb |= attack::BitboardT{1} << i;
+    }
+    return bb;
+#endif
+  }
+
+ public:
+  Mailbox() = default;
+  explicit Mailbox(const BoardT& board) {
+    for (size_t idx = 0; idx < 64; ++idx) {
+      auto piece = board_ut::get(Pos::from_index(idx), board);
+      if (piece.has_value()) set(Pos::from_index(idx), *piece);
+    }
+  }
+
+  void set(Pos pos, Piece piece) { squares_[pos.index()] = code(piece); }
+  void clear(Pos pos) { squares_[pos.index()] = 0; }
+
+  std::optional<Piece> get(Pos pos) const {
+    uint8_t c = squares_[pos.index()];
+    if (c == 0) return std::nullopt;
+    return Piece{static_cast<Type>((c - 1) / 2), static_cast<Side>((c - 1) % 2)};
+  }
+
+  const std::array<uint8_t, 64>& data() const { return squares_; }
+
+  attack::BitboardT occupancy() const { return ~match(0xff, 0); }
+  attack::BitboardT occupancy(Side side) const {
+    attack::BitboardT white = match(0x01, 0x01);
+    return side == Side::WHITE ? white : occupancy() & ~white;
+  }
+  attack::BitboardT occupancy(Piece piece) const { return match(0xff, code(piece)); }
+
+  size_t count(Piece piece) const { return attack::popcount(occupancy(piece)); }
+
+  // piece count per Piece::ordinal()
+  CountsT counts() const {
+    CountsT res{};
+    for (size_t ord = 0; ord < res.size(); ++ord) {
+      res[ord] = static_cast<uint8_t>(count({static_cast<Type>(ord / 2), static_cast<Side>(ord % 2)}));
+    }
+    return res;
+  }
+
+  // lowest square holding the piece
+  std::optional<Pos> find(Piece piece) const {
+    attack::BitboardT bb = occupancy(piece);
+    if (bb == 0) return std::nullopt;
+    return Pos::from_index(attack::lsb(bb));
+  }
+
+  bool operator==(const Mailbox& o) const { return squares_ == o.squares_; }
+};
+
+}  // namespace dwc::mailbox
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "board.hpp"
+#include "square_iter.hpp"
+#include "src/shared/arena.hpp"
+#include "src/shared/generator.hpp"
+
+namespace dwc::iter {
+
+// Lazy legal moves of the side to move. Pseudo legal moves are generated one piece at a time into a reused buffer,
+// and the own king check only runs for the moves actually pulled, so stopping at the first move is cheap.
+// Single pass: begin() may only be called once, and the board must not change while iterating.
+// The buffer lives in the thread's arena, so instances must be destroyed in reverse order of construction (as locals
+// are).
+class LegalMoves {
+  const Board& board_;
+  attack::BitboardT pieces_;  // pieces not expanded yet
+  utils::ArenaScope scope_;
+  MovesT buffer_{scope_.resource()};  // pseudo legal moves of the current piece
+  size_t idx_{0};
+  std::optional<Move> curr_;
+
+  void advance() {
+    while (true) {
+      while (idx_ < buffer_.size()) {
+        Move m = buffer_[idx_++];
+        if (!board_.is_king_threatened_after(m)) {
+          curr_ = m;
+          return;
+        }
+      }
+      if (pieces_ == 0) {
+        curr_.reset();
+        return;
+      }
+      Pos pos = *BitIterator{pieces_};
+      pieces_ &= pieces_ - 1;
+      buffer_.clear();
+      idx_ = 0;
+      board_.get_pseudo_moves(pos, buffer_);
+    }
+  }
+
+ public:
+  class iterator {
+    LegalMoves* gen_;
+
+   public:
+    explicit iterator(LegalMoves* gen) : gen_(gen) {}
+    const Move& operator*() const { return *gen_->curr_; }
+    iterator& operator++() {
+      gen_->advance();
+      return *this;
+    }
+    // all exhausted iterators compare equal
+    bool operator==(const iterator& o) const { return done() == o.done(); }
+    bool operator!=(const iterator& o) const { return !(*this == o); }
+    bool done() const { return gen_ == nullptr || !gen_->curr_.has_value(); }
+  };
+
+  explicit LegalMoves(const Board& board)
+      : board_(board), pieces_(board.get_mailbox().occupancy(board.get_state().turn.value_or(Side::WHITE))) {
+    // reserved up front, so the buffer doesn't grow past arena scopes opened by the legality checks
+    buffer_.reserve(Board::MAX_PIECE_MOVES);
+  }
+  LegalMoves(const LegalMoves&) = delete;
+  LegalMoves& operator=(const LegalMoves&) = delete;
+
+  iterator begin() {
+    advance();
+    return iterator{this};
+  }
+  iterator end() { return iterator{nullptr}; }
+};
+
+#ifdef DWC_HAS_GENERATOR
+// coroutine flavor of LegalMoves, same order and the same rules
+inline utils::Generator<Move> legal_moves(const Board& board) {
+  MovesT buffer;
+  for (Pos pos : squares_of(board.get_mailbox().occupancy(board.get_state().turn.value_or(Side::WHITE)))) {
+    buffer.clear();
+    board.get_pseudo_moves(pos, buffer);
+    for (const Move& m : buffer) {
+      if (!board.is_king_threatened_after(m)) co_yield m;
+    }
+  }
+}
+#endif
+
+}  // namespace dwc::iter
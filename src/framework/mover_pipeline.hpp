@@ -0,0 +1,81 @@
+#pragma once
+
+#include <array>
+#include <utility>
+
+#include "board.hpp"
+#include "instrument.hpp"
+#include "legal_move.hpp"
+#include "src/shared/type_list.hpp"
+
+// Compile time dispatch of the movers / updaters of a type_list.
+// For every piece type the chain of matching movers is unrolled by a fold expression, TargetTypes are checked while
+// compiling, and a table indexed by the piece type picks the chain at runtime: one indirect call per square instead
+// of a recursive walk that re-fetches the piece and tests TargetTypes at every level.
+
+namespace dwc::pipeline {
+
+using MoverFn = void (*)(const Board&, const State&, Piece, Pos, MovesT&);
+using UpdaterFn = void (*)(State&, Piece, Move);
+
+template <typename T>
+constexpr bool targets(Type type) {
+  for (Type t : T::TargetTypes) {
+    if (t == type) return true;
+  }
+  return false;
+}
+
+namespace _inner {
+template <Type TYPE, typename T>
+inline void run_mover(const Board& board, const State& state, Piece piece, Pos pos, MovesT& moves) {
+  if constexpr (targets<T>(TYPE)) {
+    DWC_COUNT(MOVER_CALLS);
+    T::get_moves(board, state, piece, pos, moves);
+  }
+}
+
+template <Type TYPE, typename T>
+inline void run_updater(State& state, Piece piece, Move move) {
+  if constexpr (targets<T>(TYPE)) T::update_state(state, piece, move);
+}
+
+template <Type TYPE, typename... TS>
+void get_moves(const Board& board, const State& state, Piece piece, Pos pos, MovesT& moves) {
+  (run_mover<TYPE, TS>(board, state, piece, pos, moves), ...);
+}
+
+template <Type TYPE, typename... TS>
+void update_state(State& state, Piece piece, Move move) {
+  (run_updater<TYPE, TS>(state, piece, move), ...);
+}
+
+template <typename... TS, size_t... I>
+constexpr std::array<MoverFn, sizeof...(I)> make_movers(std::index_sequence<I...>) {
+  return {&get_moves<static_cast<Type>(I), TS...>...};
+}
+
+template <typename... TS, size_t... I>
+constexpr std::array<UpdaterFn, sizeof...(I)> make_updaters(std::index_sequence<I...>) {
+  return {&update_state<static_cast<Type>(I), TS...>...};
+}
+}  // namespace _inner
+
+template <typename TL>
+struct Pipeline;
+
+template <typename... TS>
+struct Pipeline<utils::type_list<TS...>> {
+  static_assert(utils::unique_v<TS...>, "a mover listed twice would run twice");
+
+  static constexpr auto MOVERS = _inner::make_movers<TS...>(std::make_index_sequence<cast_t(Type::SIZE)>{});
+  static constexpr auto UPDATERS = _inner::make_updaters<TS...>(std::make_index_sequence<cast_t(Type::SIZE)>{});
+
+  static void get_moves(const Board& board, const State& state, Piece piece, Pos pos, MovesT& moves) {
+    MOVERS[cast_t(piece.type)](board, state, piece, pos, moves);
+  }
+
+  static void update_state(State& state, Piece piece, Move move) { UPDATERS[cast_t(piece.type)](state, piece, move); }
+};
+
+}  // namespace dwc::pipeline
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "attack_tables.hpp"
+#include "basic_types.hpp"
+
+namespace dwc::iter {
+
+// all 64 squares in Pos::index() order, a1, b1, ..., h8
+class SquareIterator {
+  size_t idx_;
+
+ public:
+  constexpr explicit SquareIterator(size_t idx) : idx_(idx) {}
+  constexpr Pos operator*() const { return Pos::from_index(idx_); }
+  constexpr SquareIterator& operator++() {
+    ++idx_;
+    return *this;
+  }
+  constexpr bool operator==(const SquareIterator& o) const { return idx_ == o.idx_; }
+  constexpr bool operator!=(const SquareIterator& o) const { return idx_ != o.idx_; }
+};
+
+struct SquareRange {
+  constexpr SquareIterator begin() const { return SquareIterator{0}; }
+  constexpr SquareIterator end() const { return SquareIterator{64}; }
+};
+
+inline constexpr SquareRange ALL_SQUARES{};
+
+// squares of the set bits, lowest index first
+class BitIterator {
+  attack::BitboardT bb_;
+
+ public:
+  constexpr explicit BitIterator(attack::BitboardT bb) : bb_(bb) {}
+  constexpr Pos operator*() const { return Pos::from_index(attack::lsb(bb_)); }
+  constexpr BitIterator& operator++() {
+    bb_ &= bb_ - 1;
+    return *this;
+  }
+  constexpr bool operator==(const BitIterator& o) const { return bb_ == o.bb_; }
+  constexpr bool operator!=(const BitIterator& o) const { return bb_ != o.bb_; }
+};
+
+struct BitRange {
+  attack::BitboardT bb;
+  constexpr BitIterator begin() const { return BitIterator{bb}; }
+  constexpr BitIterator end() const { return BitIterator{0}; }
+};
+
+constexpr BitRange squares_of(attack::BitboardT bb) {
+  return {bb};
+}
+
+namespace _inner {
+constexpr size_t sum_of_indices(SquareRange range) {
+  size_t sum = 0;
+  for (Pos pos : range) sum += pos.index();
+  return sum;
+}
+
+constexpr size_t sum_of_indices(BitRange range) {
+  size_t sum = 0;
+  for (Pos pos : range) sum += pos.index();
+  return sum;
+}
+}  // namespace _inner
+
+static_assert(_inner::sum_of_indices(ALL_SQUARES) == 63 * 64 / 2);
+static_assert(_inner::sum_of_indices(squares_of(0x8000000000000101ULL)) == 0 + 8 + 63);
+static_assert(_inner::sum_of_indices(squares_of(0)) == 0);
+
+}  // namespace dwc::iter
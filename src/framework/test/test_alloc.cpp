@@ -0,0 +1,81 @@
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <new>
+
+#include "src/framework/board.hpp"
+#include "src/framework/fen_lib.hpp"
+#include "src/framework/move_gen.hpp"
+
+// the whole binary counts its heap allocations
+namespace {
+size_t allocations = 0;
+}  // namespace
+
+void* operator new(size_t size) {
+  ++allocations;
+  if (void* p = std::malloc(size == 0 ? 1 : size)) return p;
+  throw std::bad_alloc{};
+}
+void* operator new[](size_t size) {
+  return operator new(size);
+}
+// gcc takes the replaced operators for the library ones and warns about free() on new'ed memory
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+void operator delete(void* p) noexcept {
+  std::free(p);
+}
+#pragma GCC diagnostic pop
+void operator delete(void* p, size_t) noexcept {
+  operator delete(p);
+}
+void operator delete[](void* p) noexcept {
+  operator delete(p);
+}
+void operator delete[](void* p, size_t) noexcept {
+  operator delete(p);
+}
+
+using namespace dwc;
+
+namespace {
+const std::vector<std::string_view> FENS{
+    "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq",
+    "r3k2r/pppq1ppp/2npbn2/2b1p3/2B1P3/2NPBN2/PPPQ1PPP/R3K2R w KQkq",
+    "4k3/8/8/3q4/8/8/3R4/4K3 w -",
+    "r3k2r/8/8/8/8/8/8/R3K2R b KQkq",
+};
+
+// the hot path of a search: generation and legality, no make/unmake
+size_t generate(const std::vector<Board>& boards) {
+  size_t n = 0;
+  for (const Board& b : boards) {
+    for (const Move& m : iter::LegalMoves{b}) n += m.to.index();
+    n += b.has_legal_move();
+    n += b.is_king_threatened(*b.get_state().turn);
+  }
+  return n;
+}
+}  // namespace
+
+TEST(ALLOC, SteadyStateMoveGeneration) {
+  std::vector<Board> boards(FENS.begin(), FENS.end());
+  size_t warm = generate(boards);
+
+  size_t before = allocations;
+  size_t blocks = utils::thread_arena().block_allocations();
+  EXPECT_EQ(generate(boards), warm);
+  EXPECT_EQ(allocations, before);
+  EXPECT_EQ(utils::thread_arena().block_allocations(), blocks);
+}
+
+TEST(ALLOC, FenParserWithoutCastling) {
+  constexpr std::string_view FEN = "8/8/4k3/8/2b5/8/4K3/5R2 w - - 3 40";
+  fen::FenParser{FEN};
+
+  size_t before = allocations;
+  fen::FenParser parser{FEN};
+  EXPECT_EQ(allocations, before);
+  EXPECT_EQ(parser.get_fullmove(), 40);
+}
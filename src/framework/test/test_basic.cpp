@@ -38,6 +38,13 @@ TEST(PieceMapping, CharPiece) {
   EXPECT_EQ(m['N'], (Piece{Type::KNIGHT, Side::WHITE}));
 }
 
+TEST(BASIC, MoveToUci) {
+  EXPECT_EQ(to_uci({{"g1"}, {"f3"}}), "g1f3");
+  char buf[UCI_MAX];
+  char* end = write_uci({{"h7"}, {"a1"}}, buf);
+  EXPECT_EQ(std::string_view(buf, end - buf), "h7a1");
+}
+
 TEST(BOARD, BoardEmpty) {
   Board b;
   for (char file : {'A', 'B', 'C', 'D', 'E', 'F', 'G', 'H'}) {
@@ -348,3 +355,13 @@ TEST(BOARD, EnPassant01) {
   // EXPECT_TRUE(find_me(moves, Move{{"e5"}, {"e6"}}));
   // EXPECT_TRUE(find_me(moves, Move{{"e5"}, {"d6"}}));  // en passant
 }
+
+TEST(BOARD, PawnBlocked) {
+  // a blocked pawn cannot jump over the blocking piece with its double step
+  Board b{"4k3/8/8/8/8/4n3/4P3/4K3 w"};
+  EXPECT_TRUE(b.get_moves({"e2"}).empty());
+
+  // without promotion a pawn on the last rank has nowhere to go
+  Board b2{"3Pk3/8/8/8/8/8/8/4K3 w"};
+  EXPECT_TRUE(b2.get_moves({"d8"}).empty());
+}
@@ -186,14 +186,21 @@ TEST(BOARD, Castling05_KingThreatenedByPinnedPiece) {
 
 TEST(BOARD, Castling06_RookThreatened) {
   Board b{"r3k2r/ppp1pp1p/3p1B2/4p3/8/2b5/P1PQP1PP/R3K2R w KQkq"};
-  // the rooks are threatened, cannot castle
-  EXPECT_TRUE((And<KingWhite<true>, QueenWhite<false>, KingBlack<false>, QueenBlack<true>>::fold(b)));
+  // the rooks a1 and h8 are threatened, only the king's squares have to be safe
+  EXPECT_TRUE((And<KingWhite<true>, QueenWhite<true>, KingBlack<true>, QueenBlack<true>>::fold(b)));
+
+  // the bishop attacks a1 and nothing else on the first rank
+  Board b2{"4k2b/8/8/8/8/8/8/R3K3 w Q"};
+  EXPECT_TRUE(QueenWhite<true>::check(b2));
+  b2.move({{"e1"}, {"c1"}});
+  EXPECT_EQ(b2.get({"c1"}), (Piece{Type::KING, Side::WHITE}));
+  EXPECT_EQ(b2.get({"d1"}), (Piece{Type::ROOK, Side::WHITE}));
 }
 
 TEST(BOARD, Castling06_RookThreatenedByPinnedPiece) {
   Board b{"r6r/ppp1pp1p/3p1B2/3kp3/3b4/8/P1PQP1PP/R3K2R w KQ"};
-  // the rooks are threatened by a pinned piece, cannot castle
-  EXPECT_TRUE((And<KingWhite<false>, QueenWhite<false>, KingBlack<false>, QueenBlack<false>>::fold(b)));
+  // the pinned bishop attacks the rook a1, which doesn't matter, and the king's destination g1
+  EXPECT_TRUE((And<KingWhite<false>, QueenWhite<true>, KingBlack<false>, QueenBlack<false>>::fold(b)));
 }
 
 TEST(BOARD, Castling07_RookDestThreatened) {
@@ -207,3 +214,73 @@ TEST(BOARD, Castling07_RookDestThreatenedByPinnedPiece) {
   // the rooks are threatened by a pinned piece, cannot castle
   EXPECT_TRUE((And<KingWhite<false>, QueenWhite<false>, KingBlack<false>, QueenBlack<true>>::fold(b)));
 }
+
+TEST(BOARD, Castling08_RookFollows) {
+  Board b{"r3k2r/pppq1ppp/2np4/4pb2/8/2NP4/PPPQPPPP/R3K2R w KQkq"};
+  b.move({{"e1"}, {"g1"}});
+  EXPECT_EQ(b.get({"g1"}), (Piece{Type::KING, Side::WHITE}));
+  EXPECT_EQ(b.get({"f1"}), (Piece{Type::ROOK, Side::WHITE}));
+  EXPECT_FALSE(b.get({"h1"}).has_value());
+  EXPECT_EQ(b.get_key(), zobrist::compute(b.get_state()));
+
+  b.move({{"e8"}, {"c8"}});
+  EXPECT_EQ(b.get({"c8"}), (Piece{Type::KING, Side::BLACK}));
+  EXPECT_EQ(b.get({"d8"}), (Piece{Type::ROOK, Side::BLACK}));
+  EXPECT_FALSE(b.get({"a8"}).has_value());
+  EXPECT_EQ(b.get_state().castling, std::set<Piece>{});
+  EXPECT_EQ(b.get_mailbox(), mailbox::Mailbox{b.get_state().board});
+
+  b.undo_move();
+  b.undo_move();
+  EXPECT_EQ(b.get({"h1"}), (Piece{Type::ROOK, Side::WHITE}));
+  EXPECT_EQ(b.get({"a8"}), (Piece{Type::ROOK, Side::BLACK}));
+  EXPECT_FALSE(b.get({"f1"}).has_value());
+  EXPECT_EQ(b.get_state().castling.size(), 4);
+  EXPECT_EQ(b.get_key(), zobrist::compute(b.get_state()));
+}
+
+TEST(BOARD, Castling09_RookCaptured) {
+  // capturing a rook on its start square takes the opponent's right, not the own one
+  Board b{"r3k2r/pppq1pp1/2np4/4pb2/8/2NP4/PPPQPPP1/R3K2R w KQkq"};
+  b.move({{"h1"}, {"h8"}});
+  EXPECT_EQ(b.get_state().castling, (std::set<Piece>{{Type::QUEEN, Side::WHITE}, {Type::QUEEN, Side::BLACK}}));
+  EXPECT_EQ(b.get_key(), zobrist::compute(b.get_state()));
+}
+
+TEST(BOARD, Castling10_Chess960) {
+  // king on b1, rooks on a1 and g1
+  Board b{"6k1/8/8/8/8/8/8/RK4R1 w KQ"};
+  b.set_castling_rules(CastlingRules::make(1, 6, 0));
+
+  // written as king takes own rook
+  EXPECT_TRUE(legal_move::is_legal_move(b, {"b1"}, {{"b1"}, {"g1"}}));
+  EXPECT_TRUE(legal_move::is_legal_move(b, {"b1"}, {{"b1"}, {"a1"}}));
+
+  b.move({{"b1"}, {"a1"}});
+  EXPECT_EQ(b.get({"c1"}), (Piece{Type::KING, Side::WHITE}));
+  EXPECT_EQ(b.get({"d1"}), (Piece{Type::ROOK, Side::WHITE}));
+  EXPECT_FALSE(b.get({"a1"}).has_value());
+  EXPECT_FALSE(b.get({"b1"}).has_value());
+  EXPECT_EQ(b.get_key(), zobrist::compute(b.get_state()));
+
+  b.undo_move();
+  EXPECT_EQ(b.get({"b1"}), (Piece{Type::KING, Side::WHITE}));
+  EXPECT_EQ(b.get({"a1"}), (Piece{Type::ROOK, Side::WHITE}));
+
+  // the rook on b8 attacks b1, no castling out of check
+  Board b2{"1r4k1/8/8/8/8/8/8/RK4R1 w KQ"};
+  b2.set_castling_rules(CastlingRules::make(1, 6, 0));
+  EXPECT_FALSE(legal_move::is_legal_move(b2, {"b1"}, {{"b1"}, {"g1"}}));
+}
+
+TEST(BOARD, Castling11_TransitAttackedByPawn) {
+  // the e2 pawn attacks the empty f1 and d1, pawns only capture onto occupied squares in move generation
+  Board b{"4k3/8/8/8/8/8/4p3/R3K2R w KQ - 0 1"};
+  EXPECT_TRUE(b.is_attacked({"f1"}, Side::BLACK));
+  EXPECT_FALSE(b.is_attacked({"e1"}, Side::BLACK));
+  EXPECT_TRUE((And<KingWhite<false>, QueenWhite<false>>::fold(b)));
+
+  // a pawn on a2 attacks b1, which the king doesn't cross on the queen side
+  Board b2{"4k3/8/8/8/8/8/p7/R3K2R w KQ - 0 1"};
+  EXPECT_TRUE((And<KingWhite<true>, QueenWhite<true>>::fold(b2)));
+}
@@ -59,3 +59,37 @@ TEST(BOARD, FenBoardParser03) {
   EXPECT_THROW(fen::_inner::parse_castling("KQR"), std::runtime_error);
   EXPECT_THROW(fen::_inner::parse_castling("R"), std::runtime_error);
 }
+
+TEST(BOARD, FenBoardParser04) {
+  fen::FenParser fp{"rnbqkbnr/pp1ppppp/8/2p5/4P3/8/PPPP1PPP/RNBQKBNR w KQkq c6 0 2"};
+  EXPECT_EQ(fp.get_en_passant().value(), Pos{"c6"});
+  EXPECT_EQ(fp.get_halfmove(), 0);
+  EXPECT_EQ(fp.get_fullmove(), 2);
+
+  fen::FenParser fp2{"8/4k3/8/8/2K5/8/8/8 b - - 37 80"};
+  EXPECT_TRUE(fp2.get_castling().empty());
+  EXPECT_FALSE(fp2.get_en_passant().has_value());
+  EXPECT_EQ(fp2.get_halfmove(), 37);
+  EXPECT_EQ(fp2.get_fullmove(), 80);
+
+  Board b{"8/4k3/8/8/2K5/8/8/8 b - - 37 80"};
+  EXPECT_EQ(b.get_state().halfmove, 37);
+  EXPECT_EQ(b.get_state().fullmove, 80);
+
+  EXPECT_THROW(fen::_inner::parse_en_passant("c4"), std::runtime_error);
+  EXPECT_THROW(fen::_inner::parse_en_passant("i3"), std::runtime_error);
+  EXPECT_THROW(fen::_inner::parse_move_number("1a"), std::runtime_error);
+  EXPECT_THROW(fen::_inner::parse_move_number(""), std::runtime_error);
+  EXPECT_THROW(Board{"8/4k3/8/8/2K5/8/8/8 b - - 0 1 1"}, std::runtime_error);
+}
+
+TEST(BOARD, FenWriter) {
+  for (std::string_view fen : {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+                               "r3k2r/pppq1ppp/2n2n2/3pp3/1b2P3/2NP1N2/PPP2PPP/R1BQK2R w Kq - 4 8",
+                               "8/4k3/8/8/2K5/8/8/8 b - - 37 80"}) {
+    EXPECT_EQ(fen::to_fen(Board{fen}.get_state()), fen);
+  }
+  // en passant isn't kept
+  EXPECT_EQ(fen::to_fen(Board{"rnbqkbnr/pp1ppppp/8/2p5/4P3/8/PPPP1PPP/RNBQKBNR w KQkq c6 0 2"}.get_state()),
+            "rnbqkbnr/pp1ppppp/8/2p5/4P3/8/PPPP1PPP/RNBQKBNR w KQkq - 0 2");
+}
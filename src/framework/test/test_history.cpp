@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+
+#include "src/framework/board.hpp"
+#include "src/framework/fen_lib.hpp"
+#include "src/framework/zobrist.hpp"
+
+using namespace dwc;
+
+namespace {
+void shuffle_knights(Board& b) {
+  b.move({{"g1"}, {"f3"}});
+  b.move({{"g8"}, {"f6"}});
+  b.move({{"f3"}, {"g1"}});
+  b.move({{"f6"}, {"g8"}});
+}
+}  // namespace
+
+TEST(HISTORY, IncrementalKey) {
+  Board b;
+  b.reset_position();
+  EXPECT_EQ(b.get_key(), zobrist::compute(b.get_state()));
+
+  for (Move m : std::vector<Move>{{{"e2"}, {"e4"}},
+                                  {{"d7"}, {"d5"}},
+                                  {{"e4"}, {"d5"}},
+                                  {{"d8"}, {"d5"}},
+                                  {{"e1"}, {"e2"}},
+                                  {{"e8"}, {"d8"}}}) {
+    b.move(m);
+    EXPECT_EQ(b.get_key(), zobrist::compute(b.get_state()));
+  }
+
+  // castling rights are part of the key
+  Board b2{"r3k2r/8/8/8/8/8/8/R3K2R w KQkq"};
+  Board b3{"r3k2r/8/8/8/8/8/8/R3K2R w Kkq"};
+  EXPECT_NE(b2.get_key(), b3.get_key());
+  b2.move({{"a1"}, {"b1"}});
+  EXPECT_EQ(b2.get_key(), zobrist::compute(b2.get_state()));
+}
+
+TEST(HISTORY, UndoMove) {
+  Board b{"r3k2r/8/8/3p4/4P3/8/8/R3K2R w KQkq - 3 10"};
+  const State before = b.get_state();
+  const zobrist::KeyT key = b.get_key();
+
+  b.move({{"e4"}, {"d5"}});
+  b.move({{"e8"}, {"d7"}});
+  EXPECT_EQ(b.get_state().halfmove, 1);
+  EXPECT_EQ(b.get_state().fullmove, 11);
+  EXPECT_TRUE(b.get_state().castling.size() == 2);
+
+  b.undo_move();
+  b.undo_move();
+  EXPECT_EQ(b.get_key(), key);
+  EXPECT_EQ(b.get_state().castling, before.castling);
+  EXPECT_EQ(b.get_state().halfmove, 3);
+  EXPECT_EQ(b.get_state().fullmove, 10);
+  EXPECT_EQ(b.get_state().turn, Side::WHITE);
+  EXPECT_EQ(b.get({"d5"}).value(), (Piece{Type::PAWN, Side::BLACK}));
+  EXPECT_EQ(b.get({"e4"}).value(), (Piece{Type::PAWN, Side::WHITE}));
+  EXPECT_EQ(b.get({"e8"}).value(), (Piece{Type::KING, Side::BLACK}));
+  EXPECT_THROW(b.undo_move(), std::logic_error);
+}
+
+TEST(HISTORY, NullMove) {
+  Board b{"r3k2r/8/8/3p4/4P3/8/8/R3K2R b KQkq - 3 10"};
+  const std::string fen = fen::to_fen(b.get_state());
+  const zobrist::KeyT key = b.get_key();
+
+  b.apply_null_move();
+  EXPECT_EQ(b.get_state().turn, Side::WHITE);
+  EXPECT_EQ(b.get_state().fullmove, 11);
+  EXPECT_EQ(b.get_key(), zobrist::compute(b.get_state()));
+  b.move({{"e4"}, {"d5"}});
+  EXPECT_EQ(b.repetition_count(), 0);
+
+  b.undo_move();
+  b.undo_move();
+  EXPECT_EQ(b.get_key(), key);
+  EXPECT_EQ(fen::to_fen(b.get_state()), fen);
+}
+
+TEST(HISTORY, ThreefoldRepetition) {
+  Board b;
+  b.reset_position();
+  EXPECT_EQ(b.repetition_count(), 0);
+
+  shuffle_knights(b);
+  EXPECT_EQ(b.repetition_count(), 1);
+  EXPECT_FALSE(b.is_threefold_repetition());
+
+  shuffle_knights(b);
+  EXPECT_EQ(b.repetition_count(), 2);
+  EXPECT_TRUE(b.is_threefold_repetition());
+
+  // a pawn move resets the lookback, earlier positions can never come back
+  b.move({{"e2"}, {"e4"}});
+  EXPECT_EQ(b.get_state().halfmove, 0);
+  EXPECT_EQ(b.repetition_count(), 0);
+  b.move({{"e7"}, {"e5"}});
+  shuffle_knights(b);
+  EXPECT_EQ(b.repetition_count(), 1);
+}
+
+TEST(HISTORY, FiftyMoveRule) {
+  Board b{"8/4k3/8/8/2K5/8/5R2/8 w - - 98 80"};
+  EXPECT_FALSE(b.is_fifty_move_draw());
+  b.move({{"f2"}, {"f3"}});
+  EXPECT_FALSE(b.is_fifty_move_draw());
+  b.move({{"e7"}, {"e6"}});
+  EXPECT_TRUE(b.is_fifty_move_draw());
+
+  // capture resets the clock
+  Board b2{"8/4k3/8/8/2K5/8/5R2/5n2 w - - 98 80"};
+  b2.move({{"f2"}, {"f1"}});
+  EXPECT_EQ(b2.get_state().halfmove, 0);
+  EXPECT_FALSE(b2.is_fifty_move_draw());
+}
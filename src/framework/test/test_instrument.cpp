@@ -0,0 +1,35 @@
+#include <gtest/gtest.h>
+
+#include "src/framework/board.hpp"
+#include "src/framework/instrument.hpp"
+
+using namespace dwc;
+
+TEST(INSTRUMENT, Dump) {
+  instrument::reset();
+  std::string dump = instrument::dump();
+  EXPECT_NE(dump.find("dwc_get_moves 0\n"), std::string::npos);
+  EXPECT_NE(dump.find("dwc_move_ns 0\n"), std::string::npos);
+}
+
+TEST(INSTRUMENT, BoardCounters) {
+  if (!instrument::ENABLED) GTEST_SKIP() << "built without DWC_ENABLE_COUNTERS";
+
+  Board b;
+  b.reset_position();
+  instrument::reset();
+  b.move({{"e2"}, {"e4"}});
+
+  auto values = instrument::snapshot();
+  auto value = [&values](instrument::Counter c) { return values[cast_t(c)]; };
+  EXPECT_EQ(value(instrument::Counter::MOVES), 1);
+  // the pawn's two moves are both checked on a copy
+  EXPECT_EQ(value(instrument::Counter::BOARD_COPIES), 2);
+  EXPECT_GT(value(instrument::Counter::GET_MOVES_NESTED), 0);
+  EXPECT_GT(value(instrument::Counter::GET_MOVES), value(instrument::Counter::GET_MOVES_NESTED));
+  EXPECT_GT(value(instrument::Counter::THREAT_CHECKS), 0);
+  EXPECT_GT(value(instrument::Counter::MOVER_CALLS), value(instrument::Counter::GET_MOVES));
+#ifdef DWC_ENABLE_TIMERS
+  EXPECT_GT(value(instrument::Counter::MOVE_NS), 0);
+#endif
+}
@@ -0,0 +1,77 @@
+#include <gtest/gtest.h>
+
+#include "src/framework/move_gen.hpp"
+
+using namespace dwc;
+
+TEST(ITER, AllSquares) {
+  std::vector<Pos> squares;
+  for (Pos pos : iter::ALL_SQUARES) squares.push_back(pos);
+  ASSERT_EQ(squares.size(), 64);
+  EXPECT_EQ(squares.front(), Pos{"a1"});
+  EXPECT_EQ(squares[8], Pos{"a2"});
+  EXPECT_EQ(squares.back(), Pos{"h8"});
+}
+
+TEST(ITER, OccupiedSquares) {
+  Board b{"4k3/8/8/3p4/8/8/8/R3K3 w"};
+  std::vector<Pos> squares;
+  for (Pos pos : iter::squares_of(b.get_mailbox().occupancy(Side::WHITE))) squares.push_back(pos);
+  EXPECT_EQ(squares, (std::vector<Pos>{{"a1"}, {"e1"}}));
+}
+
+namespace {
+MovesT all_moves(const Board& b) {
+  MovesT moves;
+  for (Pos pos : iter::ALL_SQUARES) {
+    auto piece = b.get(pos);
+    if (!piece.has_value() || piece->side != b.get_state().turn) continue;
+    MovesT res = b.get_moves(pos);
+    moves.insert(moves.end(), res.begin(), res.end());
+  }
+  return moves;
+}
+
+MovesT lazy_moves(const Board& b) {
+  MovesT moves;
+  for (const Move& m : iter::LegalMoves{b}) moves.push_back(m);
+  return moves;
+}
+}  // namespace
+
+TEST(ITER, LegalMoves) {
+  Board b;
+  b.reset_position();
+  EXPECT_EQ(lazy_moves(b).size(), 20);
+
+  // pinned knight, king in check
+  Board b2{"4k3/8/8/8/1b6/8/3N4/4K3 w"};
+  EXPECT_EQ(lazy_moves(b2), all_moves(b2));
+
+  Board b3{"r3k2r/pppq1ppp/2n2n2/3pp3/1b2P3/2NP1N2/PPP2PPP/R1BQK2R w KQkq"};
+  EXPECT_EQ(lazy_moves(b3), all_moves(b3));
+
+  // mate, nothing to iterate
+  Board b4{"R5k1/5ppp/8/8/8/8/8/6K1 b"};
+  iter::LegalMoves moves{b4};
+  EXPECT_EQ(moves.begin(), moves.end());
+}
+
+TEST(ITER, StopEarly) {
+  Board b;
+  b.reset_position();
+  iter::LegalMoves moves{b};
+  auto it = moves.begin();
+  ASSERT_NE(it, moves.end());
+  Move first = *it;
+  EXPECT_EQ(first, lazy_moves(b).front());
+}
+
+#ifdef DWC_HAS_GENERATOR
+TEST(ITER, Coroutine) {
+  Board b{"r3k2r/pppq1ppp/2n2n2/3pp3/1b2P3/2NP1N2/PPP2PPP/R1BQK2R w KQkq"};
+  MovesT moves;
+  for (const Move& m : iter::legal_moves(b)) moves.push_back(m);
+  EXPECT_EQ(moves, lazy_moves(b));
+}
+#endif
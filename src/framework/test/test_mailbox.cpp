@@ -0,0 +1,63 @@
+#include <gtest/gtest.h>
+
+#include "src/framework/board.hpp"
+#include "src/framework/mailbox.hpp"
+
+using namespace dwc;
+
+TEST(MAILBOX, StartPosition) {
+  Board b;
+  b.reset_position();
+  const mailbox::Mailbox& mb = b.get_mailbox();
+
+  EXPECT_EQ(mb.occupancy(), 0xffff00000000ffffULL);
+  EXPECT_EQ(mb.occupancy(Side::WHITE), 0x000000000000ffffULL);
+  EXPECT_EQ(mb.occupancy(Side::BLACK), 0xffff000000000000ULL);
+  EXPECT_EQ(mb.occupancy({Type::PAWN, Side::BLACK}), 0x00ff000000000000ULL);
+
+  EXPECT_EQ(mb.find({Type::KING, Side::WHITE}), Pos{"e1"});
+  EXPECT_EQ(mb.find({Type::QUEEN, Side::BLACK}), Pos{"d8"});
+
+  auto counts = mb.counts();
+  auto count_of = [&counts](Type type, Side side) { return counts[Piece{type, side}.ordinal()]; };
+  EXPECT_EQ(count_of(Type::PAWN, Side::WHITE), 8);
+  EXPECT_EQ(count_of(Type::KNIGHT, Side::BLACK), 2);
+  EXPECT_EQ(count_of(Type::KING, Side::BLACK), 1);
+}
+
+TEST(MAILBOX, Empty) {
+  Board b;
+  const mailbox::Mailbox& mb = b.get_mailbox();
+  EXPECT_EQ(mb.occupancy(), 0);
+  EXPECT_FALSE(mb.find({Type::KING, Side::WHITE}).has_value());
+  EXPECT_EQ(mb.count({Type::ROOK, Side::BLACK}), 0);
+}
+
+TEST(MAILBOX, MatchesBoard) {
+  Board b{"r3k2r/pppq1ppp/2n2n2/3pp3/1b2P3/2NP1N2/PPP2PPP/R1BQK2R w KQkq"};
+  const mailbox::Mailbox& mb = b.get_mailbox();
+  for (size_t idx = 0; idx < 64; ++idx) {
+    Pos pos = Pos::from_index(idx);
+    EXPECT_EQ(mb.get(pos).has_value(), b.get(pos).has_value());
+    if (b.get(pos).has_value()) { EXPECT_EQ(*mb.get(pos), *b.get(pos)); }
+  }
+  EXPECT_EQ(mb.count({Type::KNIGHT, Side::WHITE}), 2);
+  EXPECT_EQ(mb.count({Type::BISHOP, Side::WHITE}), 1);
+}
+
+TEST(MAILBOX, FollowsMoves) {
+  Board b;
+  b.reset_position();
+  mailbox::Mailbox start = b.get_mailbox();
+
+  b.move({{"e2"}, {"e4"}});
+  b.move({{"d7"}, {"d5"}});
+  b.move({{"e4"}, {"d5"}});
+  EXPECT_EQ(b.get_mailbox(), mailbox::Mailbox{b.get_state().board});
+  EXPECT_EQ(b.get_mailbox().count({Type::PAWN, Side::BLACK}), 7);
+
+  b.undo_move();
+  b.undo_move();
+  b.undo_move();
+  EXPECT_EQ(b.get_mailbox(), start);
+}
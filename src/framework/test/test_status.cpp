@@ -0,0 +1,81 @@
+#include <gtest/gtest.h>
+
+#include "src/framework/board.hpp"
+
+using namespace dwc;
+
+TEST(STATUS, Ongoing) {
+  Board b;
+  b.reset_position();
+  EXPECT_TRUE(b.has_legal_move());
+  EXPECT_EQ(b.status(), GameStatus::ONGOING);
+}
+
+TEST(STATUS, Checkmate) {
+  // back rank mate
+  Board b{"R5k1/5ppp/8/8/8/8/8/6K1 b"};
+  EXPECT_FALSE(b.has_legal_move());
+  EXPECT_EQ(b.status(), GameStatus::CHECKMATE);
+
+  // fool's mate
+  Board b2;
+  b2.reset_position();
+  b2.move({{"f2"}, {"f3"}});
+  b2.move({{"e7"}, {"e5"}});
+  b2.move({{"g2"}, {"g4"}});
+  EXPECT_EQ(b2.status(), GameStatus::ONGOING);
+  b2.move({{"d8"}, {"h4"}});
+  EXPECT_EQ(b2.status(), GameStatus::CHECKMATE);
+
+  // mate has priority over the 50 move rule
+  Board b3{"R5k1/5ppp/8/8/8/8/8/6K1 b - - 100 80"};
+  EXPECT_EQ(b3.status(), GameStatus::CHECKMATE);
+}
+
+TEST(STATUS, Stalemate) {
+  Board b{"7k/5Q2/6K1/8/8/8/8/8 b"};
+  EXPECT_FALSE(b.has_legal_move());
+  EXPECT_EQ(b.status(), GameStatus::STALEMATE);
+
+  // same position, white to move is fine
+  Board b2{"7k/5Q2/6K1/8/8/8/8/8 w"};
+  EXPECT_EQ(b2.status(), GameStatus::ONGOING);
+}
+
+TEST(STATUS, FiftyMoveAndRepetition) {
+  Board b{"8/4k3/8/8/2K5/8/5R2/8 w - - 100 80"};
+  EXPECT_EQ(b.status(), GameStatus::FIFTY_MOVE);
+
+  Board b2{"4k3/8/8/8/8/8/8/R3K3 w"};
+  for (int i = 0; i < 2; ++i) {
+    EXPECT_EQ(b2.status(), GameStatus::ONGOING);
+    b2.move({{"a1"}, {"a2"}});
+    b2.move({{"e8"}, {"d8"}});
+    b2.move({{"a2"}, {"a1"}});
+    b2.move({{"d8"}, {"e8"}});
+  }
+  EXPECT_EQ(b2.status(), GameStatus::REPETITION);
+}
+
+TEST(STATUS, InsufficientMaterial) {
+  struct test {
+    const char* fen;
+    bool insufficient;
+  };
+  std::vector<test> tests{
+      {"8/4k3/8/8/2K5/8/8/8 w", true},      // K v K
+      {"8/4k3/8/8/2K5/8/3N4/8 w", true},    // KN v K
+      {"8/4k3/8/8/2K5/8/3B4/8 w", true},    // KB v K
+      {"8/4k3/1b6/8/2K5/8/3B4/8 w", true},  // KB v KB, same colored bishops
+      {"8/4k3/b7/8/2K5/8/3B4/8 w", false},  // KB v KB, different colors
+      {"8/4k3/8/8/2K5/8/3NN3/8 w", false},  // KNN v K can still be mated with help
+      {"8/4k3/8/8/2K5/8/3P4/8 w", false},
+      {"8/4k3/8/8/2K5/8/3R4/8 w", false},
+      {"8/4k3/8/8/2K5/8/3q4/8 w", false},
+  };
+  for (auto t : tests) {
+    Board b{t.fen};
+    EXPECT_EQ(b.is_insufficient_material(), t.insufficient) << t.fen;
+    EXPECT_EQ(b.status() == GameStatus::INSUFFICIENT_MATERIAL, t.insufficient) << t.fen;
+  }
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include "basic_types.hpp"
+
+namespace dwc::zobrist {
+using KeyT = uint64_t;
+
+namespace _inner {
+constexpr uint64_t splitmix64(uint64_t& s) {
+  uint64_t z = (s += 0x9E3779B97F4A7C15ULL);
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+  return z ^ (z >> 31);
+}
+
+constexpr size_t PIECE_SIZE = cast_t(Type::SIZE) * cast_t(Side::SIZE);
+
+struct Keys {
+  std::array<std::array<KeyT, 64>, PIECE_SIZE> pieces{};
+  // indexed by Piece::ordinal() of the castling entry, only KING and QUEEN are used
+  std::array<KeyT, PIECE_SIZE> castling{};
+  KeyT black_to_move{};
+};
+
+constexpr Keys make_keys() {
+  Keys keys{};
+  uint64_t seed = 0x6477632D63686573ULL;  // "dwc-ches"
+  for (auto& piece_keys : keys.pieces) {
+    for (auto& k : piece_keys) { k = splitmix64(seed); }
+  }
+  for (auto& k : keys.castling) { k = splitmix64(seed); }
+  keys.black_to_move = splitmix64(seed);
+  return keys;
+}
+}  // namespace _inner
+
+inline constexpr _inner::Keys KEYS = _inner::make_keys();
+
+constexpr KeyT piece_key(Piece piece, Pos pos) {
+  return KEYS.pieces[piece.ordinal()][pos.index()];
+}
+
+constexpr KeyT castling_key(Piece castling) {
+  return KEYS.castling[castling.ordinal()];
+}
+
+constexpr KeyT turn_key(std::optional<Side> turn) {
+  return turn == Side::BLACK ? KEYS.black_to_move : 0;
+}
+
+// full computation, O(64)
+inline KeyT compute(const State& state) {
+  KeyT key = turn_key(state.turn);
+  for (size_t idx = 0; idx < 64; ++idx) {
+    Pos pos = Pos::from_index(idx);
+    auto piece = board_ut::get(pos, state.board);
+    if (piece.has_value()) { key ^= piece_key(*piece, pos); }
+  }
+  for (const auto& c : state.castling) { key ^= castling_key(c); }
+  return key;
+}
+
+}  // namespace dwc::zobrist
@@ -0,0 +1,159 @@
+#include "reader.hpp"
+
+#include <stdexcept>
+
+namespace dwc::pgn {
+namespace {
+constexpr std::string_view START_FEN = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq";
+constexpr std::string_view SPACES = " \t\r\n";
+constexpr std::string_view SEPARATORS = " \t\r\n.)}";
+
+bool is_result(std::string_view token) {
+  return token == "1-0" || token == "0-1" || token == "1/2-1/2" || token == "*";
+}
+
+// [Name "Value"]
+Tag parse_tag(std::string_view line) {
+  Tag tag;
+  size_t name_end = line.find_first_of(SPACES, 1);
+  tag.name = line.substr(1, name_end == std::string_view::npos ? std::string_view::npos : name_end - 1);
+  size_t open = line.find('"');
+  size_t close = line.rfind('"');
+  if (open != std::string_view::npos && close > open) tag.value = line.substr(open + 1, close - open - 1);
+  return tag;
+}
+
+std::string_view trim(std::string_view s) {
+  size_t b = s.find_first_not_of(SPACES);
+  if (b == std::string_view::npos) return {};
+  return s.substr(b, s.find_last_not_of(SPACES) - b + 1);
+}
+}  // namespace
+
+std::string_view Game::tag(std::string_view name) const {
+  for (const Tag& t : tags) {
+    if (t.name == name) return t.value;
+  }
+  return {};
+}
+
+std::string_view SanTokens::next() {
+  while (pos_ < text_.size()) {
+    char c = text_[pos_];
+    if (SEPARATORS.find(c) != std::string_view::npos) {
+      // including unbalanced closing brackets
+      ++pos_;
+    } else if (c == '{') {
+      size_t end = text_.find('}', pos_);
+      pos_ = end == std::string_view::npos ? text_.size() : end + 1;
+    } else if (c == ';') {
+      size_t end = text_.find('\n', pos_);
+      pos_ = end == std::string_view::npos ? text_.size() : end + 1;
+    } else if (c == '(') {
+      // variations nest
+      int depth = 0;
+      for (; pos_ < text_.size(); ++pos_) {
+        if (text_[pos_] == '{') {
+          size_t end = text_.find('}', pos_);
+          pos_ = end == std::string_view::npos ? text_.size() - 1 : end;
+        } else if (text_[pos_] == '(') {
+          ++depth;
+        } else if (text_[pos_] == ')' && --depth == 0) {
+          ++pos_;
+          break;
+        }
+      }
+    } else if (c == '$') {
+      ++pos_;
+      while (pos_ < text_.size() && '0' <= text_[pos_] && text_[pos_] <= '9') ++pos_;
+    } else {
+      // dots end a token, so "12." and "12...e5" leave the bare move number
+      size_t end = text_.find_first_of(" \t\r\n{};()$.", pos_);
+      if (end == std::string_view::npos) end = text_.size();
+      std::string_view token = text_.substr(pos_, end - pos_);
+      pos_ = end;
+      if (is_result(token)) {
+        pos_ = text_.size();
+        return {};
+      }
+      if (token.find_first_not_of("0123456789") == std::string_view::npos) continue;
+      return token;
+    }
+  }
+  return {};
+}
+
+bool GameReader::next() {
+  game_.tags.clear();
+  game_.movetext = {};
+
+  // blank lines between games
+  size_t start = data_.find_first_not_of(SPACES, pos_);
+  if (start == std::string_view::npos) {
+    pos_ = data_.size();
+    return false;
+  }
+  pos_ = start;
+
+  auto next_line = [this](size_t at) {
+    size_t end = data_.find('\n', at);
+    return end == std::string_view::npos ? data_.size() : end + 1;
+  };
+
+  // tag section
+  while (pos_ < data_.size() && data_[pos_] == '[') {
+    size_t end = next_line(pos_);
+    game_.tags.push_back(parse_tag(trim(data_.substr(pos_, end - pos_))));
+    pos_ = end;
+  }
+
+  // movetext, up to the next tag section; a '[' inside a comment doesn't count
+  size_t movetext_start = pos_;
+  bool in_comment = false;
+  while (pos_ < data_.size()) {
+    if (!in_comment && data_[pos_] == '[') break;
+    size_t end = next_line(pos_);
+    for (size_t i = pos_; i < end; ++i) {
+      if (data_[i] == '{') in_comment = true;
+      if (data_[i] == '}') in_comment = false;
+    }
+    pos_ = end;
+  }
+
+  game_.movetext = trim(data_.substr(movetext_start, pos_ - movetext_start));
+  game_.text = trim(data_.substr(start, pos_ - start));
+  return true;
+}
+
+namespace _inner {
+bool setup(const Game& game, Board& board) {
+  static const Board START{START_FEN};
+  std::string_view fen = game.tag("FEN");
+  if (fen.empty()) {
+    board = START;
+    return true;
+  }
+  try {
+    board = Board{fen};
+  } catch (const std::exception&) {
+    return false;
+  }
+  return true;
+}
+}  // namespace _inner
+
+std::vector<std::string_view> split_games(std::string_view data, size_t parts) {
+  constexpr std::string_view EVENT = "\n[Event ";
+  std::vector<std::string_view> slices;
+  size_t begin = 0;
+  for (size_t p = 1; p < parts && begin < data.size(); ++p) {
+    size_t cut = data.find(EVENT, std::max(begin, data.size() * p / parts));
+    if (cut == std::string_view::npos) break;
+    slices.push_back(data.substr(begin, cut + 1 - begin));
+    begin = cut + 1;
+  }
+  slices.push_back(data.substr(begin));
+  return slices;
+}
+
+}  // namespace dwc::pgn
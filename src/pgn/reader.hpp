@@ -0,0 +1,146 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "src/framework/board.hpp"
+#include "src/pgn/san.hpp"
+#include "src/shared/mapped_file.hpp"
+
+// Streaming PGN reading. Games are views into the caller's buffer, typically a memory mapped file, nothing is copied
+// per game: GameReader reuses one Game and its tag storage while iterating.
+
+namespace dwc::pgn {
+
+struct Tag {
+  std::string_view name;
+  std::string_view value;  // without the quotes, escapes kept as is
+};
+
+struct Game {
+  std::string_view text;  // the whole game
+  std::vector<Tag> tags;
+  std::string_view movetext;
+
+  // empty if missing
+  std::string_view tag(std::string_view name) const;
+};
+
+// SAN tokens of a movetext, skipping move numbers, comments, variations, NAGs and the result
+class SanTokens {
+  std::string_view text_;
+  size_t pos_{0};
+
+ public:
+  explicit SanTokens(std::string_view movetext) : text_(movetext) {}
+  // empty at the end
+  std::string_view next();
+};
+
+// lazy, single pass iteration over the games of data
+class GameReader {
+  std::string_view data_;
+  size_t pos_{0};
+  Game game_;
+
+ public:
+  explicit GameReader(std::string_view data) : data_(data) {}
+
+  // false at the end, the previous game's views into data stay valid
+  bool next();
+  const Game& game() const { return game_; }
+
+  class iterator {
+    GameReader* reader_;
+
+   public:
+    explicit iterator(GameReader* reader) : reader_(reader) {}
+    const Game& operator*() const { return reader_->game(); }
+    iterator& operator++() {
+      if (!reader_->next()) reader_ = nullptr;
+      return *this;
+    }
+    bool operator==(const iterator& o) const { return reader_ == o.reader_; }
+    bool operator!=(const iterator& o) const { return !(*this == o); }
+  };
+
+  iterator begin() { return ++iterator{this}; }
+  iterator end() { return iterator{nullptr}; }
+};
+
+struct ReplayResult {
+  size_t plies{0};
+  std::string_view failed;  // the token that couldn't be played (or the FEN tag), empty if the whole game was played
+  bool ok() const { return failed.empty(); }
+};
+
+namespace _inner {
+// start position, or the FEN tag; false if the FEN doesn't parse
+bool setup(const Game& game, Board& board);
+}  // namespace _inner
+
+// plays the game from its start position, calling on_move(board, move) before every move is made and on_end(board)
+// with the last position reached, also when a move fails
+template <typename F, typename E>
+ReplayResult replay(const Game& game, F&& on_move, E&& on_end) {
+  ReplayResult res;
+  Board board;
+  if (!_inner::setup(game, board)) {
+    res.failed = game.tag("FEN");
+    return res;
+  }
+  SanTokens tokens{game.movetext};
+  for (std::string_view san = tokens.next(); !san.empty(); san = tokens.next()) {
+    auto move = parse_san(board, san);
+    if (!move.has_value()) {
+      res.failed = san;
+      break;
+    }
+    on_move(static_cast<const Board&>(board), *move);
+    board.apply_move(*move);
+    ++res.plies;
+  }
+  on_end(static_cast<const Board&>(board));
+  return res;
+}
+
+template <typename F>
+ReplayResult replay(const Game& game, F&& on_move) {
+  return replay(game, std::forward<F>(on_move), [](const Board&) {});
+}
+
+inline ReplayResult replay(const Game& game) {
+  return replay(game, [](const Board&, Move) {});
+}
+
+// splits data into at most parts slices, each starting at an "[Event " tag line, so each slice holds whole games.
+// Files without Event tags aren't split.
+std::vector<std::string_view> split_games(std::string_view data, size_t parts);
+
+// f(game, worker) for every game of data, the slices of split_games() read by one thread each
+template <typename F>
+void for_each_game(std::string_view data, size_t threads, const F& f) {
+  auto slices = split_games(data, std::max<size_t>(1, threads));
+  std::vector<std::thread> pool;
+  auto work = [&slices, &f](size_t worker) {
+    GameReader reader{slices[worker]};
+    for (const Game& game : reader) f(game, worker);
+  };
+  for (size_t w = 1; w < slices.size(); ++w) pool.emplace_back(work, w);
+  work(0);
+  for (auto& t : pool) t.join();
+}
+
+// memory mapped pgn file
+class PgnFile {
+  utils::MappedFile file_;
+
+ public:
+  explicit PgnFile(const std::string& path) : file_(path) {}
+  std::string_view data() const { return {reinterpret_cast<const char*>(file_.data()), file_.size()}; }
+};
+
+}  // namespace dwc::pgn
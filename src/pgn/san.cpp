@@ -0,0 +1,154 @@
+#include "san.hpp"
+
+#include "src/framework/attack_tables.hpp"
+#include "src/framework/square_iter.hpp"
+
+namespace dwc::pgn {
+namespace {
+std::optional<Type> type_of(char c) {
+  switch (c) {
+    case 'N': return Type::KNIGHT;
+    case 'B': return Type::BISHOP;
+    case 'R': return Type::ROOK;
+    case 'Q': return Type::QUEEN;
+    case 'K': return Type::KING;
+    default: return std::nullopt;
+  }
+}
+
+bool is_file(char c) {
+  return 'a' <= c && c <= 'h';
+}
+
+bool is_rank(char c) {
+  return '1' <= c && c <= '8';
+}
+
+constexpr std::array<char, cast_t(Type::SIZE)> TYPE_CHARS{'P', 'N', 'B', 'R', 'Q', 'K'};
+
+// the castling right if move castles
+std::optional<Type> castling_of(const Board& board, Piece piece, Move move) {
+  if (piece.type != Type::KING) return std::nullopt;
+  const State& state = board.get_state();
+  for (Type right : {Type::KING, Type::QUEEN}) {
+    if (state.castling.find({right, piece.side}) == state.castling.end()) continue;
+    const CastleInfo& ci = state.castling_rules[{right, piece.side}];
+    if (ci.king_from == move.fr.index() && ci.move_to == move.to.index()) return right;
+  }
+  return std::nullopt;
+}
+
+std::optional<Move> parse_castling(const Board& board, Type right) {
+  const State& state = board.get_state();
+  Side side = state.turn.value_or(Side::WHITE);
+  if (state.castling.find({right, side}) == state.castling.end()) return std::nullopt;
+  const CastleInfo& ci = state.castling_rules[{right, side}];
+  Move move{Pos::from_index(ci.king_from), Pos::from_index(ci.move_to)};
+
+  MovesT moves;
+  board.get_pseudo_moves(move.fr, moves);
+  if (!utils::contains(moves, move) || board.is_king_threatened_after(move)) return std::nullopt;
+  return move;
+}
+}  // namespace
+
+std::optional<Move> parse_san(const Board& board, std::string_view san) {
+  // check, mate and annotation suffixes
+  while (!san.empty() && (san.back() == '+' || san.back() == '#' || san.back() == '!' || san.back() == '?')) {
+    san.remove_suffix(1);
+  }
+  if (san == "O-O" || san == "0-0") return parse_castling(board, Type::KING);
+  if (san == "O-O-O" || san == "0-0-0") return parse_castling(board, Type::QUEEN);
+  // promotions, "e8=Q" or "e8Q"
+  if (san.find('=') != std::string_view::npos) return std::nullopt;
+  if (san.size() < 2) return std::nullopt;
+
+  Type type = Type::PAWN;
+  if (auto t = type_of(san.front())) {
+    type = *t;
+    san.remove_prefix(1);
+  }
+  if (san.size() < 2 || !is_file(san[san.size() - 2]) || !is_rank(san.back())) return std::nullopt;
+  Pos to{san.substr(san.size() - 2)};
+  san.remove_suffix(2);
+
+  // what's left: optional disambiguation file / rank, optional capture
+  std::optional<char> file;
+  std::optional<char> rank;
+  bool capture = false;
+  for (char c : san) {
+    if (c == 'x') {
+      capture = true;
+    } else if (is_file(c) && !file.has_value() && !rank.has_value()) {
+      file = c;
+    } else if (is_rank(c) && !rank.has_value()) {
+      rank = c;
+    } else {
+      return std::nullopt;
+    }
+  }
+  auto target = board.get(to);
+  // a pawn capturing to an empty square would be en passant
+  if (capture != target.has_value()) return std::nullopt;
+
+  Side side = board.get_state().turn.value_or(Side::WHITE);
+  std::optional<Move> found;
+  MovesT moves;
+  for (Pos fr : iter::squares_of(board.get_mailbox().occupancy(Piece{type, side}))) {
+    if (file.has_value() && fr.file != *file - 'a') continue;
+    if (rank.has_value() && fr.rank != *rank - '1') continue;
+    moves.clear();
+    board.get_pseudo_moves(fr, moves);
+    Move move{fr, to};
+    if (!utils::contains(moves, move) || board.is_king_threatened_after(move)) continue;
+    if (found.has_value()) return std::nullopt;  // ambiguous
+    found = move;
+  }
+  return found;
+}
+
+char* write_san(const Board& board, Move move, char* out, bool with_suffix) {
+  Piece piece = board.get(move.fr).value();
+  if (auto right = castling_of(board, piece, move)) {
+    for (char c : std::string_view{*right == Type::KING ? "O-O" : "O-O-O"}) *out++ = c;
+  } else {
+    bool capture = board.get(move.to).has_value();
+    if (piece.type == Type::PAWN) {
+      if (capture) *out++ = static_cast<char>('a' + move.fr.index() % 8);
+    } else {
+      *out++ = TYPE_CHARS[cast_t(piece.type)];
+      // same pieces attacking the target square, the pinned ones don't count
+      const mailbox::Mailbox& mb = board.get_mailbox();
+      attack::BitboardT others = mb.occupancy(piece) & attack::attacks(piece, move.to, mb.occupancy());
+      others &= ~attack::bit(move.fr);
+      bool same_file = false;
+      bool same_rank = false;
+      bool any = false;
+      for (Pos o : iter::squares_of(others)) {
+        if (board.is_king_threatened_after({o, move.to})) continue;
+        any = true;
+        same_file |= o.file == move.fr.file;
+        same_rank |= o.rank == move.fr.rank;
+      }
+      if (any && (!same_file || same_rank)) *out++ = static_cast<char>('a' + move.fr.index() % 8);
+      if (same_file) *out++ = static_cast<char>('1' + move.fr.index() / 8);
+    }
+    if (capture) *out++ = 'x';
+    out = write_square(move.to, out);
+  }
+
+  if (with_suffix) {
+    Board after = board;
+    after.apply_move(move);
+    Side opp = piece.side == Side::WHITE ? Side::BLACK : Side::WHITE;
+    if (after.is_king_threatened(opp)) *out++ = after.has_legal_move() ? '+' : '#';
+  }
+  return out;
+}
+
+std::string to_san(const Board& board, Move move, bool with_suffix) {
+  char buf[SAN_MAX];
+  return {buf, write_san(board, move, buf, with_suffix)};
+}
+
+}  // namespace dwc::pgn
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "src/framework/board.hpp"
+
+namespace dwc::pgn {
+
+// Standard algebraic notation, e.g. "Nbd7", "exd5", "O-O", "Qh4#", resolved against the legal moves of board.
+// Only the pieces of the given type are expanded, and the own king check only runs for the matching moves.
+// nullopt for malformed, illegal or ambiguous moves, and for promotions and en passant which Board doesn't play yet.
+std::optional<Move> parse_san(const Board& board, std::string_view san);
+
+// buffer size write_san needs at most; UCI moves are written by dwc::write_uci
+constexpr size_t SAN_MAX = 8;
+
+// SAN of a legal move of board, e.g. "Nbd2". Other pieces that could go to the same square are found with the attack
+// tables, only those get the own king check. The '+' / '#' suffix plays the move on a copy of the board, so it's only
+// computed when with_suffix is set. Writes to out and returns the end of the written chars.
+char* write_san(const Board& board, Move move, char* out, bool with_suffix = false);
+
+// allocating convenience of write_san
+std::string to_san(const Board& board, Move move, bool with_suffix = false);
+
+}  // namespace dwc::pgn
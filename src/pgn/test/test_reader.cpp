@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+
+#include "src/pgn/reader.hpp"
+
+using namespace dwc;
+using namespace dwc::pgn;
+
+namespace {
+constexpr std::string_view PGN = R"([Event "Casual"]
+[White "A"]
+[Black "B"]
+[Result "1-0"]
+
+1. e4 e5 2. Qh5 Nc6 3. Bc4 Nf6?? 4. Qxf7# 1-0
+
+[Event "With comments"]
+[Result "*"]
+
+1. d4 {a comment
+[%clk 0:01:00] spanning lines} d5 2. c4 (2. Nf3 Nf6 (2... c5) 3. c4) 2... e6 $1 ; rest of line
+3. Nc3 *
+[Event "Position"]
+[FEN "4k3/8/8/8/8/8/8/R3K3 w Q"]
+
+1. O-O-O Ke7 2. Kb1 1/2-1/2
+
+[Event "Broken"]
+
+1. e4 e5 2. Ke3 Nc6 *
+)";
+
+std::vector<std::string> sans(std::string_view movetext) {
+  std::vector<std::string> res;
+  SanTokens tokens{movetext};
+  for (auto t = tokens.next(); !t.empty(); t = tokens.next()) res.emplace_back(t);
+  return res;
+}
+}  // namespace
+
+TEST(PGN, Tokens) {
+  EXPECT_EQ(sans("1. e4 e5 2.Nf3 Nc6 3... Bb5 1-0"), (std::vector<std::string>{"e4", "e5", "Nf3", "Nc6", "Bb5"}));
+  EXPECT_EQ(sans("1. e4 {x} (1. d4 d5 (1... Nf6)) 1... c5 $14 2. O-O ; c\n 2... 0-0-0 *"),
+            (std::vector<std::string>{"e4", "c5", "O-O", "0-0-0"}));
+  EXPECT_EQ(sans(""), (std::vector<std::string>{}));
+  EXPECT_EQ(sans("12. e4) }"), (std::vector<std::string>{"e4"}));
+}
+
+TEST(PGN, Games) {
+  GameReader reader{PGN};
+  std::vector<std::string_view> events;
+  std::vector<ReplayResult> results;
+  for (const Game& game : reader) {
+    events.push_back(game.tag("Event"));
+    results.push_back(replay(game));
+  }
+  ASSERT_EQ(events, (std::vector<std::string_view>{"Casual", "With comments", "Position", "Broken"}));
+
+  EXPECT_TRUE(results[0].ok());
+  EXPECT_EQ(results[0].plies, 7);
+  EXPECT_TRUE(results[1].ok());
+  EXPECT_EQ(results[1].plies, 5);
+  EXPECT_TRUE(results[2].ok());
+  EXPECT_EQ(results[2].plies, 3);
+  EXPECT_FALSE(results[3].ok());
+  EXPECT_EQ(results[3].failed, "Ke3");
+  EXPECT_EQ(results[3].plies, 2);
+}
+
+TEST(PGN, Replay) {
+  GameReader reader{PGN};
+  ASSERT_TRUE(reader.next());
+  const Game& game = reader.game();
+  EXPECT_EQ(game.tag("White"), "A");
+  EXPECT_EQ(game.tag("Missing"), "");
+  EXPECT_EQ(game.movetext.substr(0, 5), "1. e4");
+  // views into the buffer, no copies
+  EXPECT_GE(game.text.data(), PGN.data());
+  EXPECT_LT(game.text.data(), PGN.data() + PGN.size());
+
+  std::vector<Move> moves;
+  Board last;
+  replay(game, [&](const Board& b, Move m) {
+    moves.push_back(m);
+    last = b;
+  });
+  ASSERT_EQ(moves.size(), 7);
+  EXPECT_EQ(moves.front(), (Move{Pos{"e2"}, Pos{"e4"}}));
+  last.apply_move(moves.back());
+  EXPECT_EQ(last.status(), GameStatus::CHECKMATE);
+}
+
+TEST(PGN, Parallel) {
+  std::string many;
+  for (int i = 0; i < 200; ++i) many += std::string{PGN} + "\n";
+
+  auto slices = split_games(many, 4);
+  EXPECT_EQ(slices.size(), 4);
+  size_t total = 0;
+  for (auto s : slices) {
+    total += s.size();
+    EXPECT_EQ(s.substr(0, 7), "[Event ");
+  }
+  EXPECT_EQ(total, many.size());
+
+  std::atomic<size_t> games{0};
+  std::atomic<size_t> plies{0};
+  for_each_game(many, 4, [&](const Game& game, size_t) {
+    ++games;
+    plies += replay(game).plies;
+  });
+  EXPECT_EQ(games, 800);
+  EXPECT_EQ(plies, 200 * (7 + 5 + 3 + 2));
+
+  EXPECT_EQ(split_games("", 4).size(), 1);
+  EXPECT_EQ(split_games("1. e4 e5 *", 4).size(), 1);
+}
@@ -0,0 +1,134 @@
+#include <gtest/gtest.h>
+
+#include "src/framework/square_iter.hpp"
+#include "src/pgn/san.hpp"
+
+using namespace dwc;
+using namespace dwc::pgn;
+
+namespace {
+Move mv(std::string_view fr, std::string_view to) {
+  return {Pos{fr}, Pos{to}};
+}
+}  // namespace
+
+TEST(SAN, Basic) {
+  Board b;
+  b.reset_position();
+  EXPECT_EQ(parse_san(b, "e4"), mv("e2", "e4"));
+  EXPECT_EQ(parse_san(b, "e3"), mv("e2", "e3"));
+  EXPECT_EQ(parse_san(b, "Nf3"), mv("g1", "f3"));
+  EXPECT_EQ(parse_san(b, "Nf3!?"), mv("g1", "f3"));
+  EXPECT_EQ(parse_san(b, "Ngf3"), mv("g1", "f3"));
+  EXPECT_EQ(parse_san(b, "e5"), std::nullopt);
+  EXPECT_EQ(parse_san(b, "Nd2"), std::nullopt);
+  EXPECT_EQ(parse_san(b, "Bc4"), std::nullopt);
+  EXPECT_EQ(parse_san(b, "exd3"), std::nullopt);
+  EXPECT_EQ(parse_san(b, ""), std::nullopt);
+  EXPECT_EQ(parse_san(b, "Zf3"), std::nullopt);
+  EXPECT_EQ(parse_san(b, "Nf9"), std::nullopt);
+}
+
+TEST(SAN, CaptureAndCheck) {
+  Board b{"rnbqkbnr/ppp1pppp/8/3p4/4P3/8/PPPP1PPP/RNBQKBNR w KQkq"};
+  EXPECT_EQ(parse_san(b, "exd5"), mv("e4", "d5"));
+  EXPECT_EQ(parse_san(b, "ed5"), std::nullopt);  // capture without x
+  EXPECT_EQ(parse_san(b, "Bb5+"), mv("f1", "b5"));
+  EXPECT_EQ(parse_san(b, "Qh5"), mv("d1", "h5"));
+
+  Board mate{"6k1/5ppp/8/8/8/8/8/R5K1 w"};
+  EXPECT_EQ(parse_san(mate, "Ra8#"), mv("a1", "a8"));
+}
+
+TEST(SAN, Disambiguation) {
+  // knights on b1 and f3 both reach d2, rooks on a1 and a5 both reach a3
+  Board b{"4k3/8/8/R7/8/8/8/RN2KN2 w"};
+  Board b2{"4k3/8/8/R7/8/5N2/8/RN2K3 w"};
+  EXPECT_EQ(parse_san(b2, "Nd2"), std::nullopt);
+  EXPECT_EQ(parse_san(b2, "Nbd2"), mv("b1", "d2"));
+  EXPECT_EQ(parse_san(b2, "Nfd2"), mv("f3", "d2"));
+  EXPECT_EQ(parse_san(b2, "Nf3d2"), mv("f3", "d2"));
+  EXPECT_EQ(parse_san(b, "Ra3"), std::nullopt);
+  EXPECT_EQ(parse_san(b, "R1a3"), mv("a1", "a3"));
+  EXPECT_EQ(parse_san(b, "R5a3"), mv("a5", "a3"));
+
+  // the pinned knight doesn't count
+  Board pinned{"4k3/8/8/8/1b6/8/3N4/4K1N1 w"};
+  EXPECT_EQ(parse_san(pinned, "Nf3"), mv("g1", "f3"));
+}
+
+TEST(SAN, Castling) {
+  Board b{"r3k2r/pppq1ppp/2n2n2/3pp3/1b2P3/2NP1N2/PPPBQPPP/R3K2R w KQkq"};
+  EXPECT_EQ(parse_san(b, "O-O"), mv("e1", "g1"));
+  EXPECT_EQ(parse_san(b, "0-0-0"), mv("e1", "c1"));
+  Board no_rights{"r3k2r/pppq1ppp/2n2n2/3pp3/1b2P3/2NP1N2/PPPBQPPP/R3K2R w kq"};
+  EXPECT_EQ(parse_san(no_rights, "O-O"), std::nullopt);
+  Board black{"r3k2r/pppq1ppp/2n2n2/3pp3/1b2P3/2NP1N2/PPPBQPPP/R3K2R b KQkq"};
+  EXPECT_EQ(parse_san(black, "O-O-O+"), mv("e8", "c8"));
+}
+
+TEST(SAN, Unsupported) {
+  Board promo{"4k3/1P6/8/8/8/8/8/4K3 w"};
+  EXPECT_EQ(parse_san(promo, "b8=Q+"), std::nullopt);
+  EXPECT_EQ(parse_san(promo, "b8Q"), std::nullopt);
+  Board ep{"4k3/8/8/3Pp3/8/8/8/4K3 w"};
+  EXPECT_EQ(parse_san(ep, "dxe6"), std::nullopt);
+}
+
+TEST(SAN, Write) {
+  Board b;
+  b.reset_position();
+  EXPECT_EQ(to_san(b, mv("e2", "e4")), "e4");
+  EXPECT_EQ(to_san(b, mv("g1", "f3")), "Nf3");
+
+  char buf[SAN_MAX];
+  char* end = write_san(b, mv("b1", "c3"), buf);
+  EXPECT_EQ(std::string_view(buf, end - buf), "Nc3");
+
+  Board cap{"rnbqkbnr/ppp1pppp/8/3p4/4P3/8/PPPP1PPP/RNBQKBNR w KQkq"};
+  EXPECT_EQ(to_san(cap, mv("e4", "d5")), "exd5");
+  EXPECT_EQ(to_san(cap, mv("f1", "b5")), "Bb5");
+  EXPECT_EQ(to_san(cap, mv("f1", "b5"), true), "Bb5+");
+
+  Board mate{"6k1/5ppp/8/8/8/8/8/R5K1 w"};
+  EXPECT_EQ(to_san(mate, mv("a1", "a8"), true), "Ra8#");
+
+  Board castle{"r3k2r/pppq1ppp/2n2n2/3pp3/1b2P3/2NP1N2/PPPBQPPP/R3K2R w KQkq"};
+  EXPECT_EQ(to_san(castle, mv("e1", "g1")), "O-O");
+  EXPECT_EQ(to_san(castle, mv("e1", "c1")), "O-O-O");
+}
+
+TEST(SAN, WriteDisambiguation) {
+  Board files{"4k3/8/8/R7/8/5N2/8/RN2K3 w"};
+  EXPECT_EQ(to_san(files, mv("b1", "d2")), "Nbd2");
+  EXPECT_EQ(to_san(files, mv("a1", "a3")), "R1a3");
+  EXPECT_EQ(to_san(files, mv("a5", "a3")), "R5a3");
+  EXPECT_EQ(to_san(files, mv("a1", "a2")), "R1a2");
+  EXPECT_EQ(to_san(files, mv("b1", "a3")), "Na3");
+
+  // queens on a1, a3 and c1 all reach c3
+  Board both{"4k3/8/8/8/8/Q7/8/Q1Q1K3 w"};
+  EXPECT_EQ(to_san(both, mv("a1", "c3")), "Qa1c3");
+  EXPECT_EQ(to_san(both, mv("a3", "c3")), "Q3c3");
+  EXPECT_EQ(to_san(both, mv("c1", "c3")), "Qcc3");
+
+  // blocked and pinned pieces don't need disambiguation
+  Board blocked{"4k3/8/8/8/8/8/8/R1N1R1K1 w"};
+  EXPECT_EQ(to_san(blocked, mv("e1", "d1")), "Rd1");
+  Board pinned{"4k3/8/8/8/1b6/8/3N4/4K1N1 w"};
+  EXPECT_EQ(to_san(pinned, mv("g1", "f3")), "Nf3");
+}
+
+TEST(SAN, RoundTrip) {
+  for (std::string_view fen : {"r3k2r/pppq1ppp/2n2n2/3pp3/1b2P3/2NP1N2/PPP2PPP/R1BQK2R w KQkq",
+                               "2rq1rk1/pp2bppp/2n1pn2/3p4/3P4/2NBPN2/PP3PPP/R2Q1RK1 b", "4k3/8/8/R7/8/5N2/8/RN2K3 w",
+                               "4k3/8/8/8/8/Q7/8/Q1Q1K3 w"}) {
+    Board b{fen};
+    for (Pos pos : iter::squares_of(b.get_mailbox().occupancy(b.get_state().turn.value()))) {
+      for (const Move& m : b.get_moves(pos)) {
+        std::string san = to_san(b, m, true);
+        EXPECT_EQ(parse_san(b, san), m) << fen << " " << san;
+      }
+    }
+  }
+}
@@ -0,0 +1,44 @@
+#include "arena.hpp"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace dwc::utils {
+
+void* ArenaResource::do_allocate(size_t bytes, size_t align) {
+  return arena_->allocate(bytes, align);
+}
+
+void* Arena::allocate(size_t bytes, size_t align) {
+  // first fit from the current block on, blocks too small for a large request are skipped until the next rewind
+  for (; block_ < blocks_.size(); ++block_, used_ = 0) {
+    Block& b = blocks_[block_];
+    size_t at = (reinterpret_cast<uintptr_t>(b.data.get()) + used_ + align - 1) / align * align -
+                reinterpret_cast<uintptr_t>(b.data.get());
+    if (at + bytes <= b.size) {
+      used_ = at + bytes;
+      return b.data.get() + at;
+    }
+  }
+
+  size_t size = std::max(block_size_, bytes + align);
+  // not value initialized, unlike make_unique
+  blocks_.push_back({std::unique_ptr<std::byte[]>(new std::byte[size]), size});
+  ++block_allocations_;
+  block_ = blocks_.size() - 1;
+  used_ = 0;
+  return allocate(bytes, align);
+}
+
+size_t Arena::capacity() const {
+  size_t n = 0;
+  for (const Block& b : blocks_) n += b.size;
+  return n;
+}
+
+Arena& thread_arena() {
+  thread_local Arena arena;
+  return arena;
+}
+
+}  // namespace dwc::utils
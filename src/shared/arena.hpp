@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+namespace dwc::utils {
+
+class Arena;
+
+// std::pmr adapter of an Arena, deallocation is a no-op
+class ArenaResource : public std::pmr::memory_resource {
+  Arena* arena_;
+
+  void* do_allocate(size_t bytes, size_t align) override;
+  void do_deallocate(void*, size_t, size_t) override {}
+  bool do_is_equal(const std::pmr::memory_resource& o) const noexcept override { return this == &o; }
+
+ public:
+  explicit ArenaResource(Arena& arena) : arena_(&arena) {}
+};
+
+// Bump allocator over a list of blocks. Allocating bumps a pointer, memory is only given back in bulk by rewind() or
+// reset(), and the blocks stay around for the next round. Once warm, work that needs about the same scratch memory
+// every time never calls into malloc. Not thread safe, see thread_arena().
+class Arena {
+ public:
+  static constexpr size_t DEFAULT_BLOCK_SIZE = 64 << 10;
+
+  // position to rewind to
+  struct Mark {
+    size_t block;
+    size_t used;
+  };
+
+ private:
+  struct Block {
+    std::unique_ptr<std::byte[]> data;
+    size_t size;
+  };
+
+  std::vector<Block> blocks_;
+  size_t block_{0};  // block allocated from
+  size_t used_{0};   // bytes used of it
+  size_t block_size_;
+  size_t block_allocations_{0};
+  ArenaResource resource_{*this};
+
+ public:
+  explicit Arena(size_t block_size = DEFAULT_BLOCK_SIZE) : block_size_(block_size) {}
+  Arena(const Arena&) = delete;
+  Arena& operator=(const Arena&) = delete;
+
+  void* allocate(size_t bytes, size_t align = alignof(std::max_align_t));
+
+  Mark mark() const { return {block_, used_}; }
+  // everything allocated after m is free again
+  void rewind(Mark m) {
+    block_ = m.block;
+    used_ = m.used;
+  }
+  void reset() { rewind({0, 0}); }
+
+  // blocks taken from the global allocator so far, stays flat once warm
+  size_t block_allocations() const { return block_allocations_; }
+  size_t capacity() const;
+
+  std::pmr::memory_resource* resource() { return &resource_; }
+};
+
+// the calling thread's arena, for scratch memory that doesn't outlive the call using it
+Arena& thread_arena();
+
+// Gives back everything allocated from the arena during the scope. Scopes nest, so memory allocated before the scope
+// must not be grown from inside it (it would be rewound along).
+class ArenaScope {
+  Arena& arena_;
+  Arena::Mark mark_;
+
+ public:
+  explicit ArenaScope(Arena& arena = thread_arena()) : arena_(arena), mark_(arena.mark()) {}
+  ~ArenaScope() { arena_.rewind(mark_); }
+  ArenaScope(const ArenaScope&) = delete;
+  ArenaScope& operator=(const ArenaScope&) = delete;
+
+  std::pmr::memory_resource* resource() const { return arena_.resource(); }
+};
+
+}  // namespace dwc::utils
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace dwc::utils {
+
+// Event counters for the enum ENUM (values 0 to ENUM::SIZE - 1).
+// Every thread bumps its own block without contention, snapshot() merges the blocks of live threads with the totals
+// of threads that already exited.
+template <typename ENUM>
+class Counters {
+ public:
+  static constexpr size_t SIZE = static_cast<size_t>(ENUM::SIZE);
+  using ValuesT = std::array<uint64_t, SIZE>;
+
+ private:
+  struct Block {
+    // only written by the owning thread, atomic so snapshot() can read them meanwhile
+    std::array<std::atomic<uint64_t>, SIZE> values{};
+  };
+
+  struct Registry {
+    std::mutex m;
+    std::vector<Block*> live;
+    ValuesT retired{};
+  };
+
+  static Registry& registry() {
+    static Registry r;
+    return r;
+  }
+
+  struct Local {
+    Block block;
+    Local() {
+      std::lock_guard lk(registry().m);
+      registry().live.push_back(&block);
+    }
+    ~Local() {
+      Registry& r = registry();
+      std::lock_guard lk(r.m);
+      for (size_t i = 0; i < SIZE; ++i) r.retired[i] += block.values[i].load(std::memory_order_relaxed);
+      r.live.erase(std::find(r.live.begin(), r.live.end(), &block));
+    }
+  };
+
+  static Block& local() {
+    thread_local Local l;
+    return l.block;
+  }
+
+ public:
+  static void add(ENUM e, uint64_t n = 1) {
+    auto& v = local().values[static_cast<size_t>(e)];
+    v.store(v.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+  }
+
+  static ValuesT snapshot() {
+    Registry& r = registry();
+    std::lock_guard lk(r.m);
+    ValuesT res = r.retired;
+    for (const Block* b : r.live) {
+      for (size_t i = 0; i < SIZE; ++i) res[i] += b->values[i].load(std::memory_order_relaxed);
+    }
+    return res;
+  }
+
+  // increments racing with a reset may get lost
+  static void reset() {
+    Registry& r = registry();
+    std::lock_guard lk(r.m);
+    r.retired = {};
+    for (Block* b : r.live) {
+      for (auto& v : b->values) v.store(0, std::memory_order_relaxed);
+    }
+  }
+};
+
+// adds the nanoseconds spent in the scope to counter e
+template <typename ENUM>
+class ScopedTimer {
+  ENUM e_;
+  std::chrono::steady_clock::time_point start_{std::chrono::steady_clock::now()};
+
+ public:
+  explicit ScopedTimer(ENUM e) : e_(e) {}
+  ~ScopedTimer() {
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_);
+    Counters<ENUM>::add(e_, static_cast<uint64_t>(ns.count()));
+  }
+  ScopedTimer(const ScopedTimer&) = delete;
+  ScopedTimer& operator=(const ScopedTimer&) = delete;
+};
+
+}  // namespace dwc::utils
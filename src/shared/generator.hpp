@@ -0,0 +1,68 @@
+#pragma once
+
+// Minimal lazy generator on C++20 coroutines, only available when the toolchain supports them
+// (e.g. bazel build --config=cpp20). Check DWC_HAS_GENERATOR before using it.
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+#define DWC_HAS_GENERATOR
+
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <utility>
+
+namespace dwc::utils {
+
+template <typename T>
+class Generator {
+ public:
+  struct promise_type {
+    std::optional<T> value;
+    std::exception_ptr error;
+
+    Generator get_return_object() { return Generator{std::coroutine_handle<promise_type>::from_promise(*this)}; }
+    std::suspend_always initial_suspend() noexcept { return {}; }
+    std::suspend_always final_suspend() noexcept { return {}; }
+    std::suspend_always yield_value(T v) {
+      value = std::move(v);
+      return {};
+    }
+    void return_void() {}
+    void unhandled_exception() { error = std::current_exception(); }
+  };
+
+  using HandleT = std::coroutine_handle<promise_type>;
+
+  class iterator {
+    HandleT h_;
+
+   public:
+    explicit iterator(HandleT h) : h_(h) {}
+    const T& operator*() const { return *h_.promise().value; }
+    iterator& operator++() {
+      h_.resume();
+      if (h_.promise().error) std::rethrow_exception(h_.promise().error);
+      return *this;
+    }
+    bool operator==(std::default_sentinel_t) const { return !h_ || h_.done(); }
+    bool operator!=(std::default_sentinel_t s) const { return !(*this == s); }
+  };
+
+  explicit Generator(HandleT h) : h_(h) {}
+  Generator(Generator&& o) noexcept : h_(std::exchange(o.h_, {})) {}
+  Generator(const Generator&) = delete;
+  Generator& operator=(const Generator&) = delete;
+  ~Generator() {
+    if (h_) h_.destroy();
+  }
+
+  // starts the coroutine, only call once
+  iterator begin() { return ++iterator{h_}; }
+  std::default_sentinel_t end() { return {}; }
+
+ private:
+  HandleT h_;
+};
+
+}  // namespace dwc::utils
+
+#endif
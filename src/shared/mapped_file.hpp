@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace dwc::utils {
+
+// Read only mapping of a whole file. Opening is O(1) whatever the size, pages are loaded lazily and shared with every
+// other process mapping the same file. Throws std::runtime_error if the file can't be opened.
+class MappedFile {
+  const uint8_t* data_{nullptr};
+  size_t size_{0};
+
+  void release();
+
+ public:
+  MappedFile() = default;
+  explicit MappedFile(const std::string& path);
+  ~MappedFile() { release(); }
+
+  MappedFile(MappedFile&& o) noexcept;
+  MappedFile& operator=(MappedFile&& o) noexcept;
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  const uint8_t* data() const { return data_; }
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+  // lookups will jump around, don't read ahead
+  void advise_random() const;
+};
+
+}  // namespace dwc::utils
@@ -1,16 +1,36 @@
 #pragma once
 
 #include <array>
+#include <optional>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
 
 namespace dwc::utils {
+namespace _inner {
+// (k0, v0, k1, v1, ...) -> {{k0, v0}, {k1, v1}, ...}
+template <typename K, typename V, typename TUPLE, size_t... I>
+constexpr std::array<std::pair<K, V>, sizeof...(I)> to_pairs_impl(const TUPLE& t, std::index_sequence<I...>) {
+  return {std::pair<K, V>{std::get<2 * I>(t), std::get<2 * I + 1>(t)}...};
+}
+
+template <typename K, typename V, typename... ARGS>
+constexpr std::array<std::pair<K, V>, sizeof...(ARGS) / 2> to_pairs(ARGS&&... args) {
+  static_assert(sizeof...(ARGS) % 2 == 0, "expecting key, value, key, value, ...");
+  return to_pairs_impl<K, V>(std::forward_as_tuple(args...), std::make_index_sequence<sizeof...(ARGS) / 2>{});
+}
+}  // namespace _inner
+
+// linear lookup, only needs == on the key, see SortedMap for larger tables
 template <typename K, typename V, size_t N>
 class Map {
  public:
   using data_t = std::array<std::pair<K, V>, N>;
-  // todo: construct from variadic params (K, V, K, V, ....)
   constexpr Map(const data_t& d) : data_(d) {}
+  template <typename... ARGS, typename = std::enable_if_t<sizeof...(ARGS) >= 2>>
+  constexpr Map(K k, V v, ARGS&&... rest) : data_(_inner::to_pairs<K, V>(k, v, std::forward<ARGS>(rest)...)) {}
+
   V operator[](K k) const {
-    // todo: make non linear complexity
     for (const auto& item : data_) {
       if (item.first == k) return item.second;
     }
@@ -22,4 +42,76 @@ class Map {
  private:
   data_t data_;
 };
+
+template <typename K, typename V, typename... REST>
+Map(K, V, REST...) -> Map<K, V, 1 + sizeof...(REST) / 2>;
+
+// Binary search lookup over an index sorted at construction. Needs < on the key, duplicated keys are rejected
+// (at compile time when constructed constexpr).
+template <typename K, typename V, size_t N>
+class SortedMap {
+ public:
+  using data_t = std::array<std::pair<K, V>, N>;
+  constexpr SortedMap(const data_t& d) : data_(d) { sort(); }
+  template <typename... ARGS, typename = std::enable_if_t<sizeof...(ARGS) >= 2>>
+  constexpr SortedMap(K k, V v, ARGS&&... rest) : data_(_inner::to_pairs<K, V>(k, v, std::forward<ARGS>(rest)...)) {
+    sort();
+  }
+
+  // nullptr if missing
+  constexpr const V* find(const K& k) const {
+    size_t lo = 0;
+    size_t hi = N;
+    while (lo < hi) {
+      size_t mid = lo + (hi - lo) / 2;
+      if (key(mid) < k) {
+        lo = mid + 1;
+      } else {
+        hi = mid;
+      }
+    }
+    return (lo < N && !(k < key(lo))) ? &data_[order_[lo]].second : nullptr;
+  }
+
+  constexpr std::optional<V> get(const K& k) const {
+    const V* v = find(k);
+    return v != nullptr ? std::optional<V>{*v} : std::nullopt;
+  }
+
+  constexpr bool contains(const K& k) const { return find(k) != nullptr; }
+
+  constexpr V operator[](const K& k) const {
+    const V* v = find(k);
+    if (v == nullptr) throw std::logic_error("no match for key");
+    return *v;
+  }
+
+  constexpr size_t size() const { return N; }
+
+ private:
+  data_t data_;
+  // data_ indices in key order, pairs aren't assignable in constexpr before C++20
+  std::array<size_t, N> order_{};
+
+  constexpr const K& key(size_t i) const { return data_[order_[i]].first; }
+
+  // insertion sort, constexpr friendly
+  constexpr void sort() {
+    for (size_t i = 0; i < N; ++i) order_[i] = i;
+    for (size_t i = 1; i < N; ++i) {
+      for (size_t j = i; j > 0 && key(j) < key(j - 1); --j) {
+        size_t tmp = order_[j];
+        order_[j] = order_[j - 1];
+        order_[j - 1] = tmp;
+      }
+    }
+    for (size_t i = 1; i < N; ++i) {
+      if (!(key(i - 1) < key(i))) throw std::logic_error("duplicated key");
+    }
+  }
+};
+
+template <typename K, typename V, typename... REST>
+SortedMap(K, V, REST...) -> SortedMap<K, V, 1 + sizeof...(REST) / 2>;
+
 }  // namespace dwc::utils
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <filesystem>
+#include <string>
+
+namespace test {
+// Fixture with an own empty directory dir_, removed after the test. It lives under ::testing::TempDir(), Bazel's
+// TEST_TMPDIR, and is named after the test and the process, so concurrent runs of the same test don't share it.
+class TempDirTest : public ::testing::Test {
+ protected:
+  std::filesystem::path dir_;
+
+  void SetUp() override {
+    const auto* info = ::testing::UnitTest::GetInstance()->current_test_info();
+    dir_ = std::filesystem::path{::testing::TempDir()} /
+           (std::string{"dwc_"} + info->test_suite_name() + "_" + info->name() + "_" + std::to_string(::getpid()));
+    std::filesystem::remove_all(dir_);
+    std::filesystem::create_directories(dir_);
+  }
+  void TearDown() override { std::filesystem::remove_all(dir_); }
+};
+}  // namespace test
@@ -0,0 +1,69 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "src/shared/arena.hpp"
+
+using namespace dwc::utils;
+
+TEST(Arena, Alignment) {
+  Arena arena{256};
+  arena.allocate(1, 1);
+  for (size_t align : {2, 4, 8, 16, 64}) {
+    auto* p = arena.allocate(3, align);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(p) % align, 0);
+  }
+}
+
+TEST(Arena, RewindReuses) {
+  Arena arena{256};
+  auto m = arena.mark();
+  void* first = arena.allocate(100);
+  arena.allocate(100);
+  arena.rewind(m);
+  EXPECT_EQ(arena.allocate(100), first);
+
+  arena.reset();
+  EXPECT_EQ(arena.allocate(100), first);
+  EXPECT_EQ(arena.block_allocations(), 1);
+}
+
+TEST(Arena, BlocksStayFlat) {
+  Arena arena{256};
+  auto round = [&arena] {
+    arena.reset();
+    // larger than a block, gets a block of its own
+    arena.allocate(1000);
+    for (int i = 0; i < 20; ++i) arena.allocate(64);
+  };
+  round();
+  size_t blocks = arena.block_allocations();
+  size_t capacity = arena.capacity();
+  for (int i = 0; i < 10; ++i) round();
+  EXPECT_EQ(arena.block_allocations(), blocks);
+  EXPECT_EQ(arena.capacity(), capacity);
+}
+
+TEST(Arena, Scope) {
+  Arena arena;
+  void* outer = arena.allocate(8);
+  {
+    ArenaScope scope{arena};
+    std::pmr::vector<int> v{scope.resource()};
+    for (int i = 0; i < 1000; ++i) v.push_back(i);
+    EXPECT_EQ(v[999], 999);
+    {
+      ArenaScope inner{arena};
+      EXPECT_NE(inner.resource()->allocate(8), nullptr);
+    }
+  }
+  EXPECT_EQ(static_cast<char*>(arena.allocate(8)) - static_cast<char*>(outer), alignof(std::max_align_t));
+}
+
+TEST(Arena, ThreadArena) {
+  Arena& arena = thread_arena();
+  EXPECT_EQ(&arena, &thread_arena());
+  ArenaScope scope;
+  EXPECT_EQ(scope.resource(), arena.resource());
+}
@@ -0,0 +1,50 @@
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+#include "src/shared/counters.hpp"
+
+namespace {
+enum class Event : uint8_t {
+  A,
+  B,
+  SIZE,
+};
+using CountersT = dwc::utils::Counters<Event>;
+}  // namespace
+
+TEST(Counters, SingleThread) {
+  CountersT::reset();
+  CountersT::add(Event::A);
+  CountersT::add(Event::A);
+  CountersT::add(Event::B, 5);
+  EXPECT_EQ(CountersT::snapshot(), (CountersT::ValuesT{2, 5}));
+
+  CountersT::reset();
+  EXPECT_EQ(CountersT::snapshot(), (CountersT::ValuesT{0, 0}));
+}
+
+TEST(Counters, MergedAcrossThreads) {
+  CountersT::reset();
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < 4; ++t) {
+    threads.emplace_back([] {
+      for (size_t i = 0; i < 1000; ++i) CountersT::add(Event::A);
+    });
+  }
+  for (auto& t : threads) t.join();
+  CountersT::add(Event::B);
+
+  // finished threads are kept in the totals
+  EXPECT_EQ(CountersT::snapshot(), (CountersT::ValuesT{4000, 1}));
+}
+
+TEST(Counters, ScopedTimer) {
+  CountersT::reset();
+  {
+    dwc::utils::ScopedTimer<Event> timer{Event::B};
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+  }
+  EXPECT_GE(CountersT::snapshot()[1], 2'000'000);
+}
@@ -44,3 +44,45 @@ TEST(StaticMap, Struct) {
   EXPECT_EQ(m.size(), 3);
   EXPECT_THROW((m[{3, 1.11}]), std::logic_error);
 }
+
+TEST(StaticMap, Variadic) {
+  constexpr utils::Map m{'a', 1, 'b', 2, 'c', 3};
+  static_assert(m.size() == 3);
+  EXPECT_EQ(m['b'], 2);
+}
+
+TEST(SortedMap, Basic) {
+  constexpr utils::SortedMap<size_t, char, 4> m{
+      {std::make_pair(300, 'D'), std::make_pair(100, 'B'), std::make_pair(400, 'E'), std::make_pair(200, 'C')}};
+  static_assert(m.size() == 4);
+  static_assert(m[100] == 'B');
+  static_assert(*m.find(400) == 'E');
+  static_assert(m.find(250) == nullptr);
+  static_assert(!m.get(0).has_value());
+  static_assert(m.contains(300));
+
+  EXPECT_EQ(m[200], 'C');
+  EXPECT_EQ(m.get(300), 'D');
+  EXPECT_FALSE(m.contains(500));
+  EXPECT_THROW(m[3], std::logic_error);
+}
+
+TEST(SortedMap, Variadic) {
+  struct Key {
+    uint16_t one;
+    float two;
+    constexpr bool operator<(const Key& o) const { return one != o.one ? one < o.one : two < o.two; }
+  };
+
+  constexpr utils::SortedMap m{Key{3, 1.1}, std::string_view{"Rambo"}, Key{3, 0.9}, std::string_view{"Terminator"},
+                               Key{4, 1.1}, std::string_view{"Die Hard"}};
+  static_assert(m.size() == 3);
+  static_assert(m[Key{3, 0.9}] == "Terminator");
+  static_assert(!m.contains(Key{3, 1.0}));
+  EXPECT_EQ((m[{4, 1.1}]), "Die Hard");
+  EXPECT_EQ((m.get({3, 1.1})), "Rambo");
+}
+
+TEST(SortedMap, DuplicatedKey) {
+  EXPECT_THROW((utils::SortedMap{1, 'a', 2, 'b', 1, 'c'}), std::logic_error);
+}
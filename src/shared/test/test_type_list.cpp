@@ -29,6 +29,14 @@ TEST(TypeList, Basic) {
   EXPECT_EQ(size_v<tail_t<tail_t<tail_t<TL>>>>, 0);
 }
 
+TEST(TypeList, Unique) {
+  EXPECT_TRUE((unique_v<>));
+  EXPECT_TRUE((unique_v<int, float, long>));
+  EXPECT_FALSE((unique_v<int, float, int>));
+  EXPECT_TRUE((unique_v<type_list<char, bool>>));
+  EXPECT_FALSE((unique_v<type_list<char, bool, bool>>));
+}
+
 namespace test {
 template <typename T>
 T get_default() {
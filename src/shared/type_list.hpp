@@ -1,5 +1,7 @@
 #pragma once
 
+#include <type_traits>
+
 namespace dwc::utils {
 
 template <typename... TS>
@@ -66,4 +68,17 @@ using at_t = typename at<I, TS...>::type;
 template <typename... TS>
 static constexpr size_t size_v = size<TS...>::value;
 
+// true if no type appears twice
+template <typename... TS>
+struct unique : std::true_type {};
+
+template <typename HEAD, typename... TAIL>
+struct unique<HEAD, TAIL...> : std::bool_constant<!(std::is_same_v<HEAD, TAIL> || ...) && unique<TAIL...>::value> {};
+
+template <typename... TS>
+struct unique<type_list<TS...>> : unique<TS...> {};
+
+template <typename... TS>
+static constexpr bool unique_v = unique<TS...>::value;
+
 }  // namespace dwc::utils
@@ -1,7 +1,8 @@
 #include "utils.hpp"
 
-dwc::utils::StringVecT dwc::utils::split(std::string_view str, std::string_view delim) {
-  dwc::utils::StringVecT res;
+namespace {
+template <typename VEC>
+void split_into(std::string_view str, std::string_view delim, VEC& res) {
   size_t st = 0;
   while (st < str.length()) {
     size_t en = str.find(delim, st);
@@ -9,5 +10,18 @@ dwc::utils::StringVecT dwc::utils::split(std::string_view str, std::string_view
     if (st < en) res.push_back(str.substr(st, en - st));
     st = en + delim.length();
   }
+}
+}  // namespace
+
+dwc::utils::StringVecT dwc::utils::split(std::string_view str, std::string_view delim) {
+  dwc::utils::StringVecT res;
+  split_into(str, delim, res);
+  return res;
+}
+
+std::pmr::vector<std::string_view> dwc::utils::split(std::string_view str, std::string_view delim,
+                                                     std::pmr::memory_resource* mr) {
+  std::pmr::vector<std::string_view> res{mr};
+  split_into(str, delim, res);
   return res;
 }
@@ -2,6 +2,7 @@
 #define DWC_UTILS_HPP
 
 #include <algorithm>
+#include <memory_resource>
 #include <sstream>
 #include <string_view>
 #include <type_traits>
@@ -12,6 +13,8 @@ namespace dwc::utils {
 // String split
 using StringVecT = std::vector<std::string_view>;
 StringVecT split(std::string_view str, std::string_view delim);
+// same, allocating from mr
+std::pmr::vector<std::string_view> split(std::string_view str, std::string_view delim, std::pmr::memory_resource* mr);
 
 // Non-convertible arithmetic type
 template <size_t TAG, typename T = int32_t>
@@ -62,28 +65,28 @@ class TaggedArithmeticT {
   }
 
   template <typename U, typename = fund_check<U>>
-  friend U operator+(U v, TaggedArithmeticT t) {
+  friend constexpr U operator+(U v, TaggedArithmeticT t) {
     return v + t.v_;
   }
 
   template <typename U, typename = fund_check<U>>
-  friend U operator-(U v, TaggedArithmeticT t) {
+  friend constexpr U operator-(U v, TaggedArithmeticT t) {
     return v - t.v_;
   }
 
   template <typename U, typename = fund_check<U>>
-  friend bool operator==(U v, TaggedArithmeticT t) {
+  friend constexpr bool operator==(U v, TaggedArithmeticT t) {
     return v == t.v_;
   }
 
   template <typename U, typename = fund_check<U>>
-  friend bool operator<=(U v, TaggedArithmeticT t) {
+  friend constexpr bool operator<=(U v, TaggedArithmeticT t) {
     return v <= t.v_;
   }
 
   // conversion to fundamental
   template <typename U, typename = fund_check<U>>
-  operator U() const {
+  constexpr operator U() const {
     return static_cast<U>(v_);
   }
 
@@ -0,0 +1,229 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <stdexcept>
+#include <string>
+
+#include "src/framework/basic_types.hpp"
+#include "src/framework/mailbox.hpp"
+
+// dwtb, the engine's own endgame table files written by egtb_gen. Not Syzygy (see syzygy_format.hpp for that): no
+// compression and no symmetry folding, one entry per square of each piece. Named after the material, stronger side
+// first ("KQvK.dwtb"), and laid out as
+//   header    16 bytes: "DWTB", version, piece count, flags, 0, then the table pieces (Piece::ordinal(), 0xff pad)
+//   wdl       2 bits per position, 4 positions per byte: 0 unused (illegal), 1 loss, 2 draw, 3 win for the side to move
+//   distance  1 byte per position if FLAG_DISTANCE: DTC, plies to mate or to the winner's next capture
+// The table pieces are listed stronger side first, that side being white. Positions with the stronger side black
+// are looked up with colors swapped and ranks mirrored.
+
+namespace dwc::tb {
+
+// 2 * 64^n positions: 5 pieces already take 2.5 GB per table, 6 would be 170 GB
+constexpr size_t MAX_PIECES = 5;
+
+// for the side to move, cursed wins and blessed losses only come from Syzygy tables (50 move rule)
+enum class Wdl : int8_t {
+  LOSS = -2,
+  BLESSED_LOSS = -1,
+  DRAW = 0,
+  CURSED_WIN = 1,
+  WIN = 2,
+};
+
+constexpr std::string_view EXTENSION = ".dwtb";
+constexpr std::array<char, 4> MAGIC{'D', 'W', 'T', 'B'};
+constexpr uint8_t VERSION = 1;
+constexpr uint8_t FLAG_DISTANCE = 1;
+constexpr size_t HEADER_SIZE = 16;
+
+// 2 bit codes of the wdl section
+constexpr uint8_t WDL_NONE = 0;
+constexpr uint8_t WDL_LOSS = 1;
+constexpr uint8_t WDL_DRAW = 2;
+constexpr uint8_t WDL_WIN = 3;
+
+constexpr std::optional<Wdl> to_wdl(uint8_t code) {
+  switch (code) {
+    case WDL_LOSS: return Wdl::LOSS;
+    case WDL_DRAW: return Wdl::DRAW;
+    case WDL_WIN: return Wdl::WIN;
+    default: return std::nullopt;
+  }
+}
+
+constexpr uint8_t to_code(Wdl wdl) {
+  return wdl == Wdl::WIN ? WDL_WIN : wdl == Wdl::LOSS ? WDL_LOSS : WDL_DRAW;
+}
+
+// pieces of a table, kings first, then by descending type: K Q R B N P
+struct Material {
+  std::array<Piece, MAX_PIECES> pieces{};
+  uint8_t size{0};
+
+  bool operator==(const Material& o) const {
+    if (size != o.size) return false;
+    for (size_t i = 0; i < size; ++i) {
+      if (!(pieces[i] == o.pieces[i])) return false;
+    }
+    return true;
+  }
+};
+
+namespace _inner {
+constexpr std::array<Type, cast_t(Type::SIZE)> SIGNATURE_ORDER{Type::KING,   Type::QUEEN,  Type::ROOK,
+                                                               Type::BISHOP, Type::KNIGHT, Type::PAWN};
+constexpr std::array<char, cast_t(Type::SIZE)> TYPE_CHARS{'P', 'N', 'B', 'R', 'Q', 'K'};
+constexpr std::array<int, cast_t(Type::SIZE)> TYPE_VALUES{1, 3, 3, 5, 9, 0};
+
+inline std::string side_signature(const mailbox::CountsT& counts, Side side) {
+  std::string res;
+  for (Type type : SIGNATURE_ORDER) res.append(counts[Piece{type, side}.ordinal()], TYPE_CHARS[cast_t(type)]);
+  return res;
+}
+
+inline int side_value(const mailbox::CountsT& counts, Side side) {
+  int v = 0;
+  for (Type type : SIGNATURE_ORDER) v += TYPE_VALUES[cast_t(type)] * counts[Piece{type, side}.ordinal()];
+  return v;
+}
+}  // namespace _inner
+
+// material of the position, stronger side as white in the table
+struct Signature {
+  std::string name;  // e.g. "KRvK"
+  Material material;
+  bool flipped{false};  // the position's black is the table's white
+};
+
+inline std::optional<Signature> signature_of(const mailbox::CountsT& counts) {
+  size_t total = 0;
+  for (uint8_t c : counts) total += c;
+  Piece wk{Type::KING, Side::WHITE};
+  Piece bk{Type::KING, Side::BLACK};
+  if (total > MAX_PIECES || counts[wk.ordinal()] != 1 || counts[bk.ordinal()] != 1) return std::nullopt;
+
+  std::string white = _inner::side_signature(counts, Side::WHITE);
+  std::string black = _inner::side_signature(counts, Side::BLACK);
+  int white_value = _inner::side_value(counts, Side::WHITE);
+  int black_value = _inner::side_value(counts, Side::BLACK);
+  bool flipped = black_value > white_value || (black_value == white_value && black > white);
+
+  Signature sig;
+  sig.name = flipped ? black + "v" + white : white + "v" + black;
+  sig.flipped = flipped;
+  for (Side side : {Side::WHITE, Side::BLACK}) {
+    Side actual = flipped ? (side == Side::WHITE ? Side::BLACK : Side::WHITE) : side;
+    for (Type type : _inner::SIGNATURE_ORDER) {
+      for (uint8_t i = 0; i < counts[Piece{type, actual}.ordinal()]; ++i) {
+        sig.material.pieces[sig.material.size++] = {type, side};
+      }
+    }
+  }
+  return sig;
+}
+
+// "KQvKR" -> material, nullopt if not a valid name
+inline std::optional<Signature> signature_of(std::string_view name) {
+  auto v = name.find('v');
+  if (v == std::string_view::npos) return std::nullopt;
+  mailbox::CountsT counts{};
+  for (size_t i = 0; i < name.size(); ++i) {
+    if (i == v) continue;
+    Side side = i < v ? Side::WHITE : Side::BLACK;
+    size_t t = 0;
+    while (t < _inner::TYPE_CHARS.size() && _inner::TYPE_CHARS[t] != name[i]) ++t;
+    if (t == _inner::TYPE_CHARS.size()) return std::nullopt;
+    ++counts[Piece{static_cast<Type>(t), side}.ordinal()];
+  }
+  auto sig = signature_of(counts);
+  if (!sig.has_value() || sig->name != name) return std::nullopt;
+  return sig;
+}
+
+// positions of a table: squares of the table pieces as base 64 digits, then the side to move
+constexpr size_t table_size(const Material& m) {
+  size_t n = 2;
+  for (size_t i = 0; i < m.size; ++i) n *= 64;
+  return n;
+}
+
+constexpr size_t wdl_bytes(size_t positions) {
+  return (positions + 3) / 4;
+}
+
+constexpr size_t file_size(const Material& m, bool with_distance) {
+  size_t n = table_size(m);
+  return HEADER_SIZE + wdl_bytes(n) + (with_distance ? n : 0);
+}
+
+// squares in table order (already flipped), the side to move as seen by the table
+struct Placement {
+  std::array<uint8_t, MAX_PIECES> squares{};
+  Side turn{Side::WHITE};
+};
+
+constexpr size_t index_of(const Material& m, const Placement& p) {
+  size_t idx = 0;
+  for (size_t i = 0; i < m.size; ++i) idx = idx * 64 + p.squares[i];
+  return idx * 2 + cast_t(p.turn);
+}
+
+constexpr Placement placement_of(const Material& m, size_t idx) {
+  Placement p;
+  p.turn = static_cast<Side>(idx % 2);
+  idx /= 2;
+  for (size_t i = m.size; i > 0; --i) {
+    p.squares[i - 1] = static_cast<uint8_t>(idx % 64);
+    idx /= 64;
+  }
+  return p;
+}
+
+// placement of the position in the table of sig, the same piece twice is taken in square order
+inline Placement placement_of(const Signature& sig, const State& state) {
+  Placement p;
+  std::array<bool, 64> used{};
+  for (size_t i = 0; i < sig.material.size; ++i) {
+    Piece tp = sig.material.pieces[i];
+    Piece actual{tp.type, sig.flipped ? (tp.side == Side::WHITE ? Side::BLACK : Side::WHITE) : tp.side};
+    for (uint8_t sq = 0; sq < 64; ++sq) {
+      if (used[sq] || !(board_ut::get(Pos::from_index(sq), state.board) == actual)) continue;
+      used[sq] = true;
+      p.squares[i] = sig.flipped ? sq ^ 56 : sq;
+      break;
+    }
+  }
+  Side turn = state.turn.value_or(Side::WHITE);
+  p.turn = sig.flipped ? (turn == Side::WHITE ? Side::BLACK : Side::WHITE) : turn;
+  return p;
+}
+
+inline std::array<uint8_t, HEADER_SIZE> make_header(const Material& m, bool with_distance) {
+  std::array<uint8_t, HEADER_SIZE> h{};
+  std::memcpy(h.data(), MAGIC.data(), MAGIC.size());
+  h[4] = VERSION;
+  h[5] = m.size;
+  h[6] = with_distance ? FLAG_DISTANCE : 0;
+  for (size_t i = 0; i + 8 < HEADER_SIZE; ++i) h[8 + i] = i < m.size ? m.pieces[i].ordinal() : 0xff;
+  return h;
+}
+
+// whether the distance section is there, throws std::runtime_error if the file isn't a table of m
+inline bool check_header(const uint8_t* data, size_t size, const Material& m) {
+  if (size < HEADER_SIZE || std::memcmp(data, MAGIC.data(), MAGIC.size()) != 0) {
+    throw std::runtime_error("not a dwtb table");
+  }
+  if (data[4] != VERSION) throw std::runtime_error("unsupported dwtb version");
+  if (data[5] != m.size) throw std::runtime_error("dwtb material mismatch");
+  for (size_t i = 0; i < m.size; ++i) {
+    if (data[8 + i] != m.pieces[i].ordinal()) throw std::runtime_error("dwtb material mismatch");
+  }
+  bool with_distance = (data[6] & FLAG_DISTANCE) != 0;
+  if (size != file_size(m, with_distance)) throw std::runtime_error("dwtb size mismatch");
+  return with_distance;
+}
+
+}  // namespace dwc::tb
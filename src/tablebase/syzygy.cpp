@@ -0,0 +1,457 @@
+#include "syzygy.hpp"
+
+#include <filesystem>
+#include <mutex>
+#include <stdexcept>
+
+#include "src/framework/move_gen.hpp"
+#include "src/shared/mapped_file.hpp"
+#include "src/tablebase/syzygy_format.hpp"
+
+namespace dwc::tb {
+namespace {
+using namespace syzygy;
+
+template <typename T>
+T read_le(const uint8_t* p) {
+  T v = 0;
+  for (size_t i = 0; i < sizeof(T); ++i) v |= static_cast<T>(p[i]) << (8 * i);
+  return v;
+}
+
+template <typename T>
+T read_be(const uint8_t* p) {
+  T v = 0;
+  for (size_t i = 0; i < sizeof(T); ++i) v = static_cast<T>(v << 8) | p[i];
+  return v;
+}
+
+// One table of a file, for a side to move and with pawns a file of the leading pawn. Values are Huffman coded
+// symbols, a symbol standing for a value or a pair of symbols ("recursive pairing"), in blocks of up to 65536 values.
+struct PairsData {
+  Encoding enc;
+  uint8_t flags{0};
+  uint8_t min_len{0};  // shortest code, or the value itself with FLAG_SINGLE_VALUE
+  size_t block_size{0};
+  size_t span{0};  // sparse[k] locates the value k * span + span / 2
+  size_t sparse_size{0};
+  uint32_t blocks{0};
+  uint32_t block_lengths_size{0};  // blocks and some padding
+  const uint8_t* lowest_sym{nullptr};     // 16 bits per code length, the first symbol of that length
+  const uint8_t* btree{nullptr};          // 24 bits per symbol: left and right child, 12 bits each
+  const uint8_t* sparse{nullptr};         // 48 bits per entry: block, offset of the value in it
+  const uint8_t* block_lengths{nullptr};  // 16 bits per block: values in it minus one
+  const uint8_t* data{nullptr};
+  std::vector<uint64_t> base;         // lowest code of each length, left aligned
+  std::vector<uint16_t> symlen;       // values of a symbol minus one
+  std::array<uint16_t, 4> map_idx{};  // dtz: start of the win, loss, cursed win, blessed loss values in the map
+
+  uint16_t left(size_t sym) const { return static_cast<uint16_t>(((btree[3 * sym + 1] & 0xf) << 8) | btree[3 * sym]); }
+  uint16_t right(size_t sym) const {
+    return static_cast<uint16_t>((btree[3 * sym + 2] << 4) | (btree[3 * sym + 1] >> 4));
+  }
+  uint16_t block_length(uint32_t block) const { return read_le<uint16_t>(block_lengths + 2 * block); }
+};
+
+uint16_t set_symlen(PairsData& d, uint16_t sym, std::vector<bool>& visited) {
+  visited[sym] = true;
+  uint16_t r = d.right(sym);
+  if (r == LEAF) return 0;
+  uint16_t l = d.left(sym);
+  if (!visited[l]) d.symlen[l] = set_symlen(d, l, visited);
+  if (!visited[r]) d.symlen[r] = set_symlen(d, r, visited);
+  return static_cast<uint16_t>(d.symlen[l] + d.symlen[r] + 1);
+}
+
+const uint8_t* read_sizes(PairsData& d, const uint8_t* p) {
+  d.flags = *p++;
+  if (d.flags & FLAG_SINGLE_VALUE) {
+    d.min_len = *p++;
+    return p;
+  }
+
+  d.block_size = size_t{1} << *p++;
+  d.span = size_t{1} << *p++;
+  d.sparse_size = static_cast<size_t>((d.enc.size() + d.span - 1) / d.span);
+  uint8_t padding = *p++;
+  d.blocks = read_le<uint32_t>(p);
+  p += 4;
+  d.block_lengths_size = d.blocks + padding;
+  uint8_t max_len = *p++;
+  d.min_len = *p++;
+  if (max_len < d.min_len || max_len > 64) throw std::runtime_error("corrupted syzygy table");
+  d.lowest_sym = p;
+
+  // codes are canonical with longer codes numerically lower, lowest_sym[i] - lowest_sym[i + 1] being the count of
+  // the codes one bit longer than length i
+  d.base.assign(max_len - d.min_len + 1, 0);
+  for (size_t i = d.base.size() - 1; i-- > 0;) {
+    d.base[i] = (d.base[i + 1] + read_le<uint16_t>(p + 2 * i) - read_le<uint16_t>(p + 2 * i + 2)) / 2;
+  }
+  for (size_t i = 0; i < d.base.size(); ++i) d.base[i] <<= 64 - d.min_len - i;
+  p += 2 * d.base.size();
+
+  d.symlen.assign(read_le<uint16_t>(p), 0);
+  p += 2;
+  d.btree = p;
+  std::vector<bool> visited(d.symlen.size());
+  for (size_t sym = 0; sym < d.symlen.size(); ++sym) {
+    if (!visited[sym]) d.symlen[sym] = set_symlen(d, static_cast<uint16_t>(sym), visited);
+  }
+  return p + 3 * d.symlen.size() + (d.symlen.size() & 1);
+}
+
+int decompress(const PairsData& d, uint64_t idx) {
+  if (d.flags & FLAG_SINGLE_VALUE) return d.min_len;
+
+  // the sparse entry nearest to idx, then walk the block lengths
+  uint64_t k = idx / d.span;
+  uint32_t block = read_le<uint32_t>(d.sparse + 6 * k);
+  int64_t offset = read_le<uint16_t>(d.sparse + 6 * k + 4);
+  offset += static_cast<int64_t>(idx % d.span) - static_cast<int64_t>(d.span / 2);
+  while (offset < 0) offset += d.block_length(--block) + 1;
+  while (offset > d.block_length(block)) offset -= d.block_length(block++) + 1;
+
+  // symbols of the block until the one covering offset
+  const uint8_t* ptr = d.data + static_cast<uint64_t>(block) * d.block_size;
+  uint64_t buf = read_be<uint64_t>(ptr);
+  ptr += 8;
+  int buf_size = 64;
+  size_t sym = 0;
+  while (true) {
+    size_t len = 0;
+    while (buf < d.base[len]) ++len;
+    sym = static_cast<size_t>((buf - d.base[len]) >> (64 - len - d.min_len));
+    sym += read_le<uint16_t>(d.lowest_sym + 2 * len);
+    if (offset < d.symlen[sym] + 1) break;
+    offset -= d.symlen[sym] + 1;
+    len += d.min_len;
+    buf <<= len;
+    buf_size -= static_cast<int>(len);
+    if (buf_size <= 32) {
+      buf_size += 32;
+      buf |= static_cast<uint64_t>(read_be<uint32_t>(ptr)) << (64 - buf_size);
+      ptr += 4;
+    }
+  }
+
+  // down the pairs, the values of the left child come first
+  while (d.symlen[sym] != 0) {
+    uint16_t l = d.left(sym);
+    if (offset < d.symlen[l] + 1) {
+      sym = l;
+    } else {
+      offset -= d.symlen[l] + 1;
+      sym = d.right(sym);
+    }
+  }
+  return d.left(sym);
+}
+
+int sign_of(Wdl wdl) {
+  return wdl > Wdl::DRAW ? 1 : wdl < Wdl::DRAW ? -1 : 0;
+}
+
+Wdl negate(Wdl wdl) {
+  return static_cast<Wdl>(-static_cast<int>(wdl));
+}
+
+// dtz of the move before a capture or pawn move, dtz tables don't store it
+int dtz_before_zeroing(Wdl wdl) {
+  switch (wdl) {
+    case Wdl::WIN: return 1;
+    case Wdl::CURSED_WIN: return 101;
+    case Wdl::BLESSED_LOSS: return -101;
+    case Wdl::LOSS: return -1;
+    default: return 0;
+  }
+}
+
+bool is_capture(const Board& board, const Move& move) {
+  return board.get(move.to).has_value();
+}
+
+bool is_pawn_move(const Board& board, const Move& move) {
+  return board.get(move.fr)->type == Type::PAWN;
+}
+
+// castling rights aren't in tables, nor promotions on Board
+bool probeable(const Board& board) {
+  const State& state = board.get_state();
+  if (!state.castling.empty()) return false;
+  Side turn = state.turn.value_or(Side::WHITE);
+  int seventh = turn == Side::WHITE ? 6 : 1;
+  for (int file = 0; file < 8; ++file) {
+    if (board.get(Pos::from_index(seventh * 8 + file)) == Piece{Type::PAWN, turn}) return false;
+  }
+  return true;
+}
+}  // namespace
+
+struct Syzygy::Table {
+  struct File {
+    std::string path;
+    std::once_flag mapped;
+    utils::MappedFile file;
+    std::array<std::array<PairsData, 4>, 2> items;  // [side to move][file of the leading pawn]
+    const uint8_t* map{nullptr};                     // dtz
+
+    // the table of a side to move and file, see Layout for the sides of dtz and symmetric material
+    const PairsData& get(int stm, int file) const { return items[stm][file]; }
+  };
+
+  Layout layout;
+  File wdl;
+  File dtz;
+
+  void load(File& f, bool is_dtz) const;
+};
+
+void Syzygy::Table::load(File& f, bool is_dtz) const {
+  utils::MappedFile file{f.path};
+  const uint8_t* base = file.data();
+  const auto& magic = is_dtz ? DTZ_MAGIC : WDL_MAGIC;
+  if (file.size() < magic.size() + 1 || !std::equal(magic.begin(), magic.end(), base)) {
+    throw std::runtime_error("not a syzygy table: " + f.path);
+  }
+  const uint8_t* p = base + magic.size();
+  uint8_t header = *p++;
+  if (((header & FILE_HAS_PAWNS) != 0) != layout.has_pawns || ((header & FILE_SPLIT) != 0) == layout.symmetric) {
+    throw std::runtime_error("syzygy material mismatch: " + f.path);
+  }
+
+  const int sides = !is_dtz && !layout.symmetric ? 2 : 1;
+  const int files = layout.has_pawns ? 4 : 1;
+  const bool both_pawns = layout.has_pawns && layout.pawns[1] > 0;
+  auto align = [base](const uint8_t* q, size_t to) { return q + (to - static_cast<size_t>(q - base) % to) % to; };
+
+  for (int file_idx = 0; file_idx < files; ++file_idx) {
+    std::array<std::array<uint8_t, 2>, 2> order{};
+    for (int s = 0; s < 2; ++s) {
+      order[s][0] = s == 0 ? p[0] & 0xf : p[0] >> 4;
+      order[s][1] = both_pawns ? (s == 0 ? p[1] & 0xf : p[1] >> 4) : 0xf;
+    }
+    p += both_pawns ? 2 : 1;
+    std::array<std::array<uint8_t, syzygy::MAX_PIECES>, 2> pieces{};
+    for (size_t k = 0; k < layout.size; ++k, ++p) {
+      pieces[0][k] = *p & 0xf;
+      pieces[1][k] = *p >> 4;
+    }
+    for (int s = 0; s < sides; ++s) f.items[s][file_idx].enc = make_encoding(layout, pieces[s], order[s], file_idx);
+  }
+  p = align(p, 2);
+
+  for (int file_idx = 0; file_idx < files; ++file_idx) {
+    for (int s = 0; s < sides; ++s) p = read_sizes(f.items[s][file_idx], p);
+  }
+
+  if (is_dtz) {
+    f.map = p;
+    for (int file_idx = 0; file_idx < files; ++file_idx) {
+      PairsData& d = f.items[0][file_idx];
+      if (!(d.flags & FLAG_MAPPED)) continue;
+      if (d.flags & FLAG_WIDE) {
+        p = align(p, 2);
+        for (auto& idx : d.map_idx) {
+          idx = static_cast<uint16_t>((p - f.map) / 2 + 1);
+          p += 2 * read_le<uint16_t>(p) + 2;
+        }
+      } else {
+        for (auto& idx : d.map_idx) {
+          idx = static_cast<uint16_t>(p - f.map + 1);
+          p += *p + 1;
+        }
+      }
+    }
+    p = align(p, 2);
+  }
+
+  for (int file_idx = 0; file_idx < files; ++file_idx) {
+    for (int s = 0; s < sides; ++s) {
+      f.items[s][file_idx].sparse = p;
+      p += 6 * f.items[s][file_idx].sparse_size;
+    }
+  }
+  for (int file_idx = 0; file_idx < files; ++file_idx) {
+    for (int s = 0; s < sides; ++s) {
+      f.items[s][file_idx].block_lengths = p;
+      p += 2 * size_t{f.items[s][file_idx].block_lengths_size};
+    }
+  }
+  for (int file_idx = 0; file_idx < files; ++file_idx) {
+    for (int s = 0; s < sides; ++s) {
+      PairsData& d = f.items[s][file_idx];
+      p = align(p, 64);
+      d.data = p;
+      p += d.blocks * d.block_size;
+    }
+  }
+  if (p > base + file.size()) throw std::runtime_error("truncated syzygy table: " + f.path);
+
+  file.advise_random();
+  f.file = std::move(file);
+}
+
+Syzygy::Syzygy(const std::string& dir) {
+  namespace fs = std::filesystem;
+  std::error_code ec;
+  for (const auto& entry : fs::directory_iterator(dir, ec)) {
+    if (!entry.is_regular_file() || entry.path().extension() != WDL_EXTENSION) continue;
+    std::string name = entry.path().stem().string();
+    auto counts = counts_of(name);
+    if (!counts.has_value() || by_material_.count(name) != 0) continue;
+
+    auto table = std::make_unique<Table>();
+    table->layout = layout_of(*counts);
+    table->wdl.path = entry.path().string();
+    fs::path dtz = entry.path();
+    dtz.replace_extension(DTZ_EXTENSION);
+    if (fs::is_regular_file(dtz, ec)) table->dtz.path = dtz.string();
+    max_pieces_ = std::max<size_t>(max_pieces_, table->layout.size);
+
+    mailbox::CountsT swapped{};
+    for (size_t o = 0; o < counts->size(); o += 2) {
+      swapped[o] = (*counts)[o + 1];
+      swapped[o + 1] = (*counts)[o];
+    }
+    by_material_.emplace(material_of(*counts), std::make_pair(table.get(), false));
+    by_material_.emplace(material_of(swapped), std::make_pair(table.get(), true));
+    tables_.push_back(std::move(table));
+  }
+}
+
+Syzygy::~Syzygy() = default;
+
+int Syzygy::probe_table(const Board& board, bool dtz, Wdl wdl, Result& res) const {
+  const mailbox::CountsT counts = board.get_mailbox().counts();
+  size_t total = 0;
+  for (uint8_t c : counts) total += c;
+  if (total == 2) return static_cast<int>(Wdl::DRAW) + 2;
+
+  auto it = total <= syzygy::MAX_PIECES ? by_material_.find(material_of(counts)) : by_material_.end();
+  if (it == by_material_.end()) return res = Result::FAIL, 0;
+  Table* table = it->second.first;
+  bool flipped = it->second.second;
+  Table::File& f = dtz ? table->dtz : table->wdl;
+  if (f.path.empty()) return res = Result::FAIL, 0;
+  std::call_once(f.mapped, [table, &f, dtz] { table->load(f, dtz); });
+
+  // with symmetric material only white to move is stored
+  const Layout& layout = table->layout;
+  Side turn = board.get_state().turn.value_or(Side::WHITE);
+  bool flip = flipped || (layout.symmetric && turn == Side::BLACK);
+  int stm = flip != (turn == Side::BLACK);
+
+  Position p;
+  for (uint8_t sq = 0; sq < 64; ++sq) {
+    auto piece = board.get(Pos::from_index(sq));
+    if (!piece.has_value()) continue;
+    uint8_t code = code_of(*piece);
+    p.pieces[p.size] = flip ? swap_color(code) : code;
+    p.squares[p.size++] = flip ? sq ^ 56 : sq;
+  }
+  int file = layout.has_pawns ? lead_file(code_of({Type::PAWN, layout.lead}), p) : 0;
+
+  // dtz tables have one side to move, the other one is found by a 1 ply search
+  if (dtz) {
+    bool stored = (f.get(0, file).flags & FLAG_STM) == stm || (layout.symmetric && !layout.has_pawns);
+    if (!stored) return res = Result::CHANGE_STM, 0;
+    stm = 0;
+  }
+
+  const PairsData& d = f.get(stm, file);
+  int value = decompress(d, index_of(layout, d.enc, p));
+  if (!dtz) return value;
+
+  // map index of the win, loss, cursed win and blessed loss values, by wdl + 2
+  constexpr std::array<size_t, 5> WDL_MAP{1, 3, 0, 2, 0};
+  if (d.flags & FLAG_MAPPED) {
+    size_t idx = d.map_idx[WDL_MAP[static_cast<int>(wdl) + 2]] + value;
+    value = d.flags & FLAG_WIDE ? read_le<uint16_t>(f.map + 2 * idx) : f.map[idx];
+  }
+  if ((wdl == Wdl::WIN && !(d.flags & FLAG_WIN_PLIES)) || (wdl == Wdl::LOSS && !(d.flags & FLAG_LOSS_PLIES)) ||
+      wdl == Wdl::CURSED_WIN || wdl == Wdl::BLESSED_LOSS) {
+    value *= 2;
+  }
+  return value + 1;
+}
+
+Wdl Syzygy::search(const Board& board, bool dtz, Result& res) const {
+  if (!probeable(board)) return res = Result::FAIL, Wdl::DRAW;
+
+  // a table may store anything for a position a capture wins, and a loss where a capture draws
+  Wdl best = Wdl::LOSS;
+  size_t total = 0;
+  size_t searched = 0;
+  for (const Move& move : iter::LegalMoves{board}) {
+    ++total;
+    if (!is_capture(board, move) && !(dtz && is_pawn_move(board, move))) continue;
+    ++searched;
+    Board child = board;
+    child.apply_move(move);
+    Wdl v = negate(search(child, false, res));
+    if (res == Result::FAIL) return Wdl::DRAW;
+    if (v > best) {
+      best = v;
+      if (v >= Wdl::WIN) return res = Result::ZEROING_BEST_MOVE, v;
+    }
+  }
+
+  // nothing left to look up when every move has been searched
+  bool no_more_moves = searched > 0 && searched == total;
+  Wdl v = best;
+  if (!no_more_moves) {
+    v = static_cast<Wdl>(probe_table(board, false, Wdl::DRAW, res) - 2);
+    if (res == Result::FAIL) return Wdl::DRAW;
+  }
+  if (best >= v) {
+    res = best > Wdl::DRAW || no_more_moves ? Result::ZEROING_BEST_MOVE : Result::OK;
+    return best;
+  }
+  res = Result::OK;
+  return v;
+}
+
+int Syzygy::probe_dtz(const Board& board, Result& res) const {
+  Wdl wdl = search(board, true, res);
+  if (res == Result::FAIL || wdl == Wdl::DRAW) return 0;
+  if (res == Result::ZEROING_BEST_MOVE) return dtz_before_zeroing(wdl);
+
+  int dtz = probe_table(board, true, wdl, res);
+  if (res == Result::FAIL) return 0;
+  bool cursed = wdl == Wdl::CURSED_WIN || wdl == Wdl::BLESSED_LOSS;
+  if (res != Result::CHANGE_STM) return (dtz + (cursed ? 100 : 0)) * sign_of(wdl);
+
+  // the table is for the other side to move: the best move, a winning one minimizing dtz or the longest loss
+  int best = 0xffff;
+  for (const Move& move : iter::LegalMoves{board}) {
+    bool zeroing = is_capture(board, move) || is_pawn_move(board, move);
+    Board child = board;
+    child.apply_move(move);
+    // a zeroing move counts as the move before it, the position after it only gives the sign
+    int v = zeroing ? -dtz_before_zeroing(search(child, false, res)) : -probe_dtz(child, res);
+    if (res == Result::FAIL) return 0;
+    Side opponent = child.get_state().turn.value_or(Side::WHITE);
+    if (v == 1 && child.is_king_threatened(opponent) && !child.has_legal_move()) best = 1;
+    if (!zeroing) v += v > 0 ? 1 : v < 0 ? -1 : 0;
+    if (v < best && (v > 0 ? 1 : v < 0 ? -1 : 0) == sign_of(wdl)) best = v;
+  }
+  // no legal moves, mated
+  return best == 0xffff ? -1 : best;
+}
+
+std::optional<Wdl> Syzygy::probe_wdl(const Board& board) const {
+  Result res = Result::OK;
+  Wdl wdl = search(board, false, res);
+  if (res == Result::FAIL) return std::nullopt;
+  return wdl;
+}
+
+std::optional<int> Syzygy::probe_dtz(const Board& board) const {
+  Result res = Result::OK;
+  int dtz = probe_dtz(board, res);
+  if (res == Result::FAIL) return std::nullopt;
+  return dtz;
+}
+
+}  // namespace dwc::tb
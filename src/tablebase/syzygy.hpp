@@ -0,0 +1,53 @@
+#pragma once
+
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "src/framework/board.hpp"
+#include "src/tablebase/format.hpp"
+
+namespace dwc::tb {
+
+// Syzygy tables (".rtbw" / ".rtbz") of a directory, up to 7 pieces, see syzygy_format.hpp.
+// The directory is scanned once at construction, a file is only mapped by the first probe needing it. Probing is
+// thread safe, tables are never unmapped while the Syzygy lives.
+// Captures (and pawn moves for dtz) are searched like Stockfish and Fathom do, so the tables reached by them are
+// needed too. Board has no promotions yet: positions where the side to move has a pawn on its seventh rank aren't
+// probed.
+class Syzygy {
+  struct Table;
+  enum class Result : uint8_t { OK, FAIL, ZEROING_BEST_MOVE, CHANGE_STM };
+
+  std::vector<std::unique_ptr<Table>> tables_;
+  // "KRvK" and "KvKR" both lead to the KRvK table, flipped for the second
+  std::map<std::string, std::pair<Table*, bool>, std::less<>> by_material_;
+  size_t max_pieces_{0};
+
+  // the stored value: the wdl score + 2, or the dtz in plies for wdl (not counting the 100 of cursed results)
+  int probe_table(const Board& board, bool dtz, Wdl wdl, Result& res) const;
+  // wdl resolving the captures, and with dtz the pawn moves, ZEROING_BEST_MOVE if one of them is best
+  Wdl search(const Board& board, bool dtz, Result& res) const;
+  int probe_dtz(const Board& board, Result& res) const;
+
+ public:
+  explicit Syzygy(const std::string& dir);
+  ~Syzygy();
+
+  // wdl tables found
+  size_t size() const { return tables_.size(); }
+  // most pieces of any table, 0 if none
+  size_t max_pieces() const { return max_pieces_; }
+
+  // for the side to move, ignoring the halfmove clock. nullopt when a table is missing, with castling rights, or a
+  // pawn about to promote. Throws std::runtime_error on a corrupted file.
+  std::optional<Wdl> probe_wdl(const Board& board) const;
+
+  // plies to the next capture, pawn move or mate, positive if the side to move wins, negative if it loses, 0 for
+  // draws. Beyond 100 the result is a cursed win or blessed loss. Tables in moves can be one ply off, as in Syzygy.
+  std::optional<int> probe_dtz(const Board& board) const;
+};
+
+}  // namespace dwc::tb
@@ -0,0 +1,370 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "src/framework/basic_types.hpp"
+#include "src/framework/mailbox.hpp"
+#include "src/tablebase/format.hpp"
+
+// Syzygy table files, ".rtbw" (wdl) and ".rtbz" (dtz), up to 7 pieces. The part shared by tb::Syzygy and the writer
+// of egtb_gen: names, piece codes and the position index.
+// A file is named after its material, e.g. "KRvK", the first side being white in the file. It holds one table per
+// side to move (wdl of asymmetric material) or a single one (dtz, symmetric material), tables with pawns are split
+// again by the file of the leading pawn. Each table lists its pieces in the order they are encoded, see Encoding.
+// Positions are mirrored so the leading piece lands in the a1-d1-d4 triangle (files a-d with pawns).
+
+namespace dwc::tb::syzygy {
+
+constexpr size_t MAX_PIECES = 7;
+
+constexpr std::string_view WDL_EXTENSION = ".rtbw";
+constexpr std::string_view DTZ_EXTENSION = ".rtbz";
+constexpr std::array<uint8_t, 4> WDL_MAGIC{0x71, 0xe8, 0x23, 0x5d};
+constexpr std::array<uint8_t, 4> DTZ_MAGIC{0xd7, 0x66, 0x0c, 0xa5};
+
+// first byte after the magic
+constexpr uint8_t FILE_SPLIT = 1;  // both sides to move stored, the material isn't symmetric
+constexpr uint8_t FILE_HAS_PAWNS = 2;
+
+// flags of a table
+constexpr uint8_t FLAG_STM = 1;          // dtz: black to move is stored
+constexpr uint8_t FLAG_MAPPED = 2;       // dtz: values go through the map of the file
+constexpr uint8_t FLAG_WIN_PLIES = 4;    // dtz: wins in plies, otherwise in moves
+constexpr uint8_t FLAG_LOSS_PLIES = 8;   // dtz: losses in plies, otherwise in moves
+constexpr uint8_t FLAG_WIDE = 16;        // dtz: map of 16 bit values
+constexpr uint8_t FLAG_SINGLE_VALUE = 128;  // every position has the same value, stored in place of the code lengths
+
+// symbol whose right child is LEAF is a value
+constexpr uint16_t LEAF = 0xfff;
+
+// piece codes of the files: 1..6 white pawn..king, 9..14 black
+constexpr uint8_t code_of(Piece p) {
+  return static_cast<uint8_t>(cast_t(p.type) + 1 + (p.side == Side::BLACK ? 8 : 0));
+}
+
+constexpr uint8_t swap_color(uint8_t code) {
+  return code ^ 8;
+}
+
+namespace _inner {
+constexpr int off_diagonal(int sq) {
+  return sq / 8 - sq % 8;  // 0 on a1-h8, negative below
+}
+
+constexpr bool kings_touch(int a, int b) {
+  int df = a % 8 - b % 8;
+  int dr = a / 8 - b / 8;
+  return -1 <= df && df <= 1 && -1 <= dr && dr <= 1;
+}
+
+struct Maps {
+  std::array<int, 64> pawns{};                          // a2-h7 to 0..47, the leading pawn has the highest
+  std::array<int, 64> b1h1h7{};                         // squares below a1-h8 to 0..27
+  std::array<int, 64> a1d1d4{};                         // the a1-d1-d4 triangle to 0..9, its diagonal last
+  std::array<std::array<int, 64>, 10> kk{};             // 462 pairs of kings, the first one in the triangle
+  std::array<std::array<uint64_t, 64>, 6> binomial{};   // [k][n] ways to pick k squares out of n
+  std::array<std::array<int, 64>, 6> lead_pawn_idx{};   // [leading pawns][square of the leading one]
+  std::array<std::array<int, 4>, 6> lead_pawns_size{};  // [leading pawns][file a..d]
+};
+
+constexpr Maps make_maps() {
+  Maps m;
+  int code = 0;
+  for (int sq = 0; sq < 64; ++sq) {
+    if (off_diagonal(sq) < 0) m.b1h1h7[sq] = code++;
+  }
+
+  code = 0;
+  std::array<int, 4> diagonal{};
+  int diagonal_size = 0;
+  for (int sq = 0; sq <= 27; ++sq) {
+    if (sq % 8 > 3) continue;
+    if (off_diagonal(sq) < 0) {
+      m.a1d1d4[sq] = code++;
+    } else if (off_diagonal(sq) == 0) {
+      diagonal[diagonal_size++] = sq;
+    }
+  }
+  for (int i = 0; i < diagonal_size; ++i) m.a1d1d4[diagonal[i]] = code++;
+
+  // with the first king on the diagonal the second isn't above it, pairs both on the diagonal go last
+  code = 0;
+  std::array<std::array<int, 2>, 64> both_on_diagonal{};
+  int both_size = 0;
+  for (int idx = 0; idx < 10; ++idx) {
+    for (int s1 = 0; s1 <= 27; ++s1) {
+      if (s1 % 8 > 3 || off_diagonal(s1) > 0 || m.a1d1d4[s1] != idx) continue;
+      for (int s2 = 0; s2 < 64; ++s2) {
+        if (kings_touch(s1, s2)) continue;
+        if (off_diagonal(s1) == 0 && off_diagonal(s2) > 0) continue;
+        if (off_diagonal(s1) == 0 && off_diagonal(s2) == 0) {
+          both_on_diagonal[both_size++] = {idx, s2};
+        } else {
+          m.kk[idx][s2] = code++;
+        }
+      }
+    }
+  }
+  for (int i = 0; i < both_size; ++i) m.kk[both_on_diagonal[i][0]][both_on_diagonal[i][1]] = code++;
+
+  m.binomial[0][0] = 1;
+  for (int n = 1; n < 64; ++n) {
+    for (int k = 0; k < 6 && k <= n; ++k) {
+      m.binomial[k][n] = (k > 0 ? m.binomial[k - 1][n - 1] : 0) + (k < n ? m.binomial[k][n - 1] : 0);
+    }
+  }
+
+  // a2 47, h2 46, a3 45 .. h7 36, then b2 35 ..: the other pawns can't be nearer the edge nor lower on the same file
+  int available = 47;
+  for (int lead = 1; lead <= 5; ++lead) {
+    for (int file = 0; file < 4; ++file) {
+      int idx = 0;
+      for (int rank = 1; rank <= 6; ++rank) {
+        int sq = rank * 8 + file;
+        if (lead == 1) {
+          m.pawns[sq] = available--;
+          m.pawns[sq ^ 7] = available--;
+        }
+        m.lead_pawn_idx[lead][sq] = idx;
+        idx += static_cast<int>(m.binomial[lead - 1][m.pawns[sq]]);
+      }
+      m.lead_pawns_size[lead][file] = idx;
+    }
+  }
+  return m;
+}
+}  // namespace _inner
+
+inline constexpr _inner::Maps MAPS = _inner::make_maps();
+
+// leading group of pawnless tables: kings and a unique piece, or the two kings
+constexpr uint64_t UNIQUE_LEAD_SIZE = 31332;
+constexpr uint64_t KINGS_LEAD_SIZE = 462;
+static_assert(MAPS.kk[9][63] == KINGS_LEAD_SIZE - 1);  // a1 and h8 both on the diagonal, the last pair
+
+// "KRvKN" -> counts with the first side white, nullopt if not a valid name
+inline std::optional<mailbox::CountsT> counts_of(std::string_view name) {
+  auto v = name.find('v');
+  if (v == std::string_view::npos) return std::nullopt;
+  mailbox::CountsT counts{};
+  size_t total = 0;
+  for (size_t i = 0; i < name.size(); ++i) {
+    if (i == v) continue;
+    Side side = i < v ? Side::WHITE : Side::BLACK;
+    size_t t = 0;
+    while (t < tb::_inner::TYPE_CHARS.size() && tb::_inner::TYPE_CHARS[t] != name[i]) ++t;
+    if (t == tb::_inner::TYPE_CHARS.size()) return std::nullopt;
+    ++counts[Piece{static_cast<Type>(t), side}.ordinal()];
+    ++total;
+  }
+  if (total > MAX_PIECES) return std::nullopt;
+  if (counts[Piece{Type::KING, Side::WHITE}.ordinal()] != 1 || counts[Piece{Type::KING, Side::BLACK}.ordinal()] != 1) {
+    return std::nullopt;
+  }
+  return counts;
+}
+
+// "KRvKN", white first whatever the material
+inline std::string material_of(const mailbox::CountsT& counts) {
+  return tb::_inner::side_signature(counts, Side::WHITE) + "v" + tb::_inner::side_signature(counts, Side::BLACK);
+}
+
+// file name of the material: the side with more pieces first, then the one with the stronger pieces (KBvKN)
+inline std::string name_of(const mailbox::CountsT& counts) {
+  auto rank = [](char c) { return std::string_view{"KQRBNP"}.find(c); };
+  std::string white = tb::_inner::side_signature(counts, Side::WHITE);
+  std::string black = tb::_inner::side_signature(counts, Side::BLACK);
+  bool swap = black.size() > white.size() ||
+              (black.size() == white.size() &&
+               std::lexicographical_compare(black.begin(), black.end(), white.begin(), white.end(),
+                                            [&](char a, char b) { return rank(a) < rank(b); }));
+  return swap ? black + "v" + white : white + "v" + black;
+}
+
+// what a table needs to know about its material, white being the first side of the file name
+struct Layout {
+  uint8_t size{0};
+  bool has_pawns{false};
+  bool unique{false};     // a side has some piece type other than the king exactly once
+  bool symmetric{false};  // both sides have the same pieces
+  Side lead{Side::WHITE};          // side of the leading pawns, the one with fewer pawns (white if equal)
+  std::array<uint8_t, 2> pawns{};  // [leading side, other side]
+};
+
+inline Layout layout_of(const mailbox::CountsT& counts) {
+  Layout l;
+  l.symmetric = true;
+  for (uint8_t t = 0; t < cast_t(Type::SIZE); ++t) {
+    uint8_t w = counts[Piece{static_cast<Type>(t), Side::WHITE}.ordinal()];
+    uint8_t b = counts[Piece{static_cast<Type>(t), Side::BLACK}.ordinal()];
+    l.size += w + b;
+    l.symmetric &= w == b;
+    if (static_cast<Type>(t) != Type::KING) l.unique |= w == 1 || b == 1;
+  }
+  uint8_t wp = counts[Piece{Type::PAWN, Side::WHITE}.ordinal()];
+  uint8_t bp = counts[Piece{Type::PAWN, Side::BLACK}.ordinal()];
+  l.has_pawns = wp + bp > 0;
+  bool white_leads = bp == 0 || (wp > 0 && bp >= wp);
+  l.lead = white_leads ? Side::WHITE : Side::BLACK;
+  l.pawns = {white_leads ? wp : bp, white_leads ? bp : wp};
+  return l;
+}
+
+// How a table groups its pieces. The pieces of a group are encoded together: first the leading group (the leading
+// pawns, or the kings and a unique piece, or the two kings), then the other pawns and one group per piece type.
+// order[0] and order[1] place the leading group and the other pawns among the factors of the index.
+struct Encoding {
+  std::array<uint8_t, MAX_PIECES> pieces{};          // piece codes in table order
+  std::array<uint8_t, MAX_PIECES + 1> group_len{};   // 0 terminated
+  std::array<uint64_t, MAX_PIECES + 1> group_idx{};  // factor of each group, the one after the last is the size
+
+  uint64_t size() const {
+    size_t n = 0;
+    while (group_len[n] != 0) ++n;
+    return group_idx[n];
+  }
+};
+
+// file 0..3 of the leading pawn with pawns, else 0
+inline Encoding make_encoding(const Layout& l, const std::array<uint8_t, MAX_PIECES>& pieces,
+                              const std::array<uint8_t, 2>& order, int file) {
+  Encoding e;
+  e.pieces = pieces;
+  size_t n = 0;
+  int first = l.has_pawns ? 0 : l.unique ? 3 : 2;
+  e.group_len[0] = 1;
+  for (size_t i = 1; i < l.size; ++i) {
+    if (--first > 0 || pieces[i] == pieces[i - 1]) {
+      ++e.group_len[n];
+    } else {
+      e.group_len[++n] = 1;
+    }
+  }
+  e.group_len[++n] = 0;
+
+  bool both_pawns = l.has_pawns && l.pawns[1] > 0;
+  size_t next = both_pawns ? 2 : 1;
+  int free = 64 - e.group_len[0] - (both_pawns ? e.group_len[1] : 0);
+  uint64_t idx = 1;
+  for (uint8_t k = 0; next < n || k == order[0] || k == order[1]; ++k) {
+    if (k == order[0]) {
+      e.group_idx[0] = idx;
+      idx *= l.has_pawns ? MAPS.lead_pawns_size[e.group_len[0]][file] : l.unique ? UNIQUE_LEAD_SIZE : KINGS_LEAD_SIZE;
+    } else if (k == order[1]) {
+      e.group_idx[1] = idx;
+      idx *= MAPS.binomial[e.group_len[1]][48 - e.group_len[0]];
+    } else {
+      e.group_idx[next] = idx;
+      idx *= MAPS.binomial[e.group_len[next]][free];
+      free -= e.group_len[next++];
+    }
+  }
+  e.group_idx[n] = idx;
+  return e;
+}
+
+// a position as seen by a table: colors swapped and ranks mirrored when the table's white is black
+struct Position {
+  std::array<uint8_t, MAX_PIECES> pieces{};  // codes
+  std::array<uint8_t, MAX_PIECES> squares{};
+  uint8_t size{0};
+};
+
+// moves the pawns of lead_code to the front, the leading one first, and returns its file folded to 0..3
+inline int lead_file(uint8_t lead_code, Position& p) {
+  size_t lead = 0;
+  for (size_t i = 0; i < p.size; ++i) {
+    if (p.pieces[i] != lead_code) continue;
+    std::swap(p.pieces[i], p.pieces[lead]);
+    std::swap(p.squares[i], p.squares[lead]);
+    ++lead;
+  }
+  auto best = std::max_element(p.squares.begin(), p.squares.begin() + lead,
+                               [](uint8_t a, uint8_t b) { return MAPS.pawns[a] < MAPS.pawns[b]; });
+  std::swap(p.squares[0], *best);
+  int file = p.squares[0] % 8;
+  return std::min(file, 7 - file);
+}
+
+// index in the table of e, with pawns after lead_file()
+inline uint64_t index_of(const Layout& l, const Encoding& e, Position p) {
+  const size_t lead = l.has_pawns ? l.pawns[0] : 0;
+  auto& sq = p.squares;
+  for (size_t i = lead; i + 1 < p.size; ++i) {
+    if (p.pieces[i] == e.pieces[i]) continue;
+    for (size_t j = i + 1; j < p.size; ++j) {
+      if (p.pieces[j] != e.pieces[i]) continue;
+      std::swap(p.pieces[i], p.pieces[j]);
+      std::swap(sq[i], sq[j]);
+      break;
+    }
+  }
+
+  if (sq[0] % 8 > 3) {
+    for (size_t i = 0; i < p.size; ++i) sq[i] ^= 7;
+  }
+
+  uint64_t idx = 0;
+  if (l.has_pawns) {
+    idx = MAPS.lead_pawn_idx[lead][sq[0]];
+    std::stable_sort(sq.begin() + 1, sq.begin() + lead,
+                     [](uint8_t a, uint8_t b) { return MAPS.pawns[a] < MAPS.pawns[b]; });
+    for (size_t i = 1; i < lead; ++i) idx += MAPS.binomial[i][MAPS.pawns[sq[i]]];
+  } else {
+    if (sq[0] / 8 > 3) {
+      for (size_t i = 0; i < p.size; ++i) sq[i] ^= 56;
+    }
+    // the first piece of the leading group off the a1-h8 diagonal goes below it
+    for (size_t i = 0; i < e.group_len[0]; ++i) {
+      int off = _inner::off_diagonal(sq[i]);
+      if (off == 0) continue;
+      if (off > 0) {
+        for (size_t j = i; j < p.size; ++j) sq[j] = static_cast<uint8_t>(((sq[j] >> 3) | (sq[j] << 3)) & 63);
+      }
+      break;
+    }
+
+    if (l.unique) {
+      uint64_t adjust1 = sq[1] > sq[0];
+      uint64_t adjust2 = (sq[2] > sq[0]) + (sq[2] > sq[1]);
+      auto rank = [](uint8_t s) -> uint64_t { return s / 8; };
+      if (_inner::off_diagonal(sq[0]) != 0) {
+        idx = (MAPS.a1d1d4[sq[0]] * 63 + (sq[1] - adjust1)) * 62 + sq[2] - adjust2;
+      } else if (_inner::off_diagonal(sq[1]) != 0) {
+        idx = (6 * 63 + rank(sq[0]) * 28 + MAPS.b1h1h7[sq[1]]) * 62 + sq[2] - adjust2;
+      } else if (_inner::off_diagonal(sq[2]) != 0) {
+        idx = 6 * 63 * 62 + 4 * 28 * 62 + rank(sq[0]) * 7 * 28 + (rank(sq[1]) - adjust1) * 28 + MAPS.b1h1h7[sq[2]];
+      } else {
+        idx = 6 * 63 * 62 + 4 * 28 * 62 + 4 * 7 * 28 + rank(sq[0]) * 7 * 6 + (rank(sq[1]) - adjust1) * 6 +
+              (rank(sq[2]) - adjust2);
+      }
+    } else {
+      idx = MAPS.kk[MAPS.a1d1d4[sq[0]]][sq[1]];
+    }
+  }
+  idx *= e.group_idx[0];
+
+  // the other groups by ascending squares, skipping the squares taken by the groups before
+  bool other_pawns = l.has_pawns && l.pawns[1] > 0;
+  size_t begin = e.group_len[0];
+  for (size_t g = 1; e.group_len[g] != 0; ++g) {
+    size_t end = begin + e.group_len[g];
+    std::sort(sq.begin() + begin, sq.begin() + end);
+    uint64_t n = 0;
+    for (size_t i = begin; i < end; ++i) {
+      auto adjust = std::count_if(sq.begin(), sq.begin() + begin, [&](uint8_t s) { return sq[i] > s; });
+      n += MAPS.binomial[i - begin + 1][sq[i] - adjust - (other_pawns ? 8 : 0)];
+    }
+    other_pawns = false;
+    idx += n * e.group_idx[g];
+    begin = end;
+  }
+  return idx;
+}
+
+}  // namespace dwc::tb::syzygy
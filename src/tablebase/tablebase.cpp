@@ -0,0 +1,68 @@
+#include "tablebase.hpp"
+
+#include <filesystem>
+
+namespace dwc::tb {
+
+Tablebase::Tablebase(const std::string& dir) {
+  namespace fs = std::filesystem;
+  std::error_code ec;
+  for (const auto& file : fs::directory_iterator(dir, ec)) {
+    if (!file.is_regular_file() || file.path().extension() != EXTENSION) continue;
+    auto sig = signature_of(file.path().stem().string());
+    if (!sig.has_value()) continue;
+    auto table = std::make_unique<Table>();
+    table->path = file.path().string();
+    table->sig = *sig;
+    max_pieces_ = std::max<size_t>(max_pieces_, sig->material.size);
+    tables_.emplace(sig->name, std::move(table));
+  }
+}
+
+const Tablebase::Table* Tablebase::find(const Board& board, size_t& idx) const {
+  const State& state = board.get_state();
+  if (!state.castling.empty()) return nullptr;
+  auto sig = signature_of(board.get_mailbox().counts());
+  if (!sig.has_value()) return nullptr;
+  auto it = tables_.find(sig->name);
+  if (it == tables_.end()) return nullptr;
+
+  Table& table = *it->second;
+  std::call_once(table.mapped, [&table] {
+    utils::MappedFile file{table.path};
+    table.with_distance = check_header(file.data(), file.size(), table.sig.material);
+    file.advise_random();
+    table.file = std::move(file);
+  });
+
+  idx = index_of(table.sig.material, placement_of(*sig, state));
+  return &table;
+}
+
+std::optional<Wdl> Tablebase::read_wdl(const Table& table, size_t idx) {
+  uint8_t byte = table.file.data()[HEADER_SIZE + idx / 4];
+  return to_wdl((byte >> (idx % 4 * 2)) & 0x3);
+}
+
+std::optional<Wdl> Tablebase::probe_wdl(const Board& board) const {
+  size_t idx = 0;
+  const Table* table = find(board, idx);
+  if (table == nullptr) return std::nullopt;
+  return read_wdl(*table, idx);
+}
+
+std::optional<int> Tablebase::probe_dtz(const Board& board) const {
+  size_t idx = 0;
+  const Table* table = find(board, idx);
+  if (table == nullptr) return std::nullopt;
+  auto wdl = read_wdl(*table, idx);
+  if (!wdl.has_value()) return std::nullopt;
+  if (*wdl == Wdl::DRAW) return 0;
+  if (!table->with_distance) return std::nullopt;
+
+  const uint8_t* distances = table->file.data() + HEADER_SIZE + wdl_bytes(table_size(table->sig.material));
+  int plies = distances[idx];
+  return *wdl == Wdl::WIN ? plies : -plies;
+}
+
+}  // namespace dwc::tb
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+
+#include "src/framework/board.hpp"
+#include "src/shared/mapped_file.hpp"
+#include "src/tablebase/format.hpp"
+
+namespace dwc::tb {
+
+// dwtb tables of a directory (the ones egtb_gen writes), see format.hpp. Syzygy files are read by tb::Syzygy.
+// The directory is scanned once at construction, a file is only mapped by the first probe needing it. Probing is
+// thread safe, tables are never unmapped while the Tablebase lives.
+class Tablebase {
+  struct Table {
+    std::string path;
+    Signature sig;
+    std::once_flag mapped;
+    utils::MappedFile file;
+    bool with_distance{false};
+  };
+
+  // immutable after construction apart from the lazily mapped files
+  std::map<std::string, std::unique_ptr<Table>, std::less<>> tables_;
+  size_t max_pieces_{0};
+
+  // table and index of the position, nullptr if not covered
+  const Table* find(const Board& board, size_t& idx) const;
+  static std::optional<Wdl> read_wdl(const Table& table, size_t idx);
+
+ public:
+  explicit Tablebase(const std::string& dir);
+
+  size_t size() const { return tables_.size(); }
+  // most pieces of any table, 0 if none
+  size_t max_pieces() const { return max_pieces_; }
+
+  // for the side to move, nullopt when there's no table (castling rights, too many pieces, file missing)
+  std::optional<Wdl> probe_wdl(const Board& board) const;
+
+  // plies to mate or to the next capture, positive if the side to move wins, negative if it loses, 0 for draws.
+  // nullopt also when the table has no distance section.
+  std::optional<int> probe_dtz(const Board& board) const;
+};
+
+}  // namespace dwc::tb
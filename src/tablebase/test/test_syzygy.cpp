@@ -0,0 +1,190 @@
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <random>
+
+#include "src/shared/test/temp_dir.hpp"
+#include "src/tablebase/syzygy.hpp"
+#include "src/tablebase/syzygy_format.hpp"
+
+using namespace dwc;
+using namespace dwc::tb;
+using namespace dwc::tb::syzygy;
+
+namespace {
+
+constexpr uint8_t P = 1, R = 4, K = 6;
+constexpr uint8_t p = P + 8, k = K + 8;
+
+Encoding encoding_of(std::string_view name, const std::vector<uint8_t>& pieces, int file = 0) {
+  Layout l = layout_of(*counts_of(name));
+  std::array<uint8_t, syzygy::MAX_PIECES> arr{};
+  std::copy(pieces.begin(), pieces.end(), arr.begin());
+  return make_encoding(l, arr, {0, static_cast<uint8_t>(l.pawns[1] > 0 ? 1 : 0xf)}, file);
+}
+
+Position placement(const std::vector<uint8_t>& pieces, const std::vector<uint8_t>& squares) {
+  Position res;
+  for (size_t i = 0; i < pieces.size(); ++i) {
+    res.pieces[res.size] = pieces[i];
+    res.squares[res.size++] = squares[i];
+  }
+  return res;
+}
+
+// one of the 8 symmetries of the board: file mirror, rank mirror, a1-h8 transpose
+uint8_t transform(uint8_t sq, int t) {
+  if (t & 4) sq = static_cast<uint8_t>((sq >> 3) | ((sq & 7) << 3));
+  if (t & 1) sq ^= 7;
+  if (t & 2) sq ^= 56;
+  return sq;
+}
+
+// same index <=> same position up to the symmetries, the pieces of a group being interchangeable
+void expect_injective(std::map<uint64_t, std::vector<uint8_t>>& seen, uint64_t idx, std::vector<uint8_t> orbit) {
+  auto [it, inserted] = seen.emplace(idx, orbit);
+  if (!inserted) {
+    ASSERT_EQ(it->second, orbit) << idx;
+  }
+}
+
+using SyzygyTest = test::TempDirTest;
+}  // namespace
+
+TEST(SYZYGY, Names) {
+  EXPECT_TRUE(counts_of("KRvK").has_value());
+  EXPECT_TRUE(counts_of("KvKR").has_value());
+  EXPECT_TRUE(counts_of("KQRvKRNN").has_value());
+  EXPECT_FALSE(counts_of("KQRvKRNNP").has_value());  // 8 pieces
+  EXPECT_FALSE(counts_of("KRvR").has_value());
+  EXPECT_FALSE(counts_of("KXvK").has_value());
+
+  EXPECT_EQ(name_of(*counts_of("KvKR")), "KRvK");
+  EXPECT_EQ(name_of(*counts_of("KNvKB")), "KBvKN");
+  EXPECT_EQ(name_of(*counts_of("KRvKNN")), "KNNvKR");  // more pieces first
+  EXPECT_EQ(name_of(*counts_of("KPvKQ")), "KQvKP");
+  EXPECT_EQ(material_of(*counts_of("KvKR")), "KvKR");
+
+  Layout l = layout_of(*counts_of("KPPvKP"));
+  EXPECT_TRUE(l.has_pawns);
+  EXPECT_EQ(l.lead, Side::BLACK);  // fewer pawns
+  EXPECT_EQ(l.pawns[0], 1);
+  EXPECT_EQ(l.pawns[1], 2);
+  EXPECT_TRUE(layout_of(*counts_of("KRvKR")).symmetric);
+  EXPECT_FALSE(layout_of(*counts_of("KRRvK")).unique);
+}
+
+TEST(SYZYGY, Sizes) {
+  EXPECT_EQ(encoding_of("KRvK", {K, k, R}).size(), 31332);
+  EXPECT_EQ(encoding_of("KRRvK", {K, k, R, R}).size(), 462 * 1891);
+  EXPECT_EQ(encoding_of("KPvK", {P, K, k}, 0).size(), 6 * 63 * 62);
+  EXPECT_EQ(encoding_of("KPvKP", {P, p, K, k}, 2).size(), 6 * 47 * 62 * 61);
+}
+
+TEST(SYZYGY, IndexUniquePieces) {
+  Layout l = layout_of(*counts_of("KRvK"));
+  Encoding e = encoding_of("KRvK", {K, k, R});
+  std::map<uint64_t, std::vector<uint8_t>> seen;
+  for (uint8_t wk = 0; wk < 64; ++wk) {
+    for (uint8_t bk = 0; bk < 64; ++bk) {
+      for (uint8_t r = 0; r < 64; ++r) {
+        if (wk == bk || wk == r || bk == r) continue;
+        uint64_t idx = index_of(l, e, placement({R, K, k}, {r, wk, bk}));
+        ASSERT_LT(idx, e.size());
+        std::vector<uint8_t> orbit{64, 64, 64};
+        for (int t = 0; t < 8; ++t) {
+          orbit = std::min(orbit, std::vector<uint8_t>{transform(wk, t), transform(bk, t), transform(r, t)});
+          ASSERT_EQ(index_of(l, e, placement({K, k, R}, {transform(wk, t), transform(bk, t), transform(r, t)})), idx);
+        }
+        expect_injective(seen, idx, orbit);
+      }
+    }
+  }
+}
+
+TEST(SYZYGY, IndexKingsAndGroup) {
+  Layout l = layout_of(*counts_of("KRRvK"));
+  Encoding e = encoding_of("KRRvK", {K, k, R, R});
+  std::map<uint64_t, std::vector<uint8_t>> seen;
+  std::mt19937 rng{42};
+  std::uniform_int_distribution<int> square{0, 63};
+  for (int n = 0; n < 200000; ++n) {
+    uint8_t s[4];
+    for (auto& sq : s) sq = static_cast<uint8_t>(square(rng));
+    if (s[0] == s[1] || s[0] == s[2] || s[0] == s[3] || s[1] == s[2] || s[1] == s[3] || s[2] == s[3]) continue;
+    if (std::abs(s[0] % 8 - s[1] % 8) <= 1 && std::abs(s[0] / 8 - s[1] / 8) <= 1) continue;  // touching kings
+    // both kings on one long diagonal: the rooks aren't transposed then and the mirror has its own index
+    auto a1h8 = [](uint8_t sq) { return sq / 8 == sq % 8; };
+    auto a8h1 = [](uint8_t sq) { return sq / 8 + sq % 8 == 7; };
+    if ((a1h8(s[0]) && a1h8(s[1])) || (a8h1(s[0]) && a8h1(s[1]))) continue;
+
+    uint64_t idx = index_of(l, e, placement({R, K, R, k}, {s[2], s[0], s[3], s[1]}));
+    ASSERT_LT(idx, e.size());
+    std::vector<uint8_t> orbit{64, 64, 64, 64};
+    for (int t = 0; t < 8; ++t) {
+      uint8_t r1 = transform(s[2], t);
+      uint8_t r2 = transform(s[3], t);
+      orbit = std::min(orbit, {transform(s[0], t), transform(s[1], t), std::min(r1, r2), std::max(r1, r2)});
+      ASSERT_EQ(index_of(l, e, placement({K, k, R, R}, {transform(s[0], t), transform(s[1], t), r2, r1})), idx);
+    }
+    expect_injective(seen, idx, orbit);
+  }
+}
+
+TEST(SYZYGY, IndexPawns) {
+  Layout l = layout_of(*counts_of("KPvKP"));
+  std::array<Encoding, 4> e;
+  for (int f = 0; f < 4; ++f) e[f] = encoding_of("KPvKP", {P, p, K, k}, f);
+  std::array<std::map<uint64_t, std::vector<uint8_t>>, 4> seen;
+  std::mt19937 rng{7};
+  std::uniform_int_distribution<int> square{0, 63};
+  std::uniform_int_distribution<int> pawn_square{8, 55};
+  for (int n = 0; n < 200000; ++n) {
+    uint8_t s[4] = {static_cast<uint8_t>(pawn_square(rng)), static_cast<uint8_t>(pawn_square(rng)),
+                    static_cast<uint8_t>(square(rng)), static_cast<uint8_t>(square(rng))};
+    if (s[0] == s[1] || s[0] == s[2] || s[0] == s[3] || s[1] == s[2] || s[1] == s[3] || s[2] == s[3]) continue;
+
+    Position pl = placement({K, p, k, P}, {s[2], s[1], s[3], s[0]});
+    int f = lead_file(P, pl);
+    EXPECT_EQ(f, std::min(s[0] % 8, 7 - s[0] % 8));
+    uint64_t idx = index_of(l, e[f], pl);
+    ASSERT_LT(idx, e[f].size());
+
+    Position mirrored = placement({P, p, K, k}, {uint8_t(s[0] ^ 7), uint8_t(s[1] ^ 7), uint8_t(s[2] ^ 7),
+                                                  uint8_t(s[3] ^ 7)});
+    ASSERT_EQ(lead_file(P, mirrored), f);
+    ASSERT_EQ(index_of(l, e[f], mirrored), idx);
+    std::vector<uint8_t> orbit{s[0], s[1], s[2], s[3]};
+    orbit = std::min(orbit, {uint8_t(s[0] ^ 7), uint8_t(s[1] ^ 7), uint8_t(s[2] ^ 7), uint8_t(s[3] ^ 7)});
+    expect_injective(seen[f], idx, orbit);
+  }
+}
+
+TEST_F(SyzygyTest, NoTables) {
+  Syzygy tb{dir_.string()};
+  EXPECT_EQ(tb.size(), 0);
+  EXPECT_EQ(tb.max_pieces(), 0);
+  EXPECT_EQ(tb.probe_wdl(Board{"7k/8/6K1/8/8/8/8/R7 w"}), std::nullopt);
+  EXPECT_EQ(tb.probe_dtz(Board{"7k/8/6K1/8/8/8/8/R7 w"}), std::nullopt);
+
+  // bare kings need no table
+  EXPECT_EQ(tb.probe_wdl(Board{"7k/8/6K1/8/8/8/8/8 w"}), Wdl::DRAW);
+  EXPECT_EQ(tb.probe_dtz(Board{"7k/8/6K1/8/8/8/8/8 w"}), 0);
+  // the rook can be taken, but the king has other moves and KRvK is needed for them
+  EXPECT_EQ(tb.probe_wdl(Board{"8/8/8/8/8/8/6Rk/K7 b"}), std::nullopt);
+  // a pawn that could promote
+  EXPECT_EQ(tb.probe_wdl(Board{"7k/P7/8/8/8/8/8/K7 w"}), std::nullopt);
+}
+
+TEST_F(SyzygyTest, BadFile) {
+  std::ofstream{dir_ / "KRvK.rtbw"} << "not a table";
+  std::ofstream{dir_ / "KRvX.rtbw"} << "not a name";
+  Syzygy tb{dir_.string()};
+  EXPECT_EQ(tb.size(), 1);
+  EXPECT_EQ(tb.max_pieces(), 3);
+  EXPECT_THROW(tb.probe_wdl(Board{"7k/8/6K1/8/8/8/8/R7 w"}), std::runtime_error);
+  // castling rights aren't in tables
+  EXPECT_EQ(tb.probe_wdl(Board{"4k3/8/8/8/8/8/8/R3K3 w Q"}), std::nullopt);
+}
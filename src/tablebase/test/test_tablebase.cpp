@@ -0,0 +1,148 @@
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include <vector>
+
+#include "src/shared/test/temp_dir.hpp"
+#include "src/tablebase/tablebase.hpp"
+
+using namespace dwc;
+using namespace dwc::tb;
+
+namespace {
+namespace fs = std::filesystem;
+
+struct TableData {
+  std::vector<uint8_t> wdl;
+  std::vector<uint8_t> distance;
+};
+
+// everything a draw, apart from what the test sets
+TableData make_table(const Material& m) {
+  size_t n = table_size(m);
+  return {std::vector<uint8_t>(wdl_bytes(n), 0xaa), std::vector<uint8_t>(n, 0)};
+}
+
+void set(TableData& t, size_t idx, Wdl wdl, uint8_t distance) {
+  t.wdl[idx / 4] = static_cast<uint8_t>((t.wdl[idx / 4] & ~(0x3 << (idx % 4 * 2))) | to_code(wdl) << (idx % 4 * 2));
+  t.distance[idx] = distance;
+}
+
+void write(const fs::path& dir, std::string_view name, const TableData& t, bool with_distance = true) {
+  auto sig = signature_of(name);
+  ASSERT_TRUE(sig.has_value());
+  std::ofstream ofs{dir / (std::string{name} + std::string{EXTENSION}), std::ios::binary};
+  auto h = make_header(sig->material, with_distance);
+  ofs.write(reinterpret_cast<const char*>(h.data()), h.size());
+  ofs.write(reinterpret_cast<const char*>(t.wdl.data()), t.wdl.size());
+  if (with_distance) ofs.write(reinterpret_cast<const char*>(t.distance.data()), t.distance.size());
+}
+
+size_t index(const Board& b) {
+  auto sig = signature_of(b.get_mailbox().counts());
+  return index_of(sig->material, placement_of(*sig, b.get_state()));
+}
+
+using TablebaseTest = test::TempDirTest;
+}  // namespace
+
+TEST(TABLEBASE, Signature) {
+  auto sig = signature_of(Board{"4k3/8/8/8/8/8/8/R3K3 w"}.get_mailbox().counts());
+  ASSERT_TRUE(sig.has_value());
+  EXPECT_EQ(sig->name, "KRvK");
+  EXPECT_FALSE(sig->flipped);
+  EXPECT_EQ(sig->material.size, 3);
+
+  // stronger side is black
+  sig = signature_of(Board{"3qk3/8/8/8/8/8/8/R3K3 w"}.get_mailbox().counts());
+  EXPECT_EQ(sig->name, "KQvKR");
+  EXPECT_TRUE(sig->flipped);
+  EXPECT_TRUE((sig->material.pieces[1] == Piece{Type::QUEEN, Side::WHITE}));
+
+  EXPECT_EQ(signature_of("KQvKR")->name, "KQvKR");
+  EXPECT_EQ(signature_of("KRRvKB")->material.size, 5);
+  EXPECT_FALSE(signature_of("KvKQ").has_value());  // not canonical
+  EXPECT_FALSE(signature_of("KXvK").has_value());
+  EXPECT_FALSE(signature_of("KQQQQQQvK").has_value());  // 8 pieces
+  EXPECT_FALSE(signature_of(Board{"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w"}.get_mailbox().counts()));
+}
+
+TEST(TABLEBASE, Index) {
+  auto sig = signature_of("KRvK");
+  size_t n = table_size(sig->material);
+  EXPECT_EQ(n, 2 * 64 * 64 * 64);
+  for (size_t idx : {size_t{0}, size_t{1}, size_t{12345}, n - 1}) {
+    EXPECT_EQ(index_of(sig->material, placement_of(sig->material, idx)), idx);
+  }
+
+  // a mirrored position maps to the same entry
+  Board b{"4k3/8/8/8/8/8/8/R3K3 w"};
+  Board mirrored{"r3k3/8/8/8/8/8/8/4K3 b"};
+  EXPECT_EQ(index(b), index(mirrored));
+}
+
+TEST_F(TablebaseTest, Probe) {
+  auto sig = signature_of("KRvK");
+  TableData krk = make_table(sig->material);
+  Board win{"7k/8/6K1/8/8/8/8/R7 w"};
+  Board loss{"7k/8/6K1/8/8/8/8/R7 b"};
+  set(krk, index(win), Wdl::WIN, 3);
+  set(krk, index(loss), Wdl::LOSS, 4);
+  write(dir_, "KRvK", krk);
+  write(dir_, "KvK", make_table(signature_of("KvK")->material), false);
+  std::ofstream{dir_ / "README.txt"} << "not a table";
+
+  Tablebase tb{dir_.string()};
+  EXPECT_EQ(tb.size(), 2);
+  EXPECT_EQ(tb.max_pieces(), 3);
+
+  EXPECT_EQ(tb.probe_wdl(win), Wdl::WIN);
+  EXPECT_EQ(tb.probe_dtz(win), 3);
+  EXPECT_EQ(tb.probe_wdl(loss), Wdl::LOSS);
+  EXPECT_EQ(tb.probe_dtz(loss), -4);
+
+  // colors swapped
+  Board flipped{"r7/8/8/8/8/6k1/8/7K b"};
+  EXPECT_EQ(tb.probe_wdl(flipped), Wdl::WIN);
+  EXPECT_EQ(tb.probe_dtz(flipped), 3);
+
+  Board draw{"7k/8/6K1/8/8/8/8/1R6 w"};
+  EXPECT_EQ(tb.probe_wdl(draw), Wdl::DRAW);
+  EXPECT_EQ(tb.probe_dtz(draw), 0);
+
+  Board kk{"7k/8/6K1/8/8/8/8/8 w"};
+  EXPECT_EQ(tb.probe_wdl(kk), Wdl::DRAW);
+  EXPECT_EQ(tb.probe_dtz(kk), 0);
+
+  // no table
+  EXPECT_EQ(tb.probe_wdl(Board{"7k/8/6K1/8/8/8/8/Q7 w"}), std::nullopt);
+  // castling rights aren't in tables
+  EXPECT_EQ(tb.probe_wdl(Board{"4k3/8/8/8/8/8/8/R3K3 w Q"}), std::nullopt);
+}
+
+TEST_F(TablebaseTest, Concurrent) {
+  auto sig = signature_of("KRvK");
+  TableData krk = make_table(sig->material);
+  Board win{"7k/8/6K1/8/8/8/8/R7 w"};
+  set(krk, index(win), Wdl::WIN, 3);
+  write(dir_, "KRvK", krk);
+
+  Tablebase tb{dir_.string()};
+  std::vector<std::thread> threads;
+  std::vector<int> hits(8, 0);
+  for (size_t t = 0; t < hits.size(); ++t) {
+    threads.emplace_back([&tb, &win, &hits, t] {
+      for (int i = 0; i < 1000; ++i) hits[t] += tb.probe_dtz(win) == 3;
+    });
+  }
+  for (auto& t : threads) t.join();
+  for (int h : hits) EXPECT_EQ(h, 1000);
+}
+
+TEST_F(TablebaseTest, BadFile) {
+  std::ofstream{dir_ / "KRvK.dwtb"} << "DWTB but too short";
+  Tablebase tb{dir_.string()};
+  EXPECT_THROW(tb.probe_wdl(Board{"7k/8/6K1/8/8/8/8/R7 w"}), std::runtime_error);
+}
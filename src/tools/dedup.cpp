@@ -0,0 +1,58 @@
+#include "dedup.hpp"
+
+#include <thread>
+#include <vector>
+
+#include "src/pgn/reader.hpp"
+
+namespace dwc::tools {
+namespace {
+// f(worker) on worker threads 0 .. n - 1
+template <typename F>
+void run_workers(size_t n, const F& f) {
+  std::vector<std::thread> pool;
+  for (size_t w = 1; w < n; ++w) pool.emplace_back(f, w);
+  f(0);
+  for (auto& t : pool) t.join();
+}
+}  // namespace
+
+DedupStats dedup_games(std::string_view pgn, size_t threads, PositionSet& set, uint32_t first_game) {
+  auto slices = pgn::split_games(pgn, std::max<size_t>(1, threads));
+
+  // game ids follow the file order, so every slice first needs the number of games before it
+  std::vector<size_t> counts(slices.size());
+  run_workers(slices.size(), [&](size_t w) {
+    pgn::GameReader reader{slices[w]};
+    while (reader.next()) ++counts[w];
+  });
+  std::vector<uint32_t> first(slices.size(), first_game);
+  for (size_t w = 1; w < slices.size(); ++w) first[w] = static_cast<uint32_t>(first[w - 1] + counts[w - 1]);
+
+  std::vector<DedupStats> stats(slices.size());
+  run_workers(slices.size(), [&](size_t w) {
+    pgn::GameReader reader{slices[w]};
+    uint32_t game = first[w];
+    DedupStats& st = stats[w];
+    for (const pgn::Game& g : reader) {
+      auto insert = [&](const Board& board) {
+        set.insert(board.get_key(), game);
+        ++st.positions;
+      };
+      auto res = pgn::replay(g, [&](const Board& board, Move) { insert(board); }, insert);
+      ++st.games;
+      if (!res.ok()) ++st.failed;
+      ++game;
+    }
+  });
+
+  DedupStats total;
+  for (const auto& st : stats) {
+    total.games += st.games;
+    total.failed += st.failed;
+    total.positions += st.positions;
+  }
+  return total;
+}
+
+}  // namespace dwc::tools
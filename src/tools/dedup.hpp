@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+#include "src/tools/position_set.hpp"
+
+namespace dwc::tools {
+
+struct DedupStats {
+  size_t games{0};
+  size_t failed{0};     // games with a move that couldn't be played, kept up to that move
+  size_t positions{0};  // inserted, duplicates included
+};
+
+// Inserts every position reached in the pgn games, start and final positions included, keyed by Board::get_key().
+// Game ids count the games in file order from first_game. The games are split over threads, see pgn::split_games().
+DedupStats dedup_games(std::string_view pgn, size_t threads, PositionSet& set, uint32_t first_game = 0);
+
+}  // namespace dwc::tools
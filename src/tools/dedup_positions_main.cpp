@@ -0,0 +1,69 @@
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "src/pgn/reader.hpp"
+#include "src/tools/dedup.hpp"
+
+// dedup_positions [--threads N] [--memory MB] [--tmp DIR] [--out FILE] PGN...
+// e.g. bazel run -c opt //src/tools:dedup_positions -- --memory 4096 --out /data/positions.tsv /data/games/*.pgn
+// Writes one "key count first_game" line per distinct position in key order, key as 16 hex digits. Game ids count
+// the games over all files in command line order.
+int main(int argc, char** argv) {
+  size_t threads = std::max(1u, std::thread::hardware_concurrency());
+  size_t memory_mb = 1024;
+  std::string tmp = std::filesystem::temp_directory_path().string();
+  std::string out;
+  std::vector<std::string> paths;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    if (arg == "--threads" && i + 1 < argc) {
+      threads = std::max<size_t>(1, std::strtoull(argv[++i], nullptr, 10));
+    } else if (arg == "--memory" && i + 1 < argc) {
+      memory_mb = std::strtoull(argv[++i], nullptr, 10);
+    } else if (arg == "--tmp" && i + 1 < argc) {
+      tmp = argv[++i];
+    } else if (arg == "--out" && i + 1 < argc) {
+      out = argv[++i];
+    } else {
+      paths.push_back(arg);
+    }
+  }
+  if (paths.empty()) {
+    std::cerr << "usage: dedup_positions [--threads N] [--memory MB] [--tmp DIR] [--out FILE] PGN..." << std::endl;
+    return 1;
+  }
+
+  try {
+    dwc::tools::PositionSet set{memory_mb << 20, tmp};
+    dwc::tools::DedupStats total;
+    for (const auto& path : paths) {
+      dwc::pgn::PgnFile file{path};
+      auto st = dwc::tools::dedup_games(file.data(), threads, set, static_cast<uint32_t>(total.games));
+      total.games += st.games;
+      total.failed += st.failed;
+      total.positions += st.positions;
+    }
+
+    FILE* f = out.empty() ? stdout : std::fopen(out.c_str(), "w");
+    if (f == nullptr) throw std::runtime_error("cannot write " + out);
+    size_t distinct = 0;
+    set.drain([f, &distinct](const dwc::tools::PositionSet::Entry& e) {
+      std::fprintf(f, "%016" PRIx64 "\t%" PRIu32 "\t%" PRIu32 "\n", e.key, e.count, e.first_game);
+      ++distinct;
+    });
+    if (f != stdout && std::fclose(f) != 0) throw std::runtime_error("cannot write " + out);
+
+    std::cerr << total.games << " games (" << total.failed << " failed), " << total.positions << " positions, "
+              << distinct << " distinct" << std::endl;
+  } catch (const std::exception& e) {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,232 @@
+#include "egtb_gen.hpp"
+
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <thread>
+
+#include "src/framework/move_gen.hpp"
+
+namespace dwc::tools {
+namespace {
+// state of a table index while generating
+enum Value : uint8_t {
+  ILLEGAL,    // pieces on the same square, or the side not to move is in check
+  OPEN,       // not decided yet
+  OPEN_DRAW,  // not decided yet, a capture holds the draw
+  WIN,
+  LOSS,
+  DRAW,
+};
+
+constexpr bool is_open(uint8_t v) {
+  return v == OPEN || v == OPEN_DRAW;
+}
+
+constexpr size_t CHUNK = 4096;
+
+// f(idx) for idx in [0, n), chunks handed out to the threads as they finish
+template <typename F>
+void parallel_for(size_t n, size_t threads, const F& f) {
+  std::atomic<size_t> next{0};
+  auto work = [&] {
+    for (size_t begin = next.fetch_add(CHUNK); begin < n; begin = next.fetch_add(CHUNK)) {
+      size_t end = std::min(n, begin + CHUNK);
+      for (size_t idx = begin; idx < end; ++idx) f(idx);
+    }
+  };
+  std::vector<std::thread> pool;
+  for (size_t t = 1; t < threads; ++t) pool.emplace_back(work);
+  work();
+  for (auto& t : pool) t.join();
+}
+
+Side other(Side side) {
+  return side == Side::WHITE ? Side::BLACK : Side::WHITE;
+}
+
+// nullopt if two pieces share a square
+std::optional<State> state_of(const tb::Material& m, const tb::Placement& p) {
+  State state;
+  state.castling.clear();
+  state.turn = p.turn;
+  uint64_t used = 0;
+  for (size_t i = 0; i < m.size; ++i) {
+    uint64_t bit = uint64_t{1} << p.squares[i];
+    if (used & bit) return std::nullopt;
+    used |= bit;
+    board_ut::set(Pos::from_index(p.squares[i]), m.pieces[i], state.board);
+  }
+  return state;
+}
+}  // namespace
+
+EgtbGenerator::EgtbGenerator(size_t threads)
+    : threads_(threads != 0 ? threads : std::max(1u, std::thread::hardware_concurrency())) {}
+
+const EgtbGenerator::Table* EgtbGenerator::find(std::string_view name) const {
+  auto it = tables_.find(name);
+  return it != tables_.end() ? &it->second : nullptr;
+}
+
+const EgtbGenerator::Table& EgtbGenerator::generate(std::string_view name) {
+  auto sig = tb::signature_of(name);
+  if (!sig.has_value()) throw std::invalid_argument("invalid material: " + std::string{name});
+  if (const Table* t = find(sig->name)) return *t;
+
+  const tb::Material& m = sig->material;
+  mailbox::CountsT counts{};
+  for (size_t i = 0; i < m.size; ++i) ++counts[m.pieces[i].ordinal()];
+  if (counts[Piece{Type::PAWN, Side::WHITE}.ordinal()] + counts[Piece{Type::PAWN, Side::BLACK}.ordinal()] > 0) {
+    throw std::invalid_argument("pawns are not supported: " + sig->name);
+  }
+
+  // every capture leads to a smaller table
+  for (size_t i = 0; i < m.size; ++i) {
+    if (m.pieces[i].type == Type::KING) continue;
+    mailbox::CountsT sub = counts;
+    --sub[m.pieces[i].ordinal()];
+    generate(tb::signature_of(sub)->name);
+  }
+
+  build(*sig);
+  return tables_.at(sig->name);
+}
+
+void EgtbGenerator::build(const tb::Signature& sig) {
+  const tb::Material& m = sig.material;
+  const size_t n = tb::table_size(m);
+  std::vector<std::atomic<uint8_t>> value(n);
+  std::vector<std::atomic<uint8_t>> dist(n);
+  std::vector<std::atomic<uint8_t>> remaining(n);  // moves not known to lose, captures excluded
+
+  // result of a capture, from the view of the side to move after it
+  auto captured_wdl = [this](const Board& child) {
+    auto child_sig = tb::signature_of(child.get_mailbox().counts());
+    const Table& t = tables_.at(child_sig->name);
+    auto wdl = t.wdl_at(tb::index_of(child_sig->material, tb::placement_of(*child_sig, child.get_state())));
+    if (!wdl.has_value()) throw std::logic_error("legal move into an illegal position");
+    return *wdl;
+  };
+
+  // mates, stalemates and the positions decided by a capture
+  parallel_for(n, threads_, [&](size_t idx) {
+    tb::Placement p = tb::placement_of(m, idx);
+    auto state = state_of(m, p);
+    if (!state.has_value()) return;
+    Board board{*state};
+    if (board.is_king_threatened(other(p.turn))) return;
+
+    bool any = false;
+    bool wins = false;
+    bool draws = false;
+    uint8_t quiet = 0;
+    for (const Move& move : iter::LegalMoves{board}) {
+      any = true;
+      if (!board.get(move.to).has_value()) {
+        ++quiet;
+        continue;
+      }
+      Board child = board;
+      child.apply_move(move);
+      tb::Wdl wdl = captured_wdl(child);
+      wins |= wdl == tb::Wdl::LOSS;
+      draws |= wdl == tb::Wdl::DRAW;
+    }
+
+    if (!any) {
+      value[idx] = board.is_king_threatened(p.turn) ? LOSS : DRAW;
+    } else if (wins) {
+      dist[idx] = 1;
+      value[idx] = WIN;
+    } else if (quiet == 0) {
+      dist[idx] = 1;
+      value[idx] = draws ? DRAW : LOSS;
+    } else {
+      remaining[idx] = quiet;
+      value[idx] = draws ? OPEN_DRAW : OPEN;
+    }
+  });
+
+  // retrograde: the positions decided at distance d decide their predecessors at d + 1.
+  // Predecessors are found by moving a piece of the side that just moved back to an empty square, pawnless moves
+  // are reversible. Distances are stored in a byte, the pass at 255 only checks that nothing is left to decide.
+  for (int d = 0; d <= UINT8_MAX; ++d) {
+    std::atomic<bool> found{false};
+    std::atomic<bool> overflow{false};
+    parallel_for(n, threads_, [&](size_t idx) {
+      uint8_t v = value[idx].load(std::memory_order_acquire);
+      if ((v != WIN && v != LOSS) || dist[idx].load(std::memory_order_relaxed) != d) return;
+      found.store(true, std::memory_order_relaxed);
+
+      tb::Placement p = tb::placement_of(m, idx);
+      Board board{*state_of(m, p)};
+      Side mover = other(p.turn);
+      MovesT moves;
+      for (size_t i = 0; i < m.size; ++i) {
+        if (m.pieces[i].side != mover) continue;
+        moves.clear();
+        board.get_pseudo_moves(Pos::from_index(p.squares[i]), moves);
+        for (const Move& move : moves) {
+          if (board.get(move.to).has_value()) continue;
+          tb::Placement prev = p;
+          prev.squares[i] = static_cast<uint8_t>(move.to.index());
+          prev.turn = mover;
+          size_t q = tb::index_of(m, prev);
+
+          uint8_t cur = value[q].load(std::memory_order_acquire);
+          if (!is_open(cur)) continue;
+          if (v == LOSS) {
+            if (d == UINT8_MAX) {
+              overflow.store(true, std::memory_order_relaxed);
+              continue;
+            }
+            // same level writers all store d + 1, the value goes last so scanners never see a stale distance
+            dist[q].store(static_cast<uint8_t>(d + 1), std::memory_order_relaxed);
+            while (is_open(cur) && !value[q].compare_exchange_weak(cur, WIN, std::memory_order_release)) {}
+          } else if (remaining[q].fetch_sub(1, std::memory_order_relaxed) == 1 && cur == OPEN) {
+            if (d == UINT8_MAX) {
+              overflow.store(true, std::memory_order_relaxed);
+              continue;
+            }
+            // every move loses, so no other thread can decide q meanwhile
+            dist[q].store(static_cast<uint8_t>(d + 1), std::memory_order_relaxed);
+            value[q].store(LOSS, std::memory_order_release);
+          }
+        }
+      }
+    });
+    // the undecided positions would be written as draws
+    if (overflow) throw std::runtime_error(sig.name + " has distances beyond " + std::to_string(UINT8_MAX) + " plies");
+    // distance 1 can be set up front by captures, later levels only come from the previous one
+    if (!found && d > 0) break;
+  }
+
+  Table table{sig, std::vector<uint8_t>(tb::wdl_bytes(n)), std::vector<uint8_t>(n)};
+  for (size_t idx = 0; idx < n; ++idx) {
+    uint8_t v = value[idx];
+    uint8_t code = v == ILLEGAL ? tb::WDL_NONE : v == WIN ? tb::WDL_WIN : v == LOSS ? tb::WDL_LOSS : tb::WDL_DRAW;
+    table.wdl[idx / 4] |= static_cast<uint8_t>(code << (idx % 4 * 2));
+    if (v == WIN || v == LOSS) table.distance[idx] = dist[idx];
+  }
+  tables_.emplace(sig.name, std::move(table));
+}
+
+std::vector<std::string> EgtbGenerator::write(const std::string& dir) const {
+  std::filesystem::create_directories(dir);
+  std::vector<std::string> paths;
+  for (const auto& [name, table] : tables_) {
+    std::string path = (std::filesystem::path{dir} / (name + std::string{tb::EXTENSION})).string();
+    std::ofstream ofs{path, std::ios::binary};
+    if (!ofs) throw std::runtime_error("cannot write " + path);
+    auto header = tb::make_header(table.sig.material, true);
+    ofs.write(reinterpret_cast<const char*>(header.data()), header.size());
+    ofs.write(reinterpret_cast<const char*>(table.wdl.data()), table.wdl.size());
+    ofs.write(reinterpret_cast<const char*>(table.distance.data()), table.distance.size());
+    paths.push_back(path);
+  }
+  return paths;
+}
+
+}  // namespace dwc::tools
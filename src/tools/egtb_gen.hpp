@@ -0,0 +1,48 @@
+#pragma once
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "src/framework/board.hpp"
+#include "src/tablebase/format.hpp"
+
+namespace dwc::tools {
+
+// Retrograde generator of the tables read by tb::Tablebase, pawnless material only (no promotions on Board yet).
+// Tables reached by captures are generated first. Memory is a few bytes per table index, positions are only turned
+// into a Board while being looked at.
+class EgtbGenerator {
+ public:
+  struct Table {
+    tb::Signature sig;
+    std::vector<uint8_t> wdl;       // 2 bits per index, see tb::WDL_*
+    std::vector<uint8_t> distance;  // DTC: plies to mate or to the winner's next capture, not to mate through it
+
+    std::optional<tb::Wdl> wdl_at(size_t idx) const { return tb::to_wdl((wdl[idx / 4] >> (idx % 4 * 2)) & 0x3); }
+  };
+
+ private:
+  size_t threads_;
+  std::map<std::string, Table, std::less<>> tables_;
+
+  void build(const tb::Signature& sig);
+
+ public:
+  // 0 uses all cores
+  explicit EgtbGenerator(size_t threads = 0);
+
+  // the table of the material, e.g. "KRvK", and the ones it converts to; throws std::invalid_argument on bad names
+  // and std::runtime_error when a distance doesn't fit its byte
+  const Table& generate(std::string_view name);
+
+  // nullptr if not generated
+  const Table* find(std::string_view name) const;
+
+  const std::map<std::string, Table, std::less<>>& tables() const { return tables_; }
+
+  // one <name>.dwtb per generated table, returns the paths
+  std::vector<std::string> write(const std::string& dir) const;
+};
+
+}  // namespace dwc::tools
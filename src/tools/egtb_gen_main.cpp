@@ -0,0 +1,54 @@
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "src/tools/egtb_gen.hpp"
+#include "src/tools/syzygy_writer.hpp"
+
+// egtb_gen [--threads N] [--out DIR] [--syzygy] MATERIAL...
+// e.g. bazel run -c opt //src/tools:egtb_gen -- --out /data/tb KQvK KRvK KQvKR
+// Writes dwtb files for tb::Tablebase, or with --syzygy .rtbw / .rtbz files for tb::Syzygy (no KvK file then).
+// Distances are DTC, not DTM: plies to mate or to the winner's next capture, which is Syzygy's DTZ without pawns.
+int main(int argc, char** argv) {
+  size_t threads = 0;
+  std::string out = ".";
+  bool syzygy = false;
+  std::vector<std::string> names;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    if (arg == "--threads" && i + 1 < argc) {
+      threads = std::strtoull(argv[++i], nullptr, 10);
+    } else if (arg == "--out" && i + 1 < argc) {
+      out = argv[++i];
+    } else if (arg == "--syzygy") {
+      syzygy = true;
+    } else {
+      names.push_back(arg);
+    }
+  }
+  if (names.empty()) {
+    std::cerr << "usage: egtb_gen [--threads N] [--out DIR] [--syzygy] MATERIAL..." << std::endl;
+    return 1;
+  }
+
+  try {
+    dwc::tools::EgtbGenerator gen{threads};
+    for (const auto& name : names) gen.generate(name);
+    std::vector<std::string> paths;
+    if (syzygy) {
+      for (const auto& [name, table] : gen.tables()) {
+        if (table.sig.material.size <= 2) continue;
+        auto written = dwc::tools::write_syzygy(table, out);
+        paths.insert(paths.end(), written.begin(), written.end());
+      }
+    } else {
+      paths = gen.write(out);
+    }
+    for (const auto& path : paths) std::cout << path << std::endl;
+  } catch (const std::exception& e) {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,199 @@
+#include "position_set.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <queue>
+#include <stdexcept>
+
+namespace dwc::tools {
+namespace {
+// tables grow or spill at 3/4 load
+bool is_full(size_t size, size_t slots) {
+  return size * 4 > slots * 3;
+}
+
+size_t floor_pow2(size_t n) {
+  size_t p = 1;
+  while (p * 2 <= n) p *= 2;
+  return p;
+}
+
+void merge_into(PositionSet::Entry& to, const PositionSet::Entry& from) {
+  to.count = static_cast<uint32_t>(std::min<uint64_t>(uint64_t{to.count} + from.count, UINT32_MAX));
+  to.first_game = std::min(to.first_game, from.first_game);
+}
+
+// sorted entries of a run file, read in chunks
+class RunReader {
+  static constexpr size_t CHUNK = 4096;
+  std::ifstream* ifs_;
+  size_t offset_;
+  size_t left_;
+  std::vector<PositionSet::Entry> buffer_;
+  size_t idx_{0};
+
+ public:
+  RunReader(std::ifstream& ifs, size_t offset, size_t size) : ifs_(&ifs), offset_(offset), left_(size) {}
+
+  // nullptr at the end of the run
+  const PositionSet::Entry* next() {
+    if (idx_ == buffer_.size()) {
+      if (left_ == 0) return nullptr;
+      buffer_.resize(std::min(CHUNK, left_));
+      ifs_->seekg(static_cast<std::streamoff>(offset_ * sizeof(PositionSet::Entry)));
+      if (!ifs_->read(reinterpret_cast<char*>(buffer_.data()), buffer_.size() * sizeof(PositionSet::Entry))) {
+        throw std::runtime_error("cannot read spill run");
+      }
+      offset_ += buffer_.size();
+      left_ -= buffer_.size();
+      idx_ = 0;
+    }
+    return &buffer_[idx_++];
+  }
+};
+}  // namespace
+
+PositionSet::PositionSet(size_t memory_budget, std::string spill_dir, size_t shard_bits)
+    : shard_bits_(shard_bits), spill_dir_(std::move(spill_dir)) {
+  if (shard_bits < 1 || shard_bits > 16) throw std::invalid_argument("shard bits must be 1 to 16");
+  shards_ = std::make_unique<Shard[]>(shard_count());
+  max_slots_ = std::max(MIN_SLOTS, floor_pow2(memory_budget / shard_count() / sizeof(Entry)));
+}
+
+PositionSet::~PositionSet() {
+  std::error_code ec;
+  for (size_t i = 0; i < shard_count(); ++i) {
+    if (shards_[i].run_end != 0) std::filesystem::remove(spill_path(i), ec);
+  }
+}
+
+std::string PositionSet::spill_path(size_t shard) const {
+  return (std::filesystem::path{spill_dir_} / ("dwc_positions_" + std::to_string(shard) + ".spill")).string();
+}
+
+void PositionSet::insert(uint64_t key, uint32_t game) {
+  size_t shard = key >> (64 - shard_bits_);
+  Shard& s = shards_[shard];
+  std::lock_guard lk(s.m);
+  Entry e{key, 1, game};
+  if (key == 0) {
+    merge_into(s.zero, e);
+    return;
+  }
+  if (s.table.empty()) s.table.resize(std::min(MIN_SLOTS * 16, max_slots_), Entry{0, 0, 0});
+
+  // keys are random, the low bits index the slot
+  size_t mask = s.table.size() - 1;
+  for (size_t idx = key & mask;; idx = (idx + 1) & mask) {
+    Entry& slot = s.table[idx];
+    if (slot.key == key) {
+      merge_into(slot, e);
+      return;
+    }
+    if (slot.key == 0) {
+      slot = e;
+      break;
+    }
+  }
+  if (!is_full(++s.size, s.table.size())) return;
+  if (s.table.size() < max_slots_) {
+    grow(s);
+  } else {
+    spill(shard, s);
+  }
+}
+
+void PositionSet::grow(Shard& s) {
+  std::vector<Entry> old(s.table.size() * 2, Entry{0, 0, 0});
+  old.swap(s.table);
+  size_t mask = s.table.size() - 1;
+  for (const Entry& e : old) {
+    if (e.key == 0) continue;
+    size_t idx = e.key & mask;
+    while (s.table[idx].key != 0) idx = (idx + 1) & mask;
+    s.table[idx] = e;
+  }
+}
+
+void PositionSet::spill(size_t shard, Shard& s) {
+  std::vector<Entry> run;
+  run.reserve(s.size);
+  for (Entry& e : s.table) {
+    if (e.key != 0) run.push_back(e);
+    e = Entry{0, 0, 0};
+  }
+  std::sort(run.begin(), run.end(), [](const Entry& a, const Entry& b) { return a.key < b.key; });
+
+  std::filesystem::create_directories(spill_dir_);
+  std::string path = spill_path(shard);
+  // the first run replaces whatever an earlier process left behind
+  std::ofstream ofs{path, std::ios::binary | (s.run_end == 0 ? std::ios::trunc : std::ios::app)};
+  ofs.write(reinterpret_cast<const char*>(run.data()), run.size() * sizeof(Entry));
+  if (!ofs) throw std::runtime_error("cannot write " + path);
+
+  s.runs.push_back({s.run_end, run.size()});
+  s.run_end += run.size();
+  s.size = 0;
+  spilled_.fetch_add(run.size(), std::memory_order_relaxed);
+}
+
+void PositionSet::drain(const std::function<void(const Entry&)>& f) {
+  for (size_t i = 0; i < shard_count(); ++i) drain(i, shards_[i], f);
+}
+
+void PositionSet::drain(size_t shard, Shard& s, const std::function<void(const Entry&)>& f) {
+  std::vector<Entry> memory;
+  memory.reserve(s.size + 1);
+  if (s.zero.count != 0) memory.push_back(s.zero);
+  for (const Entry& e : s.table) {
+    if (e.key != 0) memory.push_back(e);
+  }
+  std::sort(memory.begin(), memory.end(), [](const Entry& a, const Entry& b) { return a.key < b.key; });
+
+  // sources: the runs, then the table as one more sorted run
+  std::ifstream ifs;
+  if (!s.runs.empty()) {
+    ifs.open(spill_path(shard), std::ios::binary);
+    if (!ifs) throw std::runtime_error("cannot open " + spill_path(shard));
+  }
+  std::vector<RunReader> readers;
+  for (const Run& r : s.runs) readers.emplace_back(ifs, r.offset, r.size);
+  size_t memory_idx = 0;
+  auto next = [&](size_t source) -> const Entry* {
+    if (source < readers.size()) return readers[source].next();
+    return memory_idx < memory.size() ? &memory[memory_idx++] : nullptr;
+  };
+
+  using HeadT = std::pair<Entry, size_t>;
+  auto later = [](const HeadT& a, const HeadT& b) { return a.first.key > b.first.key; };
+  std::priority_queue<HeadT, std::vector<HeadT>, decltype(later)> heads{later};
+  for (size_t source = 0; source <= readers.size(); ++source) {
+    if (const Entry* e = next(source)) heads.push({*e, source});
+  }
+
+  std::optional<Entry> curr;
+  while (!heads.empty()) {
+    auto [e, source] = heads.top();
+    heads.pop();
+    if (const Entry* n = next(source)) heads.push({*n, source});
+    if (curr.has_value() && curr->key == e.key) {
+      merge_into(*curr, e);
+      continue;
+    }
+    if (curr.has_value()) f(*curr);
+    curr = e;
+  }
+  if (curr.has_value()) f(*curr);
+
+  ifs.close();
+  if (s.run_end != 0) std::filesystem::remove(spill_path(shard));
+  s.table = {};
+  s.size = 0;
+  s.zero = Entry{0, 0, UINT32_MAX};
+  s.runs.clear();
+  s.run_end = 0;
+}
+
+}  // namespace dwc::tools
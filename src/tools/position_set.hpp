@@ -0,0 +1,76 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace dwc::tools {
+
+// Counts of 64 bit position keys (Board::get_key()) with the first game each was seen in, for deduplicating large
+// game collections. Keys are sharded by their top bits, each shard an open addressing table behind its own lock, so
+// threads only meet when they hash into the same shard. When a shard would outgrow its part of the memory budget its
+// entries are sorted and spilled to a run file instead, drain() merges the runs back. Sets larger than RAM only cost
+// disk space.
+class PositionSet {
+ public:
+  struct Entry {
+    uint64_t key;
+    uint32_t count;
+    uint32_t first_game;  // smallest game id the key was inserted with
+  };
+
+ private:
+  struct Run {
+    size_t offset;  // in entries
+    size_t size;
+  };
+
+  struct Shard {
+    std::mutex m;
+    std::vector<Entry> table;  // key 0 marks an empty slot
+    size_t size{0};
+    Entry zero{0, 0, UINT32_MAX};  // key 0 itself
+    std::vector<Run> runs;
+    size_t run_end{0};  // entries in the shard's run file
+  };
+
+  size_t shard_bits_;
+  size_t max_slots_;  // per shard
+  std::string spill_dir_;
+  std::unique_ptr<Shard[]> shards_;
+  std::atomic<size_t> spilled_{0};
+
+  size_t shard_count() const { return size_t{1} << shard_bits_; }
+  std::string spill_path(size_t shard) const;
+  void grow(Shard& s);
+  void spill(size_t shard, Shard& s);
+  void drain(size_t shard, Shard& s, const std::function<void(const Entry&)>& f);
+
+ public:
+  static constexpr size_t MIN_SLOTS = 64;
+
+  // memory_budget in bytes for all tables together, spill files go to spill_dir (created when first needed, one set
+  // per directory).
+  // shard_bits from 1 to 16, throws std::invalid_argument otherwise.
+  PositionSet(size_t memory_budget, std::string spill_dir, size_t shard_bits = 8);
+  // removes the spill files
+  ~PositionSet();
+  PositionSet(const PositionSet&) = delete;
+  PositionSet& operator=(const PositionSet&) = delete;
+
+  // thread safe
+  void insert(uint64_t key, uint32_t game);
+
+  // entries written to run files so far, a key spilled twice counts twice
+  size_t spilled() const { return spilled_.load(std::memory_order_relaxed); }
+
+  // f(entry) once per distinct key in ascending key order, runs merged; leaves the set empty.
+  // Not thread safe, no insert() may run meanwhile. Throws std::runtime_error if a run file can't be read.
+  void drain(const std::function<void(const Entry&)>& f);
+};
+
+}  // namespace dwc::tools
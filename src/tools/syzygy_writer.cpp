@@ -0,0 +1,304 @@
+#include "syzygy_writer.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <queue>
+#include <stdexcept>
+
+#include "src/tablebase/syzygy_format.hpp"
+
+namespace dwc::tools {
+namespace {
+using namespace tb::syzygy;
+
+constexpr uint8_t BLOCK_BITS = 6;  // 64 byte blocks
+constexpr uint8_t SPAN_BITS = 10;
+// values per block, keeps the sparse entries past the last value within 16 bit offsets
+constexpr size_t BLOCK_VALUES = 32768;
+// the reader refills 32 bits at a time
+constexpr size_t MAX_CODE_LEN = 24;
+
+void put_le(std::vector<uint8_t>& out, uint64_t v, size_t bytes) {
+  for (size_t i = 0; i < bytes; ++i) out.push_back(static_cast<uint8_t>(v >> (8 * i)));
+}
+
+void append(std::vector<uint8_t>& out, const std::vector<uint8_t>& bytes) {
+  out.insert(out.end(), bytes.begin(), bytes.end());
+}
+
+void align(std::vector<uint8_t>& out, size_t to) {
+  while (out.size() % to != 0) out.push_back(0);
+}
+
+// Huffman code length by value, frequencies flattened until the longest code fits
+std::map<int, size_t> code_lengths(std::map<int, uint64_t> freq) {
+  while (true) {
+    std::vector<size_t> parent(freq.size(), 0);
+    using Node = std::pair<uint64_t, size_t>;
+    std::priority_queue<Node, std::vector<Node>, std::greater<>> queue;
+    size_t n = 0;
+    for (const auto& [value, f] : freq) queue.emplace(f, n++);
+    while (queue.size() > 1) {
+      auto [fa, a] = queue.top();
+      queue.pop();
+      auto [fb, b] = queue.top();
+      queue.pop();
+      parent.push_back(0);
+      parent[a] = parent[b] = parent.size() - 1;
+      queue.emplace(fa + fb, parent.size() - 1);
+    }
+
+    std::map<int, size_t> res;
+    size_t longest = 0;
+    size_t leaf = 0;
+    for (const auto& [value, f] : freq) {
+      size_t len = 0;
+      for (size_t node = leaf++; node != parent.size() - 1; node = parent[node]) ++len;
+      res[value] = len;
+      longest = std::max(longest, len);
+    }
+    if (longest <= MAX_CODE_LEN) return res;
+    for (auto& [value, f] : freq) f = f / 2 + 1;
+  }
+}
+
+// the sections of one table
+struct Compressed {
+  std::vector<uint8_t> sizes;
+  std::vector<uint8_t> sparse;
+  std::vector<uint8_t> block_lengths;
+  std::vector<uint8_t> blocks;
+};
+
+Compressed compress(const std::vector<int>& values, uint8_t flags) {
+  Compressed c;
+  std::map<int, uint64_t> freq;
+  for (int v : values) ++freq[v];
+  if (freq.size() == 1) {
+    c.sizes = {static_cast<uint8_t>(flags | FLAG_SINGLE_VALUE), static_cast<uint8_t>(freq.begin()->first)};
+    return c;
+  }
+
+  // canonical code: symbols by decreasing length, longer codes numerically lower
+  auto lengths = code_lengths(freq);
+  std::vector<int> symbols;
+  for (const auto& [value, len] : lengths) symbols.push_back(value);
+  std::stable_sort(symbols.begin(), symbols.end(), [&](int a, int b) { return lengths[a] > lengths[b]; });
+  size_t max_len = lengths[symbols.front()];
+  size_t min_len = lengths[symbols.back()];
+
+  std::map<int, std::pair<uint64_t, size_t>> codes;  // value -> code, length
+  uint64_t code = 0;
+  size_t len = max_len;
+  for (int value : symbols) {
+    for (; len > lengths[value]; --len) code >>= 1;
+    codes[value] = {code++, len};
+  }
+
+  // blocks of whole codes, MSB first
+  const size_t block_size = size_t{1} << BLOCK_BITS;
+  std::vector<uint64_t> starts;
+  size_t bits = 0;
+  size_t count = 0;
+  for (size_t idx = 0; idx < values.size(); ++idx) {
+    auto [v, n] = codes[values[idx]];
+    if (starts.empty() || bits + n > 8 * block_size || count == BLOCK_VALUES) {
+      if (!starts.empty()) put_le(c.block_lengths, count - 1, 2);
+      starts.push_back(idx);
+      c.blocks.resize(c.blocks.size() + block_size, 0);
+      bits = 0;
+      count = 0;
+    }
+    uint8_t* block = c.blocks.data() + (starts.size() - 1) * block_size;
+    for (size_t i = 0; i < n; ++i, ++bits) {
+      if ((v >> (n - 1 - i)) & 1) block[bits / 8] |= static_cast<uint8_t>(0x80 >> (bits % 8));
+    }
+    ++count;
+  }
+  put_le(c.block_lengths, count - 1, 2);
+
+  // block and offset of the values k * span + span / 2, past the end counted from the last block
+  const uint64_t span = uint64_t{1} << SPAN_BITS;
+  for (uint64_t k = 0; k * span < values.size(); ++k) {
+    uint64_t idx = k * span + span / 2;
+    size_t block = std::upper_bound(starts.begin(), starts.end(), idx) - starts.begin() - 1;
+    put_le(c.sparse, block, 4);
+    put_le(c.sparse, idx - starts[block], 2);
+  }
+
+  c.sizes = {flags, BLOCK_BITS, SPAN_BITS, 0};
+  put_le(c.sizes, starts.size(), 4);
+  c.sizes.push_back(static_cast<uint8_t>(max_len));
+  c.sizes.push_back(static_cast<uint8_t>(min_len));
+  // first symbol of each length, the symbols longer than it
+  for (size_t l = min_len; l <= max_len; ++l) {
+    put_le(c.sizes, std::count_if(symbols.begin(), symbols.end(), [&](int v) { return lengths[v] > l; }), 2);
+  }
+  put_le(c.sizes, symbols.size(), 2);
+  for (int value : symbols) {
+    c.sizes.push_back(static_cast<uint8_t>(value & 0xff));
+    c.sizes.push_back(static_cast<uint8_t>(((value >> 8) & 0xf) | ((LEAF & 0xf) << 4)));
+    c.sizes.push_back(static_cast<uint8_t>(LEAF >> 4));
+  }
+  if (symbols.size() % 2 != 0) c.sizes.push_back(0);
+  return c;
+}
+
+// unset entries take the most common value
+void fill(std::vector<int>& values) {
+  std::map<int, uint64_t> freq;
+  for (int v : values) {
+    if (v >= 0) ++freq[v];
+  }
+  int common = 0;
+  uint64_t best = 0;
+  for (const auto& [value, f] : freq) {
+    if (f > best) best = f, common = value;
+  }
+  std::replace(values.begin(), values.end(), -1, common);
+}
+
+// table pieces: leading pawns and other pawns, or the kings and a unique piece, then the rest grouped by code
+std::vector<uint8_t> table_pieces(const mailbox::CountsT& counts, const Layout& l) {
+  std::vector<uint8_t> res;
+  mailbox::CountsT left = counts;
+  auto take = [&](Piece p) {
+    --left[p.ordinal()];
+    res.push_back(code_of(p));
+  };
+  Side other = l.lead == Side::WHITE ? Side::BLACK : Side::WHITE;
+  for (size_t i = 0; i < l.pawns[0]; ++i) take({Type::PAWN, l.lead});
+  for (size_t i = 0; i < l.pawns[1]; ++i) take({Type::PAWN, other});
+  take({Type::KING, Side::WHITE});
+  take({Type::KING, Side::BLACK});
+  if (!l.has_pawns && l.unique) {
+    bool found = false;
+    for (Side side : {Side::WHITE, Side::BLACK}) {
+      for (Type type : {Type::QUEEN, Type::ROOK, Type::BISHOP, Type::KNIGHT}) {
+        if (found || counts[Piece{type, side}.ordinal()] != 1) continue;
+        take({type, side});
+        found = true;
+      }
+    }
+  }
+  for (Side side : {Side::WHITE, Side::BLACK}) {
+    for (Type type : {Type::QUEEN, Type::ROOK, Type::BISHOP, Type::KNIGHT, Type::PAWN}) {
+      while (left[Piece{type, side}.ordinal()] > 0) take({type, side});
+    }
+  }
+  return res;
+}
+}  // namespace
+
+std::vector<std::string> write_syzygy(const EgtbGenerator::Table& table, const std::string& dir) {
+  const tb::Material& m = table.sig.material;
+  if (m.size <= 2) throw std::invalid_argument("no syzygy file for " + table.sig.name);
+
+  // the table's white is the first side of the Syzygy name
+  mailbox::CountsT counts{};
+  for (size_t i = 0; i < m.size; ++i) ++counts[m.pieces[i].ordinal()];
+  const std::string name = name_of(counts);
+  const bool swap = name != material_of(counts);
+  if (swap) {
+    for (size_t o = 0; o < counts.size(); o += 2) std::swap(counts[o], counts[o + 1]);
+  }
+  const Layout l = layout_of(counts);
+  const bool both_pawns = l.has_pawns && l.pawns[1] > 0;
+  const int files = l.has_pawns ? 4 : 1;
+  const uint8_t lead_code = code_of({Type::PAWN, l.lead});
+
+  std::array<uint8_t, tb::syzygy::MAX_PIECES> pieces{};
+  auto listed = table_pieces(counts, l);
+  std::copy(listed.begin(), listed.end(), pieces.begin());
+  const std::array<uint8_t, 2> order{0, static_cast<uint8_t>(both_pawns ? 1 : 0xf)};
+
+  // [dtz][side to move][file], dtz only for white to move
+  std::array<std::array<std::array<Encoding, 4>, 2>, 2> enc;
+  std::array<std::array<std::array<std::vector<int>, 4>, 2>, 2> values;
+  for (int dtz = 0; dtz < 2; ++dtz) {
+    int sides = !dtz && !l.symmetric ? 2 : 1;
+    for (int s = 0; s < sides; ++s) {
+      for (int f = 0; f < files; ++f) {
+        enc[dtz][s][f] = make_encoding(l, pieces, order, f);
+        values[dtz][s][f].assign(enc[dtz][s][f].size(), -1);
+      }
+    }
+  }
+
+  for (size_t idx = 0; idx < tb::table_size(m); ++idx) {
+    auto wdl = table.wdl_at(idx);
+    if (!wdl.has_value()) continue;
+    tb::Placement np = tb::placement_of(m, idx);
+    int stm = (np.turn == Side::BLACK) != swap;
+    // symmetric material only stores white to move, the other half is its mirror
+    if (l.symmetric && stm == 1) continue;
+
+    Position p;
+    for (size_t i = 0; i < m.size; ++i) {
+      uint8_t code = code_of(m.pieces[i]);
+      p.pieces[p.size] = swap ? swap_color(code) : code;
+      p.squares[p.size++] = swap ? np.squares[i] ^ 56 : np.squares[i];
+    }
+    int f = l.has_pawns ? lead_file(lead_code, p) : 0;
+
+    int plies = *wdl == tb::Wdl::LOSS ? std::max<int>(table.distance[idx], 1) : table.distance[idx];
+    bool cursed = plies > 100;
+    int w = *wdl == tb::Wdl::WIN ? (cursed ? 1 : 2) : *wdl == tb::Wdl::LOSS ? (cursed ? -1 : -2) : 0;
+    values[0][stm][f][index_of(l, enc[0][stm][f], p)] = w + 2;
+    // dtz in plies, cursed results in moves past the 100
+    if (stm == 0 && w != 0) values[1][0][f][index_of(l, enc[1][0][f], p)] = cursed ? (plies - 101) / 2 : plies - 1;
+  }
+
+  std::filesystem::create_directories(dir);
+  std::vector<std::string> paths;
+  for (int dtz = 0; dtz < 2; ++dtz) {
+    int sides = !dtz && !l.symmetric ? 2 : 1;
+    std::vector<uint8_t> out;
+    const auto& magic = dtz ? DTZ_MAGIC : WDL_MAGIC;
+    out.assign(magic.begin(), magic.end());
+    out.push_back(static_cast<uint8_t>((l.symmetric ? 0 : FILE_SPLIT) | (l.has_pawns ? FILE_HAS_PAWNS : 0)));
+    for (int f = 0; f < files; ++f) {
+      out.push_back(static_cast<uint8_t>(order[0] | order[0] << 4));
+      if (both_pawns) out.push_back(static_cast<uint8_t>(order[1] | order[1] << 4));
+      for (size_t k = 0; k < l.size; ++k) out.push_back(static_cast<uint8_t>(pieces[k] | pieces[k] << 4));
+    }
+    align(out, 2);
+
+    std::array<std::array<Compressed, 2>, 4> tables;
+    uint8_t flags = dtz ? FLAG_WIN_PLIES | FLAG_LOSS_PLIES : 0;
+    for (int f = 0; f < files; ++f) {
+      for (int s = 0; s < sides; ++s) {
+        fill(values[dtz][s][f]);
+        tables[f][s] = compress(values[dtz][s][f], flags);
+        append(out, tables[f][s].sizes);
+      }
+    }
+    if (dtz) align(out, 2);
+    for (int f = 0; f < files; ++f) {
+      for (int s = 0; s < sides; ++s) append(out, tables[f][s].sparse);
+    }
+    for (int f = 0; f < files; ++f) {
+      for (int s = 0; s < sides; ++s) append(out, tables[f][s].block_lengths);
+    }
+    for (int f = 0; f < files; ++f) {
+      for (int s = 0; s < sides; ++s) {
+        align(out, 64);
+        append(out, tables[f][s].blocks);
+      }
+    }
+    // the reader looks a few bytes past the block it decodes
+    out.resize(out.size() + 64, 0);
+
+    std::string path =
+        (std::filesystem::path{dir} / (name + std::string{dtz ? DTZ_EXTENSION : WDL_EXTENSION})).string();
+    std::ofstream ofs{path, std::ios::binary};
+    if (!ofs) throw std::runtime_error("cannot write " + path);
+    ofs.write(reinterpret_cast<const char*>(out.data()), static_cast<std::streamsize>(out.size()));
+    paths.push_back(path);
+  }
+  return paths;
+}
+
+}  // namespace dwc::tools
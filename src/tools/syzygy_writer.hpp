@@ -0,0 +1,18 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "src/tools/egtb_gen.hpp"
+
+namespace dwc::tools {
+
+// A generated table as Syzygy "<name>.rtbw" and "<name>.rtbz" in dir, named the Syzygy way (e.g. "KBvKN"), returns
+// the paths. Values are stored as they are, without the "don't care" entries of real generators, and coded with
+// plain Huffman codes (no symbol pairs), so files are bigger but read the same.
+// The dtz is the generator's distance: plies to mate or to the next capture, which is the next zeroing move for
+// pawnless material. Wins and losses beyond 100 plies become cursed wins and blessed losses, the 50 move rule isn't
+// followed through captures. Throws std::invalid_argument for KvK, Syzygy has no file for it.
+std::vector<std::string> write_syzygy(const EgtbGenerator::Table& table, const std::string& dir);
+
+}  // namespace dwc::tools
@@ -0,0 +1,127 @@
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <map>
+#include <random>
+#include <thread>
+
+#include "src/framework/board.hpp"
+#include "src/shared/test/temp_dir.hpp"
+#include "src/tools/dedup.hpp"
+
+using namespace dwc;
+using namespace dwc::tools;
+
+namespace {
+namespace fs = std::filesystem;
+
+struct Expected {
+  uint32_t count{0};
+  uint32_t first_game{UINT32_MAX};
+};
+
+std::vector<PositionSet::Entry> drain(PositionSet& set) {
+  std::vector<PositionSet::Entry> res;
+  set.drain([&res](const PositionSet::Entry& e) { res.push_back(e); });
+  return res;
+}
+
+void expect_equal(const std::vector<PositionSet::Entry>& got, const std::map<uint64_t, Expected>& expected) {
+  ASSERT_EQ(got.size(), expected.size());
+  auto it = expected.begin();
+  for (const auto& e : got) {
+    EXPECT_EQ(e.key, it->first);
+    EXPECT_EQ(e.count, it->second.count);
+    EXPECT_EQ(e.first_game, it->second.first_game);
+    ++it;
+  }
+}
+
+using DedupTest = test::TempDirTest;
+}  // namespace
+
+TEST_F(DedupTest, Set) {
+  PositionSet set{1 << 20, dir_.string()};
+  set.insert(0x8000000000000001ULL, 3);
+  set.insert(0x8000000000000001ULL, 1);
+  set.insert(0, 7);
+  set.insert(42, 2);
+  set.insert(0x8000000000000001ULL, 2);
+
+  expect_equal(drain(set), {{0, {1, 7}}, {42, {1, 2}}, {0x8000000000000001ULL, {3, 1}}});
+  EXPECT_EQ(set.spilled(), 0);
+  EXPECT_TRUE(drain(set).empty());
+}
+
+TEST_F(DedupTest, Spill) {
+  // a budget below the minimum, every shard spills at MIN_SLOTS * 3 / 4 entries
+  PositionSet set{0, dir_.string(), 2};
+  std::map<uint64_t, Expected> expected;
+  std::mt19937_64 rng{7};
+  std::vector<uint64_t> keys(3000);
+  for (auto& k : keys) k = rng();
+  for (uint32_t game = 0; game < 10000; ++game) {
+    uint64_t key = keys[rng() % keys.size()];
+    set.insert(key, game);
+    ++expected[key].count;
+    expected[key].first_game = std::min(expected[key].first_game, game);
+  }
+  EXPECT_GT(set.spilled(), 0);
+  expect_equal(drain(set), expected);
+  EXPECT_TRUE(fs::is_empty(dir_));
+}
+
+TEST_F(DedupTest, Concurrent) {
+  PositionSet set{4096, dir_.string(), 4};
+  constexpr uint32_t PER_THREAD = 20000;
+  std::vector<std::thread> threads;
+  for (uint32_t t = 0; t < 4; ++t) {
+    // all threads insert the same keys, with different game ids
+    threads.emplace_back([&set, t] {
+      std::mt19937_64 rng{1};
+      for (uint32_t i = 0; i < PER_THREAD; ++i) set.insert(rng() % 5000 * 0x9e3779b97f4a7c15ULL, t * PER_THREAD + i);
+    });
+  }
+  for (auto& t : threads) t.join();
+
+  std::map<uint64_t, Expected> expected;
+  std::mt19937_64 rng{1};
+  for (uint32_t i = 0; i < PER_THREAD; ++i) {
+    auto& e = expected[rng() % 5000 * 0x9e3779b97f4a7c15ULL];
+    e.count += 4;
+    e.first_game = std::min(e.first_game, i);
+  }
+  expect_equal(drain(set), expected);
+}
+
+TEST_F(DedupTest, Games) {
+  // both games reach the same position after 3 plies, the third game fails on its second move
+  constexpr std::string_view PGN = R"([Event "A"]
+
+1. e4 e5 2. Nf3 *
+
+[Event "B"]
+
+1. Nf3 e5 2. e4 Nc6 *
+
+[Event "C"]
+
+1. d4 Ke7 *
+)";
+  Board transposed{"rnbqkbnr/pppp1ppp/8/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R b KQkq"};
+  Board start{"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq"};
+
+  PositionSet set{1 << 20, dir_.string()};
+  auto st = dedup_games(PGN, 2, set, 10);
+  EXPECT_EQ(st.games, 3);
+  EXPECT_EQ(st.failed, 1);
+  EXPECT_EQ(st.positions, 4 + 5 + 2);
+
+  std::map<uint64_t, PositionSet::Entry> entries;
+  set.drain([&entries](const PositionSet::Entry& e) { entries[e.key] = e; });
+  EXPECT_EQ(entries.size(), 8);
+  EXPECT_EQ(entries[start.get_key()].count, 3);
+  EXPECT_EQ(entries[start.get_key()].first_game, 10);
+  EXPECT_EQ(entries[transposed.get_key()].count, 2);
+  EXPECT_EQ(entries[transposed.get_key()].first_game, 10);
+}
@@ -0,0 +1,80 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include "src/shared/test/temp_dir.hpp"
+#include "src/tablebase/tablebase.hpp"
+#include "src/tools/egtb_gen.hpp"
+
+using namespace dwc;
+using namespace dwc::tools;
+
+namespace {
+// longest win with the side to move winning, in plies
+size_t longest_win(const EgtbGenerator::Table& t) {
+  size_t res = 0;
+  for (size_t idx = 0; idx < t.distance.size(); ++idx) {
+    if (t.wdl_at(idx) == tb::Wdl::WIN) res = std::max<size_t>(res, t.distance[idx]);
+  }
+  return res;
+}
+
+using EgtbGenTest = test::TempDirTest;
+}  // namespace
+
+TEST(EGTB_GEN, KvK) {
+  EgtbGenerator gen{2};
+  const auto& t = gen.generate("KvK");
+  size_t legal = 0;
+  for (size_t idx = 0; idx < t.distance.size(); ++idx) {
+    auto wdl = t.wdl_at(idx);
+    if (!wdl.has_value()) continue;
+    ++legal;
+    EXPECT_EQ(wdl, tb::Wdl::DRAW);
+  }
+  // 64 * 63 placements minus the 420 with touching kings, both sides to move
+  EXPECT_EQ(legal, 2 * (64 * 63 - 420));
+}
+
+TEST_F(EgtbGenTest, KQvK) {
+  EgtbGenerator gen;
+  const auto& t = gen.generate("KQvK");
+  EXPECT_NE(gen.find("KvK"), nullptr);
+  // mate in 10 at most
+  EXPECT_EQ(longest_win(t), 19);
+
+  EXPECT_EQ(gen.write(dir_.string()).size(), 2);
+  tb::Tablebase tbs{dir_.string()};
+
+  Board mate_in_one{"7k/8/6K1/8/8/8/8/1Q6 w"};
+  EXPECT_EQ(tbs.probe_wdl(mate_in_one), tb::Wdl::WIN);
+  EXPECT_EQ(tbs.probe_dtz(mate_in_one), 1);
+
+  Board mated{"Q6k/8/6K1/8/8/8/8/8 b"};
+  EXPECT_EQ(tbs.probe_wdl(mated), tb::Wdl::LOSS);
+  EXPECT_EQ(tbs.probe_dtz(mated), 0);
+
+  Board stalemate{"7k/5Q2/6K1/8/8/8/8/8 b"};
+  EXPECT_EQ(tbs.probe_wdl(stalemate), tb::Wdl::DRAW);
+
+  // the king takes the hanging queen, either color
+  Board capture{"7K/8/8/8/8/8/1Q6/k7 b"};
+  EXPECT_EQ(tbs.probe_wdl(capture), tb::Wdl::DRAW);
+  Board flipped{"7k/8/8/8/8/8/1q6/K7 w"};
+  EXPECT_EQ(tbs.probe_wdl(flipped), tb::Wdl::DRAW);
+  // protected queen
+  Board protected_queen{"8/8/8/8/8/8/1Q6/k1K5 b"};
+  EXPECT_EQ(tbs.probe_wdl(protected_queen), tb::Wdl::LOSS);
+}
+
+TEST(EGTB_GEN, KRvK) {
+  EgtbGenerator gen;
+  // mate in 16 at most
+  EXPECT_EQ(longest_win(gen.generate("KRvK")), 31);
+}
+
+TEST(EGTB_GEN, Invalid) {
+  EgtbGenerator gen{1};
+  EXPECT_THROW(gen.generate("KvKQ"), std::invalid_argument);
+  EXPECT_THROW(gen.generate("KPvK"), std::invalid_argument);
+  EXPECT_EQ(gen.find("KPvK"), nullptr);
+}
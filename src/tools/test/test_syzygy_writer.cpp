@@ -0,0 +1,97 @@
+#include <gtest/gtest.h>
+
+#include <filesystem>
+
+#include "src/shared/test/temp_dir.hpp"
+#include "src/tablebase/syzygy.hpp"
+#include "src/tools/egtb_gen.hpp"
+#include "src/tools/syzygy_writer.hpp"
+
+using namespace dwc;
+using namespace dwc::tools;
+
+namespace {
+namespace fs = std::filesystem;
+
+// a position of the generated table, or the same with colors swapped
+Board board_of(const tb::Material& m, size_t idx, bool swapped) {
+  tb::Placement p = tb::placement_of(m, idx);
+  auto other = [swapped](Side side) { return swapped == (side == Side::WHITE) ? Side::BLACK : Side::WHITE; };
+  State state;
+  state.castling.clear();
+  state.turn = other(p.turn);
+  for (size_t i = 0; i < m.size; ++i) {
+    uint8_t sq = swapped ? p.squares[i] ^ 56 : p.squares[i];
+    board_ut::set(Pos::from_index(sq), {m.pieces[i].type, other(m.pieces[i].side)}, state.board);
+  }
+  return Board{state};
+}
+
+// the Syzygy files give back what was generated, dtz being the generator's distance (mated is -1 in Syzygy)
+void expect_same(const EgtbGenerator::Table& t, const tb::Syzygy& tbs, size_t stride) {
+  size_t checked = 0;
+  for (size_t idx = 0; idx < tb::table_size(t.sig.material); idx += stride) {
+    auto wdl = t.wdl_at(idx);
+    if (!wdl.has_value()) continue;
+    int dtz = *wdl == tb::Wdl::WIN ? t.distance[idx] : *wdl == tb::Wdl::LOSS ? -std::max<int>(t.distance[idx], 1) : 0;
+    for (bool swapped : {false, true}) {
+      Board b = board_of(t.sig.material, idx, swapped);
+      ASSERT_EQ(tbs.probe_wdl(b), wdl) << t.sig.name << " " << idx;
+      ASSERT_EQ(tbs.probe_dtz(b), dtz) << t.sig.name << " " << idx;
+    }
+    ++checked;
+  }
+  EXPECT_GT(checked, 1000);
+}
+
+using SyzygyWriterTest = test::TempDirTest;
+}  // namespace
+
+TEST_F(SyzygyWriterTest, KQvK) {
+  EgtbGenerator gen;
+  const auto& t = gen.generate("KQvK");
+  auto paths = write_syzygy(t, dir_.string());
+  ASSERT_EQ(paths.size(), 2);
+  EXPECT_EQ(fs::path{paths[0]}.filename(), "KQvK.rtbw");
+  EXPECT_EQ(fs::path{paths[1]}.filename(), "KQvK.rtbz");
+
+  tb::Syzygy tbs{dir_.string()};
+  EXPECT_EQ(tbs.size(), 1);
+  EXPECT_EQ(tbs.max_pieces(), 3);
+  expect_same(t, tbs, 11);
+
+  EXPECT_EQ(tbs.probe_dtz(Board{"7k/8/6K1/8/8/8/8/1Q6 w"}), 1);
+  EXPECT_EQ(tbs.probe_dtz(Board{"Q6k/8/6K1/8/8/8/8/8 b"}), -1);
+  EXPECT_EQ(tbs.probe_wdl(Board{"7k/5Q2/6K1/8/8/8/8/8 b"}), tb::Wdl::DRAW);
+  // the king takes the hanging queen
+  EXPECT_EQ(tbs.probe_wdl(Board{"7K/8/8/8/8/8/1Q6/k7 b"}), tb::Wdl::DRAW);
+}
+
+TEST_F(SyzygyWriterTest, KRvK) {
+  EgtbGenerator gen;
+  const auto& t = gen.generate("KRvK");
+  write_syzygy(t, dir_.string());
+  expect_same(t, tb::Syzygy{dir_.string()}, 11);
+
+  // wdl still probes without the dtz file
+  fs::remove(dir_ / "KRvK.rtbz");
+  tb::Syzygy wdl_only{dir_.string()};
+  Board win{"7k/8/6K1/8/8/8/8/R7 w"};
+  EXPECT_EQ(wdl_only.probe_wdl(win), tb::Wdl::WIN);
+  EXPECT_EQ(wdl_only.probe_dtz(win), std::nullopt);
+}
+
+TEST_F(SyzygyWriterTest, KNvK) {
+  // all draws, stored as single values
+  EgtbGenerator gen;
+  const auto& t = gen.generate("KNvK");
+  auto paths = write_syzygy(t, dir_.string());
+  EXPECT_EQ(fs::path{paths[0]}.filename(), "KNvK.rtbw");
+  EXPECT_LT(fs::file_size(paths[0]), 256);
+  expect_same(t, tb::Syzygy{dir_.string()}, 7);
+}
+
+TEST(SYZYGY_WRITER, KvK) {
+  EgtbGenerator gen{1};
+  EXPECT_THROW(write_syzygy(gen.generate("KvK"), "unused"), std::invalid_argument);
+}